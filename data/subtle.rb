@@ -47,6 +47,22 @@ set :skip_pointer_warp, false
 # Skip pointer movement to urgent windows
 set :skip_urgent_warp, false
 
+# Just flush requests instead of waiting for the X server after changes
+set :async_requests, false
+
+# Move and resize windows live instead of drawing a frame
+set :opaque_drag, false
+
+# Run sublet intervals in a separate process to keep slow sublets from
+# blocking subtle
+set :sublet_host, false
+
+# Composite cached view buttons, separators and icons with Xrender
+set :panel_xrender, false
+
+# Limit panel redraws per second, 0 redraws after every batch of events
+# set :panel_fps, 30
+
 # Set the WM_NAME of subtle (Java quirk)
 # set :wmname, "LG3D"
 
@@ -745,7 +761,7 @@ view "dev",   "editor"
 #
 # There are three default properties, that can be be changed for every sublet:
 #
-# [*interval*]    Update interval of the sublet
+# [*interval*]    Update interval of the sublet in seconds (fractions allowed)
 # [*foreground*]  Default foreground color
 # [*background*]  Default background color
 #
@@ -72,6 +72,7 @@ module Subtle # {{{
           [ '--reload',  '-r', GetoptLong::NO_ARGUMENT       ],
           [ '--restart', '-R', GetoptLong::NO_ARGUMENT       ],
           [ '--quit',    '-q', GetoptLong::NO_ARGUMENT       ],
+          [ '--stats',   '-P', GetoptLong::NO_ARGUMENT       ],
           [ '--current', '-C', GetoptLong::NO_ARGUMENT       ],
           [ '--select',  '-X', GetoptLong::NO_ARGUMENT       ],
           [ '--proc',    '-p', GetoptLong::REQUIRED_ARGUMENT ],
@@ -127,6 +128,7 @@ module Subtle # {{{
             when '--reload'  then @mod = :reload
             when '--restart' then @mod = :restart
             when '--quit'    then @mod = :quit
+            when '--stats'   then @mod = :stats
             when '--current' then @mod = :current
             when '--select'  then @mod = :select
 
@@ -180,6 +182,7 @@ module Subtle # {{{
           when :reload  then  Subtlext::Subtle.reload
           when :restart then  Subtlext::Subtle.restart
           when :quit    then  Subtlext::Subtle.quit
+          when :stats   then  stats(arg1)
           when :current
             arg2 = arg1
             arg1 = :current
@@ -239,7 +242,7 @@ module Subtle # {{{
                   handle_result(obj.send(@action))
                 end
             end
-          elsif :reload != @mod and :restart != @mod and :quit != @mod
+          elsif not [ :reload, :restart, :quit, :stats ].include?(@mod)
             usage(@group)
             exit
           end
@@ -249,6 +252,29 @@ module Subtle # {{{
         end
       end # }}}
 
+      def stats(key) # {{{
+        list = Subtlext::Subtle.stats(key.nil? ? nil : key.to_sym)
+
+        unless @proc.nil?
+          list.each { |s| @proc.call(s) }
+        else
+          puts '%-6s %-20.20s %8s %12s %10s %10s' % [
+            'TYPE', 'NAME', 'CALLS', 'TOTAL(ms)', 'MAX(ms)', 'OBJECTS'
+          ]
+
+          list.each do |s|
+            puts '%-6s %-20.20s %8d %12.2f %10.2f %10d' % [
+              s[:type],
+              s[:name],
+              s[:calls],
+              s[:total] / 1000.0,
+              s[:max] / 1000.0,
+              s[:objects]
+            ]
+          end
+        end
+      end # }}}
+
       def call_or_print(value) # {{{
         unless @proc.nil?
           @proc.call(value)
@@ -341,6 +367,8 @@ module Subtle # {{{
     -r, --reload           Reload config and sublets
     -R, --restart          Restart subtle
     -q, --quit             Quit subtle
+    -P, --stats [KEY]      Show call stats of sublets and hooks sorted
+                           by total, calls, max, objects or name
     -C, --current          Select current active window/view
                            instead of passing it via argument
     -X, --select           Select a window via pointer instead
@@ -14,7 +14,581 @@
 #include <signal.h>
 #include <unistd.h>
 #include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include "shared.h"
+#include <X11/Xlibint.h>
+
+#define PREFETCH_PENDING 0                                        ///< Reply outstanding
+#define PREFETCH_READY   1                                        ///< Reply stored
+#define PREFETCH_FAILED  2                                        ///< Request failed
+#define PREFETCH_USED    3                                        ///< Reply consumed
+
+#define EXTENTS          256                                      ///< Cached text extents
+#define EXTENTBUCKETS    (EXTENTS * 2)                            ///< Extent hash buckets
+
+#define COLORS           64                                       ///< Cached colors
+
+#define ATOMBUCKETS      256                                      ///< Atom hash buckets
+#define ATOMCACHE        256                                      ///< Max cached dynamic atoms
+
+/* Typedef {{{ */
+typedef struct sharedprefetch_t
+{
+  int           state, format;                                    ///< Prefetch state, format
+  Window        win;                                              ///< Prefetch window
+  Atom          prop, type;                                       ///< Prefetch property, type
+  unsigned long nitems;                                           ///< Prefetch items
+  unsigned char *data;                                            ///< Prefetch data
+} SharedPrefetch;
+
+typedef struct sharedattributes_t
+{
+  unsigned long     seq;                                          ///< Attributes first serial
+  int               n;                                            ///< Attributes windows
+  XWindowAttributes *attrs;                                       ///< Attributes list
+} SharedAttributes;
+
+typedef struct sharedextent_t
+{
+  SubFont      *f;                                                ///< Extent font
+  char         *text;                                             ///< Extent text
+  int          len, width, lbearing;                              ///< Extent length, width, left bearing
+  unsigned int hash;                                              ///< Extent hash
+  int          prev, next, chain;                                 ///< Extent LRU and bucket links (index + 1)
+} SharedExtent;
+
+typedef struct sharedcolor_t
+{
+  int           pinned;                                           ///< Color pinned
+  unsigned long used;                                             ///< Color last use
+  XColor        xcolor;                                           ///< Color values
+} SharedColor;
+
+typedef struct sharedatom_t
+{
+  Atom                atom;                                       ///< Atom value
+  char                *name;                                      ///< Atom name
+  int                 id, owned;                                  ///< Atom id, name allocated
+  struct sharedatom_t *next;                                      ///< Atom name bucket link
+} SharedAtom;
+/* }}} */
+
+/* Globals */
+static SharedPrefetch *prefetch = NULL;
+static int nprefetch = 0, prefetchpos = 0, prefetching = False;
+static unsigned long prefetchseq = 0;
+static _XAsyncHandler prefetchasync;
+
+static SharedExtent extentcache[EXTENTS];
+static int extentbuckets[EXTENTBUCKETS] = { 0 };
+static int nextents = 0, extenthead = 0, extenttail = 0;
+static unsigned long extenthits = 0, extentmisses = 0;
+
+static SharedColor colors[COLORS];
+static int ncolors = 0;
+static unsigned long colorclock = 0;
+
+static char *atomnames[] =
+{
+  /* ICCCM */
+  "WM_NAME", "WM_CLASS", "WM_STATE", "WM_PROTOCOLS", "WM_TAKE_FOCUS",
+  "WM_DELETE_WINDOW", "WM_NORMAL_HINTS", "WM_SIZE_HINTS", "WM_HINTS",
+  "WM_WINDOW_ROLE", "WM_CLIENT_LEADER",
+
+  /* EWMH */
+  "_NET_SUPPORTED", "_NET_CLIENT_LIST", "_NET_CLIENT_LIST_STACKING",
+  "_NET_NUMBER_OF_DESKTOPS", "_NET_DESKTOP_NAMES", "_NET_DESKTOP_GEOMETRY",
+  "_NET_DESKTOP_VIEWPORT", "_NET_CURRENT_DESKTOP", "_NET_ACTIVE_WINDOW",
+  "_NET_WORKAREA", "_NET_SUPPORTING_WM_CHECK", "_NET_WM_FULL_PLACEMENT",
+  "_NET_FRAME_EXTENTS",
+
+  /* Client */
+  "_NET_CLOSE_WINDOW", "_NET_RESTACK_WINDOW", "_NET_MOVERESIZE_WINDOW",
+  "_NET_WM_NAME", "_NET_WM_PID", "_NET_WM_DESKTOP", "_NET_WM_STRUT",
+
+  /* Types */
+  "_NET_WM_WINDOW_TYPE", "_NET_WM_WINDOW_TYPE_DOCK",
+  "_NET_WM_WINDOW_TYPE_DESKTOP", "_NET_WM_WINDOW_TYPE_TOOLBAR",
+  "_NET_WM_WINDOW_TYPE_SPLASH", "_NET_WM_WINDOW_TYPE_DIALOG",
+
+  /* States */
+  "_NET_WM_STATE", "_NET_WM_STATE_FULLSCREEN", "_NET_WM_STATE_ABOVE",
+  "_NET_WM_STATE_STICKY", "_NET_WM_STATE_DEMANDS_ATTENTION",
+
+  /* Tray */
+  "_NET_SYSTEM_TRAY_OPCODE", "_NET_SYSTEM_TRAY_MESSAGE_DATA",
+  "_NET_SYSTEM_TRAY_S",
+
+  /* Misc */
+  "UTF8_STRING", "MANAGER", "_MOTIF_WM_HINTS",
+
+  /* XEmbed */
+  "_XEMBED", "_XEMBED_INFO",
+
+  /* subtle */
+  "SUBTLE_CLIENT_TAGS", "SUBTLE_CLIENT_RETAG",
+  "SUBTLE_CLIENT_GRAVITY", "SUBTLE_CLIENT_SCREEN", "SUBTLE_CLIENT_FLAGS",
+  "SUBTLE_CLIENT_NEIGHBOURS",
+  "SUBTLE_GRAVITY_NEW", "SUBTLE_GRAVITY_FLAGS", "SUBTLE_GRAVITY_LIST",
+  "SUBTLE_GRAVITY_KILL",
+  "SUBTLE_TAG_NEW", "SUBTLE_TAG_LIST", "SUBTLE_TAG_KILL", "SUBTLE_TRAY_LIST",
+  "SUBTLE_VIEW_NEW", "SUBTLE_VIEW_TAGS", "SUBTLE_VIEW_STYLE",
+  "SUBTLE_VIEW_ICONS", "SUBTLE_VIEW_KILL",
+  "SUBTLE_SUBLET_UPDATE", "SUBTLE_SUBLET_DATA", "SUBTLE_SUBLET_STYLE",
+  "SUBTLE_SUBLET_FLAGS", "SUBTLE_SUBLET_LIST", "SUBTLE_SUBLET_KILL",
+  "SUBTLE_SCREEN_PANELS", "SUBTLE_SCREEN_VIEWS", "SUBTLE_SCREEN_JUMP",
+  "SUBTLE_VISIBLE_TAGS", "SUBTLE_VISIBLE_VIEWS",
+  "SUBTLE_RENDER", "SUBTLE_RELOAD", "SUBTLE_RESTART", "SUBTLE_QUIT",
+  "SUBTLE_COLORS", "SUBTLE_FONT", "SUBTLE_DATA", "SUBTLE_VERSION",
+  "SUBTLE_STATS", "SUBTLE_TAGS"
+};
+
+static Atom atoms[SUB_EWMH_TOTAL] = { None };
+static int atomids[ATOMBUCKETS] = { 0 }, natoms = 0;
+static SharedAtom *atomchains[ATOMBUCKETS] = { NULL };
+
+/* SharedColorFind {{{ */
+static SharedColor *
+SharedColorFind(unsigned long pixel)
+{
+  int i;
+
+  for(i = 0; i < ncolors; i++)
+    if(colors[i].xcolor.pixel == pixel) return &colors[i];
+
+  return NULL;
+} /* }}} */
+
+/* SharedColorStore {{{ */
+static SharedColor *
+SharedColorStore(XColor *xcolor)
+{
+  int i;
+  SharedColor *c = NULL;
+
+  /* Update known, take free or replace least recently used color */
+  if(!(c = SharedColorFind(xcolor->pixel)))
+    {
+      if(COLORS > ncolors) c = &colors[ncolors++];
+      else
+        {
+          for(i = 0; i < ncolors; i++)
+            if(!colors[i].pinned && (!c || colors[i].used < c->used))
+              c = &colors[i];
+
+          if(!c) return NULL; ///< All pinned
+        }
+
+      c->pinned = False;
+    }
+
+  c->xcolor = *xcolor;
+  c->used   = ++colorclock;
+
+  return c;
+} /* }}} */
+
+/* SharedExtentUnlink {{{ */
+static void
+SharedExtentUnlink(int idx)
+{
+  SharedExtent *e = &extentcache[idx];
+
+  /* Remove from LRU list */
+  if(e->prev) extentcache[e->prev - 1].next = e->next;
+  else extenthead = e->next;
+
+  if(e->next) extentcache[e->next - 1].prev = e->prev;
+  else extenttail = e->prev;
+
+  e->prev = e->next = 0;
+} /* }}} */
+
+/* SharedExtentLink {{{ */
+static void
+SharedExtentLink(int idx,
+  int head)
+{
+  SharedExtent *e = &extentcache[idx];
+
+  /* Insert at head for recent or at tail for free entries */
+  if(head)
+    {
+      e->next = extenthead;
+      if(extenthead) extentcache[extenthead - 1].prev = idx + 1;
+      extenthead = idx + 1;
+      if(!extenttail) extenttail = idx + 1;
+    }
+  else
+    {
+      e->prev = extenttail;
+      if(extenttail) extentcache[extenttail - 1].next = idx + 1;
+      extenttail = idx + 1;
+      if(!extenthead) extenthead = idx + 1;
+    }
+} /* }}} */
+
+/* SharedExtentDrop {{{ */
+static void
+SharedExtentDrop(int idx)
+{
+  int *link = NULL;
+  SharedExtent *e = &extentcache[idx];
+
+  if(!e->f) return;
+
+  /* Remove from bucket chain */
+  for(link = &extentbuckets[e->hash % EXTENTBUCKETS]; *link;
+      link = &extentcache[*link - 1].chain)
+    {
+      if(*link == idx + 1)
+        {
+          *link = e->chain;
+          break;
+        }
+    }
+
+  free(e->text);
+
+  e->f     = NULL;
+  e->text  = NULL;
+  e->chain = 0;
+} /* }}} */
+
+/* SharedExtentHash {{{ */
+static unsigned int
+SharedExtentHash(SubFont *f,
+  const char *text,
+  int len)
+{
+  int i;
+  unsigned int hash = 2166136261U ^ (unsigned int)((unsigned long)f >> 4);
+
+  /* FNV-1a */
+  for(i = 0; i < len; i++)
+    {
+      hash ^= (unsigned char)text[i];
+      hash *= 16777619U;
+    }
+
+  return hash;
+} /* }}} */
+
+/* SharedPrefetchHandler {{{ */
+static Bool
+SharedPrefetchHandler(Display *disp,
+  xReply *rep,
+  char *buf,
+  int len,
+  XPointer data)
+{
+  unsigned long idx = disp->last_request_read - prefetchseq;
+  xGetPropertyReply replbuf, *repl = NULL;
+  SharedPrefetch *p = NULL;
+
+  /* Check whether this reply belongs to us */
+  if(disp->last_request_read < prefetchseq || idx >= (unsigned long)nprefetch)
+    return False;
+
+  p = &prefetch[idx];
+
+  /* Dequeue handler after last reply */
+  if(idx == (unsigned long)nprefetch - 1)
+    {
+      DeqAsyncHandler(disp, &prefetchasync);
+      prefetching = False;
+    }
+
+  /* Leave errors to the error handler */
+  if(X_Error == rep->generic.type)
+    {
+      p->state = PREFETCH_FAILED;
+
+      return False;
+    }
+
+  repl = (xGetPropertyReply *)_XGetAsyncReply(disp, (char *)&replbuf,
+    rep, buf, len, 0, False);
+
+  p->type   = repl->propertyType;
+  p->format = repl->format;
+  p->nitems = repl->nItems;
+  p->state  = PREFETCH_READY;
+
+  /* Copy data like XGetWindowProperty does */
+  if(None != p->type && 0 < p->nitems &&
+      (8 == p->format || 16 == p->format || 32 == p->format))
+    {
+      int nbytes = p->nitems * (p->format >> 3);
+
+      if(32 == p->format)
+        {
+          unsigned long i;
+          CARD32 *raw = (CARD32 *)Xmalloc(nbytes);
+          long *l = NULL;
+
+          _XGetAsyncData(disp, (char *)raw, buf, len,
+            SIZEOF(xGetPropertyReply), nbytes, repl->length << 2);
+
+          /* Expand to longs */
+          p->data = (unsigned char *)Xmalloc(p->nitems * sizeof(long) + 1);
+          l       = (long *)p->data;
+
+          for(i = 0; i < p->nitems; i++)
+            l[i] = raw[i];
+
+          Xfree(raw);
+        }
+      else if(16 == p->format)
+        {
+          unsigned long i;
+          CARD16 *raw = (CARD16 *)Xmalloc(nbytes);
+          short *s = NULL;
+
+          _XGetAsyncData(disp, (char *)raw, buf, len,
+            SIZEOF(xGetPropertyReply), nbytes, repl->length << 2);
+
+          /* Expand to shorts */
+          p->data = (unsigned char *)Xmalloc(p->nitems * sizeof(short) + 1);
+          s       = (short *)p->data;
+
+          for(i = 0; i < p->nitems; i++)
+            s[i] = raw[i];
+
+          Xfree(raw);
+        }
+      else
+        {
+          p->data = (unsigned char *)Xmalloc(nbytes + 1);
+
+          _XGetAsyncData(disp, (char *)p->data, buf, len,
+            SIZEOF(xGetPropertyReply), nbytes, repl->length << 2);
+
+          p->data[nbytes] = '\0';
+        }
+    }
+  else
+    {
+      p->nitems = 0;
+
+      _XGetAsyncData(disp, NULL, buf, len, SIZEOF(xGetPropertyReply),
+        0, repl->length << 2);
+    }
+
+  return True;
+} /* }}} */
+
+/* SharedAttributesHandler {{{ */
+static Bool
+SharedAttributesHandler(Display *disp,
+  xReply *rep,
+  char *buf,
+  int len,
+  XPointer data)
+{
+  SharedAttributes *a = (SharedAttributes *)data;
+  unsigned long idx = disp->last_request_read - a->seq;
+  XWindowAttributes *attrs = NULL;
+
+  /* Check whether this reply belongs to us */
+  if(disp->last_request_read < a->seq || idx >= (unsigned long)a->n * 2)
+    return False;
+
+  attrs = &a->attrs[idx >> 1];
+
+  /* Mark window as gone */
+  if(X_Error == rep->generic.type)
+    {
+      attrs->map_state = IsUnmapped;
+
+      return False;
+    }
+
+  /* Attributes and geometry replies alternate per window */
+  if(0 == idx % 2)
+    {
+      xGetWindowAttributesReply replbuf, *repl = NULL;
+
+      repl = (xGetWindowAttributesReply *)_XGetAsyncReply(disp,
+        (char *)&replbuf, rep, buf, len, (SIZEOF(xGetWindowAttributesReply) -
+        SIZEOF(xReply)) >> 2, True);
+
+      attrs->class                 = repl->class;
+      attrs->bit_gravity           = repl->bitGravity;
+      attrs->win_gravity           = repl->winGravity;
+      attrs->backing_store         = repl->backingStore;
+      attrs->backing_planes        = repl->backingBitPlanes;
+      attrs->backing_pixel         = repl->backingPixel;
+      attrs->save_under            = repl->saveUnder;
+      attrs->colormap              = repl->colormap;
+      attrs->map_installed         = repl->mapInstalled;
+      attrs->map_state             = repl->mapState;
+      attrs->all_event_masks       = repl->allEventMasks;
+      attrs->your_event_mask       = repl->yourEventMask;
+      attrs->do_not_propagate_mask = repl->doNotPropagateMask;
+      attrs->override_redirect     = repl->override;
+      attrs->visual                = _XVIDtoVisual(disp, repl->visualID);
+    }
+  else
+    {
+      int i;
+      xGetGeometryReply replbuf, *repl = NULL;
+
+      repl = (xGetGeometryReply *)_XGetAsyncReply(disp, (char *)&replbuf,
+        rep, buf, len, 0, True);
+
+      attrs->root         = repl->root;
+      attrs->x            = cvtINT16toInt(repl->x);
+      attrs->y            = cvtINT16toInt(repl->y);
+      attrs->width        = repl->width;
+      attrs->height       = repl->height;
+      attrs->border_width = repl->borderWidth;
+      attrs->depth        = repl->depth;
+
+      /* Find screen of root */
+      for(i = 0; i < ScreenCount(disp); i++)
+        if(RootWindow(disp, i) == attrs->root)
+          attrs->screen = ScreenOfDisplay(disp, i);
+    }
+
+  return True;
+} /* }}} */
+
+/* SharedPropertyFetch {{{ */
+static int
+SharedPropertyFetch(Display *disp,
+  Window win,
+  Atom prop,
+  Atom type,
+  Atom *rtype,
+  int *format,
+  unsigned long *nitems,
+  unsigned char **data)
+{
+  int i;
+  unsigned long bytes = 0;
+
+  /* Check prefetched replies first, starting after the last hit */
+  for(i = 0; i < nprefetch; i++)
+    {
+      SharedPrefetch *p = &prefetch[(prefetchpos + i) % nprefetch];
+
+      if(p->win == win && p->prop == prop && PREFETCH_USED != p->state)
+        {
+          prefetchpos = (prefetchpos + i + 1) % nprefetch;
+
+          /* Collect outstanding replies */
+          if(PREFETCH_PENDING == p->state) XSync(disp, False);
+
+          if(PREFETCH_READY != p->state)
+            {
+              p->state = PREFETCH_USED;
+
+              return BadWindow;
+            }
+
+          p->state = PREFETCH_USED;
+          *rtype   = p->type;
+          *format  = p->format;
+          *nitems  = p->nitems;
+          *data    = p->data;
+          p->data  = NULL;
+
+          /* Mimic type check of XGetWindowProperty */
+          if(AnyPropertyType != type && type != *rtype && *data)
+            {
+              XFree(*data);
+              *data   = NULL;
+              *nitems = 0;
+            }
+
+          return Success;
+        }
+    }
+
+  return XGetWindowProperty(disp, win, prop, 0L, 4096, False, type,
+    rtype, format, nitems, &bytes, data);
+} /* }}} */
+
+/* SharedPropertyText {{{ */
+static Status
+SharedPropertyText(Display *disp,
+  Window win,
+  XTextProperty *text,
+  Atom prop)
+{
+  Atom rtype = None;
+  int format = 0;
+  unsigned long nitems = 0;
+  unsigned char *data = NULL;
+
+  /* Like XGetTextProperty */
+  if(Success == SharedPropertyFetch(disp, win, prop, AnyPropertyType,
+      &rtype, &format, &nitems, &data) && None != rtype)
+    {
+      text->encoding = rtype;
+      text->format   = format;
+      text->nitems   = nitems;
+      text->value    = data;
+
+      return True;
+    }
+
+  if(data) XFree(data);
+
+  text->encoding = None;
+  text->format   = 0;
+  text->nitems   = 0;
+  text->value    = NULL;
+
+  return False;
+} /* }}} */
+
+/* SharedAtomHash {{{ */
+static unsigned int
+SharedAtomHash(const char *name)
+{
+  unsigned int hash = 2166136261U;
+
+  /* FNV-1a */
+  while('\0' != *name)
+    {
+      hash ^= (unsigned char)*name++;
+      hash *= 16777619U;
+    }
+
+  return hash % ATOMBUCKETS;
+} /* }}} */
+
+/* SharedAtomStore {{{ */
+static void
+SharedAtomStore(char *name,
+  Atom atom,
+  int id,
+  int owned)
+{
+  unsigned int bucket = SharedAtomHash(name);
+  SharedAtom *a = (SharedAtom *)subSharedMemoryAlloc(1, sizeof(SharedAtom));
+
+  a->atom  = atom;
+  a->id    = id;
+  a->owned = owned;
+  a->name  = owned ? strdup(name) : name;
+  a->next  = atomchains[bucket];
+
+  atomchains[bucket] = a;
+
+  /* Add reverse lookup with linear probing */
+  if(0 <= id)
+    {
+      unsigned int slot = (unsigned int)(atom * 2654435761UL) % ATOMBUCKETS;
+
+      while(0 != atomids[slot]) slot = (slot + 1) % ATOMBUCKETS;
+
+      atomids[slot] = id + 1;
+    }
+} /* }}} */
 
 /* Memory */
 
@@ -133,6 +707,144 @@ subSharedRegexKill(regex_t *preg)
   onig_free(preg);
 } /* }}} */
 
+/* Atom */
+
+ /** subSharedAtomInit {{{
+  * @brief Intern all known atoms in one request
+  * @param[in]  disp    Display
+  * @param[in]  screen  Screen number for tray selection
+  **/
+
+void
+subSharedAtomInit(Display *disp,
+  int screen)
+{
+  int i, len = 0;
+  char *selection = NULL, *names[SUB_EWMH_TOTAL];
+
+  assert(disp && SUB_EWMH_TOTAL == LENGTH(atomnames));
+
+  subSharedAtomKill();
+
+  /* Tray selection name depends on the screen */
+  len       = strlen(atomnames[SUB_EWMH_NET_SYSTEM_TRAY_SELECTION]) + 5; ///< For high screen counts
+  selection = (char *)subSharedMemoryAlloc(len, sizeof(char));
+
+  snprintf(selection, len, "%s%u",
+    atomnames[SUB_EWMH_NET_SYSTEM_TRAY_SELECTION], screen);
+
+  for(i = 0; i < SUB_EWMH_TOTAL; i++) names[i] = atomnames[i];
+  names[SUB_EWMH_NET_SYSTEM_TRAY_SELECTION] = selection;
+
+  /* Register atoms */
+  XInternAtoms(disp, names, SUB_EWMH_TOTAL, False, atoms);
+
+  for(i = 0; i < SUB_EWMH_TOTAL; i++)
+    SharedAtomStore(names[i], atoms[i], i,
+      SUB_EWMH_NET_SYSTEM_TRAY_SELECTION == i);
+
+  free(selection);
+} /* }}} */
+
+ /** subSharedAtomGet {{{
+  * @brief Get intern atom
+  * @param[in]  e  A #SubEwmh
+  * @return Returns the desired #Atom
+  **/
+
+Atom
+subSharedAtomGet(SubEwmh e)
+{
+  assert(0 <= e && e < SUB_EWMH_TOTAL);
+
+  return atoms[e];
+} /* }}} */
+
+ /** subSharedAtomFind {{{
+  * @brief Find id for intern atom
+  * @param[in]  atom  A #Atom
+  * @retval  >=0  Found index
+  * @retval  -1   Atom was not found
+  **/
+
+SubEwmh
+subSharedAtomFind(Atom atom)
+{
+  unsigned int slot = (unsigned int)(atom * 2654435761UL) % ATOMBUCKETS;
+
+  /* Probe until empty slot */
+  while(None != atom && 0 != atomids[slot])
+    {
+      if(atoms[atomids[slot] - 1] == atom) return atomids[slot] - 1;
+
+      slot = (slot + 1) % ATOMBUCKETS;
+    }
+
+  return -1;
+} /* }}} */
+
+ /** subSharedAtomIntern {{{
+  * @brief Get atom by name and cache unknown ones
+  * @param[in]  disp  Display
+  * @param[in]  name  Atom name
+  * @return Returns the #Atom
+  **/
+
+Atom
+subSharedAtomIntern(Display *disp,
+  char *name)
+{
+  Atom atom = None;
+  SharedAtom *a = NULL;
+
+  assert(disp && name);
+
+  /* Check known and cached atoms */
+  for(a = atomchains[SharedAtomHash(name)]; a; a = a->next)
+    if(0 == strcmp(a->name, name)) return a->atom;
+
+  /* Ask server and cache up to limit */
+  if(None != (atom = XInternAtom(disp, name, False)) && natoms < ATOMCACHE)
+    {
+      SharedAtomStore(name, atom, -1, True);
+      natoms++;
+    }
+
+  return atom;
+} /* }}} */
+
+ /** subSharedAtomKill {{{
+  * @brief Clear atom registry
+  **/
+
+void
+subSharedAtomKill(void)
+{
+  int i;
+
+  for(i = 0; i < ATOMBUCKETS; i++)
+    {
+      SharedAtom *a = atomchains[i], *next = NULL;
+
+      while(a)
+        {
+          next = a->next;
+
+          if(a->owned) free(a->name);
+          free(a);
+
+          a = next;
+        }
+
+      atomchains[i] = NULL;
+      atomids[i]    = 0;
+    }
+
+  for(i = 0; i < SUB_EWMH_TOTAL; i++) atoms[i] = None;
+
+  natoms = 0;
+} /* }}} */
+
 /* Property */
 
  /** subSharedPropertyGet {{{
@@ -153,15 +865,15 @@ subSharedPropertyGet(Display *disp,
   unsigned long *size)
 {
   int format = 0;
-  unsigned long nitems = 0, bytes = 0;
+  unsigned long nitems = 0;
   unsigned char *data = NULL;
   Atom rtype = None;
 
   assert(win);
 
   /* Get property */
-  if(Success != XGetWindowProperty(disp, win, prop, 0L, 4096,
-      False, type, &rtype, &format, &nitems, &bytes, &data))
+  if(Success != SharedPropertyFetch(disp, win, prop, type,
+      &rtype, &format, &nitems, &data))
     return NULL;
 
   /* Check result */
@@ -198,8 +910,8 @@ subSharedPropertyGetStrings(Display *disp,
   assert(win && nlist);
 
   /* Check UTF8 and XA_STRING */
-  if((XGetTextProperty(disp, win, &text, prop) ||
-      XGetTextProperty(disp, win, &text, XA_STRING)) && text.nitems)
+  if((SharedPropertyText(disp, win, &text, prop) ||
+      SharedPropertyText(disp, win, &text, XA_STRING)) && text.nitems)
     {
       XmbTextPropertyToTextList(disp, &text, &list, nlist);
 
@@ -254,10 +966,13 @@ subSharedPropertyName(Display *disp,
   XTextProperty text;
 
   /* Get text property */
-  XGetTextProperty(disp, win, &text, XInternAtom(disp, "_NET_WM_NAME", False));
+  SharedPropertyText(disp, win, &text,
+    subSharedAtomIntern(disp, "_NET_WM_NAME"));
   if(0 == text.nitems)
     {
-      XGetTextProperty(disp, win, &text, XA_WM_NAME);
+      if(text.value) XFree(text.value);
+
+      SharedPropertyText(disp, win, &text, XA_WM_NAME);
       if(0 == text.nitems)
         {
           *name = strdup(fallback);
@@ -348,29 +1063,400 @@ subSharedPropertyGeometry(Display *disp,
   *geometry = r;
 } /* }}} */
 
- /** subSharedPropertyDelete {{{
-  * @brief Deletes the property
-  * @param[in]  disp  Display
-  * @param[in]  win   A #Window
-  * @param[in]  prop  Property
+ /** subSharedPropertyPrefetch {{{
+  * @brief Pipeline property requests of windows and collect
+  *   the replies asynchronously for later #subSharedPropertyGet calls
+  * @param[in]  disp    Display
+  * @param[in]  wins    Window list
+  * @param[in]  nwins   Number of windows
+  * @param[in]  props   Property list
+  * @param[in]  nprops  Number of properties
   **/
 
 void
-subSharedPropertyDelete(Display *disp,
-  Window win,
-  Atom prop)
+subSharedPropertyPrefetch(Display *disp,
+  Window *wins,
+  int nwins,
+  Atom *props,
+  int nprops)
 {
-  assert(win);
+  int i, j, k = 0;
+  Display *dpy = disp; ///< Required by GetReq
 
-  XDeleteProperty(disp, win, prop);
-} /* }}} */
+  assert(wins && props);
 
-/* Draw */
+  subSharedPropertyRelease(disp);
 
- /** subSharedDrawString {{{
-  * @brief Draw text
-  * @param[in]  disp  Display
-  * @param[in]  gc    GC
+  if(0 >= nwins || 0 >= nprops) return;
+
+  nprefetch = nwins * nprops;
+  prefetch  = (SharedPrefetch *)subSharedMemoryAlloc(nprefetch,
+    sizeof(SharedPrefetch));
+
+  LockDisplay(dpy);
+
+  prefetchseq = dpy->request + 1;
+
+  /* Queue requests without waiting for replies */
+  for(i = 0; i < nwins; i++)
+    {
+      for(j = 0; j < nprops; j++, k++)
+        {
+          xGetPropertyReq *req = NULL;
+
+          GetReq(GetProperty, req);
+          req->window     = wins[i];
+          req->property   = props[j];
+          req->type       = AnyPropertyType;
+          req->delete     = False;
+          req->longOffset = 0;
+          req->longLength = 4096;
+
+          prefetch[k].win   = wins[i];
+          prefetch[k].prop  = props[j];
+          prefetch[k].state = PREFETCH_PENDING;
+        }
+    }
+
+  /* Install reply handler */
+  prefetchasync.next    = dpy->async_handlers;
+  prefetchasync.handler = SharedPrefetchHandler;
+  prefetchasync.data    = NULL;
+  dpy->async_handlers   = &prefetchasync;
+  prefetching           = True;
+
+  UnlockDisplay(dpy);
+
+  XFlush(disp);
+} /* }}} */
+
+ /** subSharedPropertyRelease {{{
+  * @brief Release unused prefetched properties
+  * @param[in]  disp  Display
+  **/
+
+void
+subSharedPropertyRelease(Display *disp)
+{
+  int i;
+
+  /* Collect outstanding replies */
+  if(prefetching)
+    {
+      for(i = 0; i < nprefetch; i++)
+        {
+          if(PREFETCH_PENDING == prefetch[i].state)
+            {
+              XSync(disp, False);
+              break;
+            }
+        }
+
+      /* Last reply was an error */
+      if(prefetching)
+        {
+          LockDisplay(disp);
+          DeqAsyncHandler(disp, &prefetchasync);
+          UnlockDisplay(disp);
+
+          prefetching = False;
+        }
+    }
+
+  /* Free unused data */
+  for(i = 0; i < nprefetch; i++)
+    if(prefetch[i].data) XFree(prefetch[i].data);
+
+  if(prefetch) free(prefetch);
+
+  prefetch    = NULL;
+  nprefetch   = 0;
+  prefetchpos = 0;
+} /* }}} */
+
+ /** subSharedPropertyAttributes {{{
+  * @brief Get attributes of many windows with one round trip,
+  *   unmapped windows and errors leave \p IsUnmapped behind
+  * @param[in]     disp   Display
+  * @param[in]     wins   Window list
+  * @param[in]     nwins  Number of windows
+  * @param[inout]  attrs  Attribute list with \p nwins elements
+  **/
+
+void
+subSharedPropertyAttributes(Display *disp,
+  Window *wins,
+  int nwins,
+  XWindowAttributes *attrs)
+{
+  int i;
+  Display *dpy = disp; ///< Required by GetReq
+  _XAsyncHandler async;
+  SharedAttributes a;
+
+  assert(wins && attrs);
+
+  if(0 >= nwins) return;
+
+  memset(attrs, 0, nwins * sizeof(XWindowAttributes));
+
+  a.n     = nwins;
+  a.attrs = attrs;
+
+  LockDisplay(dpy);
+
+  a.seq = dpy->request + 1;
+
+  /* Queue attribute and geometry request per window */
+  for(i = 0; i < nwins; i++)
+    {
+      xResourceReq *req = NULL;
+
+      GetResReq(GetWindowAttributes, wins[i], req);
+      GetResReq(GetGeometry, wins[i], req);
+    }
+
+  /* Install reply handler */
+  async.next          = dpy->async_handlers;
+  async.handler       = SharedAttributesHandler;
+  async.data          = (XPointer)&a;
+  dpy->async_handlers = &async;
+
+  UnlockDisplay(dpy);
+
+  XSync(disp, False); ///< Collect all replies
+
+  LockDisplay(dpy);
+  DeqAsyncHandler(dpy, &async);
+  UnlockDisplay(dpy);
+} /* }}} */
+
+ /** subSharedPropertyDelete {{{
+  * @brief Deletes the property
+  * @param[in]  disp  Display
+  * @param[in]  win   A #Window
+  * @param[in]  prop  Property
+  **/
+
+void
+subSharedPropertyDelete(Display *disp,
+  Window win,
+  Atom prop)
+{
+  assert(win);
+
+  XDeleteProperty(disp, win, prop);
+} /* }}} */
+
+/* Bits */
+
+ /** subSharedBitsClear {{{
+  * @brief Clear all bits
+  * @param[inout]  b  A #SubBits
+  **/
+
+void
+subSharedBitsClear(SubBits *b)
+{
+  memset(b->words, 0, sizeof(b->words));
+} /* }}} */
+
+ /** subSharedBitsSet {{{
+  * @brief Set bit
+  * @param[inout]  b    A #SubBits
+  * @param[in]     bit  Bit index
+  **/
+
+void
+subSharedBitsSet(SubBits *b,
+  int bit)
+{
+  if(0 <= bit && bit < BITSMAX)
+    b->words[bit / 32] |= (1U << (bit % 32));
+} /* }}} */
+
+ /** subSharedBitsUnset {{{
+  * @brief Unset bit
+  * @param[inout]  b    A #SubBits
+  * @param[in]     bit  Bit index
+  **/
+
+void
+subSharedBitsUnset(SubBits *b,
+  int bit)
+{
+  if(0 <= bit && bit < BITSMAX)
+    b->words[bit / 32] &= ~(1U << (bit % 32));
+} /* }}} */
+
+ /** subSharedBitsTest {{{
+  * @brief Test bit
+  * @param[in]  b    A #SubBits
+  * @param[in]  bit  Bit index
+  * @retval  True   Bit is set
+  * @retval  False  Bit is unset
+  **/
+
+int
+subSharedBitsTest(SubBits *b,
+  int bit)
+{
+  return (0 <= bit && bit < BITSMAX &&
+    b->words[bit / 32] & (1U << (bit % 32)));
+} /* }}} */
+
+ /** subSharedBitsAny {{{
+  * @brief Test for common bits
+  * @param[in]  a  A #SubBits
+  * @param[in]  b  A #SubBits
+  * @retval  True   Bitsets share bits
+  * @retval  False  Bitsets share nothing
+  **/
+
+int
+subSharedBitsAny(SubBits *a,
+  SubBits *b)
+{
+  int i;
+  unsigned int any = 0;
+
+  /* Word-wise without branches */
+  for(i = 0; i < BITSWORDS; i++)
+    any |= a->words[i] & b->words[i];
+
+  return 0 != any;
+} /* }}} */
+
+ /** subSharedBitsEmpty {{{
+  * @brief Test for no bits
+  * @param[in]  b  A #SubBits
+  * @retval  True   No bit is set
+  * @retval  False  At least one bit is set
+  **/
+
+int
+subSharedBitsEmpty(SubBits *b)
+{
+  int i;
+  unsigned int any = 0;
+
+  for(i = 0; i < BITSWORDS; i++)
+    any |= b->words[i];
+
+  return 0 == any;
+} /* }}} */
+
+ /** subSharedBitsOr {{{
+  * @brief Add bits of b to a
+  * @param[inout]  a  A #SubBits
+  * @param[in]     b  A #SubBits
+  **/
+
+void
+subSharedBitsOr(SubBits *a,
+  SubBits *b)
+{
+  int i;
+
+  for(i = 0; i < BITSWORDS; i++)
+    a->words[i] |= b->words[i];
+} /* }}} */
+
+ /** subSharedBitsAndNot {{{
+  * @brief Remove bits of b from a
+  * @param[inout]  a  A #SubBits
+  * @param[in]     b  A #SubBits
+  **/
+
+void
+subSharedBitsAndNot(SubBits *a,
+  SubBits *b)
+{
+  int i;
+
+  for(i = 0; i < BITSWORDS; i++)
+    a->words[i] &= ~b->words[i];
+} /* }}} */
+
+ /** subSharedBitsRemove {{{
+  * @brief Remove bit and shift higher bits down
+  * @param[inout]  b    A #SubBits
+  * @param[in]     bit  Bit index
+  **/
+
+void
+subSharedBitsRemove(SubBits *b,
+  int bit)
+{
+  int i, word = bit / 32;
+  unsigned int mask = 0;
+
+  if(0 > bit || BITSMAX <= bit) return;
+
+  /* Keep bits below, shift bits above */
+  mask           = (1U << (bit % 32)) - 1;
+  b->words[word] = (b->words[word] & mask) | ((b->words[word] >> 1) & ~mask);
+
+  for(i = word; i < BITSWORDS; i++)
+    {
+      if(i > word) b->words[i] >>= 1;
+
+      /* Carry lowest bit of next word */
+      if(i + 1 < BITSWORDS && b->words[i + 1] & 1U)
+        b->words[i] |= (1U << 31);
+    }
+} /* }}} */
+
+ /** subSharedBitsPack {{{
+  * @brief Pack bits to cardinals
+  * @param[in]   b          A #SubBits
+  * @param[out]  cardinals  Cardinal list with #BITSWORDS size
+  * @return Returns number of used cardinals
+  **/
+
+int
+subSharedBitsPack(SubBits *b,
+  long *cardinals)
+{
+  int i, n = 1;
+
+  /* Trailing empty words are omitted */
+  for(i = 0; i < BITSWORDS; i++)
+    {
+      cardinals[i] = (long)b->words[i];
+
+      if(0 != b->words[i]) n = i + 1;
+    }
+
+  return n;
+} /* }}} */
+
+ /** subSharedBitsUnpack {{{
+  * @brief Unpack bits from cardinals
+  * @param[out]  b          A #SubBits
+  * @param[in]   cardinals  Cardinal list
+  * @param[in]   n          Number of cardinals
+  **/
+
+void
+subSharedBitsUnpack(SubBits *b,
+  long *cardinals,
+  int n)
+{
+  int i;
+
+  subSharedBitsClear(b);
+
+  for(i = 0; cardinals && i < n && i < BITSWORDS; i++)
+    b->words[i] = (unsigned int)cardinals[i];
+} /* }}} */
+
+/* Draw */
+
+ /** subSharedDrawString {{{
+  * @brief Draw text
+  * @param[in]  disp  Display
+  * @param[in]  gc    GC
   * @param[in]  f     A #SubFont
   * @param[in]  win   Target window
   * @param[in]  x     X position
@@ -405,8 +1491,7 @@ subSharedDrawString(Display *disp,
       XColor xcolor = { 0 };
 
       /* Get color values */
-      xcolor.pixel = fg;
-      XQueryColor(disp, DefaultColormap(disp, DefaultScreen(disp)), &xcolor);
+      subSharedColorGet(disp, fg, &xcolor);
 
       color.pixel       = xcolor.pixel;
       color.color.red   = xcolor.red;
@@ -549,6 +1634,8 @@ subSharedFontKill(Display *disp,
 {
   assert(f);
 
+  subSharedStringFlush(f);
+
 #ifdef HAVE_X11_XFT_XFT_H
   if(f->xft)
     {
@@ -590,10 +1677,110 @@ subSharedParseColor(Display *disp,
   else if(!XAllocColor(disp, DefaultColormap(disp, DefaultScreen(disp)),
       &xcolor))
     fprintf(stderr, "<CRITICAL> Failed allocating color `%s'\n", name);
+  else SharedColorStore(&xcolor); ///< Server returns actual values
 
   return xcolor.pixel;
 } /* }}} */
 
+ /** subSharedColorGet {{{
+  * @brief Get color values of pixel from cache or server
+  * @param[in]     disp    Display
+  * @param[in]     pixel   Color pixel
+  * @param[inout]  xcolor  A #XColor
+  **/
+
+void
+subSharedColorGet(Display *disp,
+  unsigned long pixel,
+  XColor *xcolor)
+{
+  SharedColor *c = NULL;
+
+  assert(xcolor);
+
+  if((c = SharedColorFind(pixel)))
+    {
+      c->used = ++colorclock;
+      *xcolor = c->xcolor;
+    }
+  else
+    {
+      xcolor->pixel = pixel;
+      XQueryColor(disp, DefaultColormap(disp, DefaultScreen(disp)), xcolor);
+
+      SharedColorStore(xcolor);
+    }
+} /* }}} */
+
+ /** subSharedColorResolve {{{
+  * @brief Resolve color values of pixel once and keep them in cache
+  * @param[in]  disp   Display
+  * @param[in]  pixel  Color pixel
+  **/
+
+void
+subSharedColorResolve(Display *disp,
+  unsigned long pixel)
+{
+  SharedColor *c = NULL;
+
+  if((c = SharedColorFind(pixel))) c->used = ++colorclock;
+  else
+    {
+      XColor xcolor = { 0 };
+
+      xcolor.pixel = pixel;
+      XQueryColor(disp, DefaultColormap(disp, DefaultScreen(disp)), &xcolor);
+
+      SharedColorStore(&xcolor);
+    }
+} /* }}} */
+
+ /** subSharedColorPin {{{
+  * @brief Keep colors in cache and resolve unknown ones at once
+  * @param[in]  disp     Display
+  * @param[in]  pixels   Pixel list
+  * @param[in]  npixels  Number of pixels
+  **/
+
+void
+subSharedColorPin(Display *disp,
+  long *pixels,
+  int npixels)
+{
+  int i, nmissing = 0;
+  XColor *missing = NULL;
+  SharedColor *c = NULL;
+
+  /* Release old pins */
+  for(i = 0; i < ncolors; i++)
+    colors[i].pinned = False;
+
+  if(!pixels || 0 >= npixels) return;
+
+  missing = (XColor *)subSharedMemoryAlloc(npixels, sizeof(XColor));
+
+  for(i = 0; i < npixels; i++)
+    {
+      if(-1 == pixels[i]) continue; ///< Unset
+
+      if((c = SharedColorFind(pixels[i]))) c->pinned = True;
+      else missing[nmissing++].pixel = pixels[i];
+    }
+
+  /* Query missing colors in one request */
+  if(0 < nmissing)
+    {
+      XQueryColors(disp, DefaultColormap(disp, DefaultScreen(disp)),
+        missing, nmissing);
+
+      for(i = 0; i < nmissing; i++)
+        if((c = SharedColorStore(&missing[i]))) c->pinned = True;
+    }
+
+  free(missing);
+} /* }}} */
+
  /** subSharedParseKey {{{
   * @brief Parse key
   * @param[in]     disp     Display
@@ -692,6 +1879,32 @@ subSharedSpawn(char *cmd)
   return pid;
 } /* }}} */
 
+ /** subSharedSocketPath {{{
+  * @brief Get path of the IPC socket of a display
+  * @param[in]     disp  Display
+  * @param[inout]  buf   Path buffer
+  * @param[in]     len   Buffer length
+  **/
+
+void
+subSharedSocketPath(Display *disp,
+  char *buf,
+  int len)
+{
+  int off = 0;
+  char *dir = getenv("XDG_RUNTIME_DIR"), *c = NULL;
+
+  off = snprintf(buf, len, "%s/", dir ? dir : "/tmp");
+  if(off >= len) off = len - 1;
+
+  snprintf(buf + off, len - off, "subtle-%d-%s", (int)getuid(),
+    DisplayString(disp));
+
+  /* Keep display name in one path component */
+  for(c = buf + off; *c; c++)
+    if('/' == *c) *c = '_';
+} /* }}} */
+
  /** subSharedStringWidth {{{
   * @brief Get width of the smallest enclosing box
   * @param[in]     disp    Display
@@ -712,13 +1925,43 @@ subSharedStringWidth(Display *disp,
   int *right,
   int center)
 {
-  int width = 0, lbearing = 0, rbearing = 0;
+  int idx = 0, width = 0, lbearing = 0, rbearing = 0;
+  unsigned int hash = 0;
+  SharedExtent *e = NULL;
 
   assert(f);
 
-  /* Get text extents based on font */
-  if(text && 0 < len)
+  if(!text || 0 >= len) return 0;
+
+  /* Check extent cache */
+  hash = SharedExtentHash(f, text, len);
+
+  for(idx = extentbuckets[hash % EXTENTBUCKETS]; idx;
+      idx = extentcache[idx - 1].chain)
+    {
+      e = &extentcache[idx - 1];
+
+      if(e->f == f && e->hash == hash && e->len == len &&
+          0 == memcmp(e->text, text, len))
+        break;
+    }
+
+  if(idx)
+    {
+      extenthits++;
+
+      /* Move to front */
+      SharedExtentUnlink(idx - 1);
+      SharedExtentLink(idx - 1, True);
+
+      width    = e->width;
+      lbearing = e->lbearing;
+    }
+  else
     {
+      extentmisses++;
+
+      /* Get text extents based on font */
 #ifdef HAVE_X11_XFT_XFT_H
       if(f->xft) ///< XFT
         {
@@ -741,16 +1984,417 @@ subSharedStringWidth(Display *disp,
           lbearing = overall_logical.x;
         }
 
-      /* Get left and right spacing */
-      if(left)  *left  = lbearing;
-      if(right) *right = rbearing;
+      /* Reuse new or least recently used entry */
+      if(EXTENTS > nextents) idx = nextents++;
+      else
+        {
+          idx = extenttail - 1;
+
+          SharedExtentDrop(idx);
+          SharedExtentUnlink(idx);
+        }
+
+      e = &extentcache[idx];
+      e->f        = f;
+      e->text     = (char *)subSharedMemoryAlloc(len, sizeof(char));
+      e->len      = len;
+      e->width    = width;
+      e->lbearing = lbearing;
+      e->hash     = hash;
+      e->chain    = extentbuckets[hash % EXTENTBUCKETS];
+
+      memcpy(e->text, text, len);
+
+      extentbuckets[hash % EXTENTBUCKETS] = idx + 1;
+      SharedExtentLink(idx, True);
     }
 
+  /* Get left and right spacing */
+  if(left)  *left  = lbearing;
+  if(right) *right = rbearing;
+
   return center ? width - abs(lbearing - rbearing) : width;
 } /* }}} */
 
+ /** subSharedStringFlush {{{
+  * @brief Drop cached text extents of font
+  * @param[in]  f  A #SubFont or \p NULL for all
+  **/
+
+void
+subSharedStringFlush(SubFont *f)
+{
+  int i;
+
+  /* Free entries move to the end of the LRU list */
+  for(i = 0; i < nextents; i++)
+    {
+      if(extentcache[i].f && (!f || extentcache[i].f == f))
+        {
+          SharedExtentDrop(i);
+          SharedExtentUnlink(i);
+          SharedExtentLink(i, False);
+        }
+    }
+} /* }}} */
+
+ /** subSharedStringStats {{{
+  * @brief Get text extent cache statistics
+  * @param[inout]  hits    Number of cache hits
+  * @param[inout]  misses  Number of cache misses
+  **/
+
+void
+subSharedStringStats(unsigned long *hits,
+  unsigned long *misses)
+{
+  if(hits)   *hits   = extenthits;
+  if(misses) *misses = extentmisses;
+} /* }}} */
+
 #ifndef SUBTLE
 
+static int ipcfd = -1, ipcbatch = 0, nipcbuf = 0;
+static char *ipcbuf = NULL;
+
+/* SharedIpcConnect {{{ */
+static int
+SharedIpcConnect(Display *disp)
+{
+  /* Connect once, -2 marks a missing socket */
+  if(-1 == ipcfd)
+    {
+      struct sockaddr_un addr = { 0 };
+
+      addr.sun_family = AF_UNIX;
+      subSharedSocketPath(disp, addr.sun_path, sizeof(addr.sun_path));
+
+      if(0 <= (ipcfd = socket(AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0)) &&
+          -1 == connect(ipcfd, (struct sockaddr *)&addr, sizeof(addr)))
+        {
+          close(ipcfd);
+          ipcfd = -1;
+        }
+
+      if(0 > ipcfd) ipcfd = -2;
+    }
+
+  return 0 <= ipcfd;
+} /* }}} */
+
+/* SharedIpcWrite {{{ */
+static int
+SharedIpcWrite(const char *buf,
+  int len)
+{
+  int ret = 0, sent = 0;
+
+  /* Write until done or broken */
+  while(sent < len)
+    {
+      if(-1 == (ret = send(ipcfd, buf + sent, len - sent, MSG_NOSIGNAL)))
+        {
+          if(EINTR == errno) continue;
+
+          break;
+        }
+
+      sent += ret;
+    }
+
+  return sent;
+} /* }}} */
+
+/* SharedMessageSend {{{ */
+static int
+SharedMessageSend(Display *disp,
+  Window win,
+  Atom type,
+  SubMessageData data,
+  int format)
+{
+  XEvent ev;
+  long mask = SubstructureRedirectMask|SubstructureNotifyMask;
+
+  /* Assemble event */
+  ev.xclient.type         = ClientMessage;
+  ev.xclient.serial       = 0;
+  ev.xclient.send_event   = True;
+  ev.xclient.message_type = type;
+  ev.xclient.window       = win;
+  ev.xclient.format       = format;
+
+  /* Copy data over */
+  ev.xclient.data.l[0] = data.l[0];
+  ev.xclient.data.l[1] = data.l[1];
+  ev.xclient.data.l[2] = data.l[2];
+  ev.xclient.data.l[3] = data.l[3];
+  ev.xclient.data.l[4] = data.l[4];
+
+  return XSendEvent(disp, DefaultRootWindow(disp), False, mask, &ev);
+} /* }}} */
+
+/* SharedTagsAppend {{{ */
+static void
+SharedTagsAppend(Display *disp,
+  Atom type,
+  long target,
+  const long *words,
+  int nwords)
+{
+  long record[BITSWORDS + 3] = { 0 };
+
+  /* Records are type, target, word count and words; appending is atomic
+   * so senders don't overwrite each other */
+  record[0] = (long)type;
+  record[1] = target;
+  record[2] = nwords;
+
+  memcpy(record + 3, words, nwords * sizeof(long));
+
+  XChangeProperty(disp, DefaultRootWindow(disp),
+    subSharedAtomGet(SUB_EWMH_SUBTLE_TAGS), XA_CARDINAL, 32,
+    PropModeAppend, (unsigned char *)record, nwords + 3);
+} /* }}} */
+
+/* SharedIpcReplay {{{ */
+static int
+SharedIpcReplay(Display *disp,
+  const char *buf,
+  int len,
+  int sent)
+{
+  int off = 0, ret = True;
+
+  /* Send frames via X that subtle didn't get completely */
+  while(off + (int)sizeof(SubIpcMessage) <= len)
+    {
+      SubIpcMessage msg;
+
+      memcpy(&msg, buf + off, sizeof(SubIpcMessage));
+
+      if(off + (int)sizeof(SubIpcMessage) + msg.len > sent)
+        {
+          /* Extra data goes through the data or tags property */
+          if(0 < msg.len && (msg.type ==
+              subSharedAtomGet(SUB_EWMH_SUBTLE_CLIENT_TAGS) ||
+              msg.type == subSharedAtomGet(SUB_EWMH_SUBTLE_VIEW_TAGS)))
+            {
+              long words[BITSWORDS] = { 0 };
+              int nwords = msg.len / (int)sizeof(long);
+
+              if(BITSWORDS < nwords) nwords = BITSWORDS;
+
+              memcpy(words, buf + off + sizeof(SubIpcMessage),
+                nwords * sizeof(long));
+
+              SharedTagsAppend(disp, msg.type, msg.data.l[0], words, nwords);
+            }
+          else if(0 < msg.len)
+            {
+              char *list = strndup(buf + off + sizeof(SubIpcMessage),
+                msg.len);
+
+              subSharedPropertySetStrings(disp, DefaultRootWindow(disp),
+                subSharedAtomGet(SUB_EWMH_SUBTLE_DATA), &list, 1);
+              free(list);
+            }
+
+          if(!SharedMessageSend(disp, msg.win, msg.type, msg.data,
+              msg.format))
+            ret = False;
+        }
+
+      off += sizeof(SubIpcMessage) + msg.len;
+    }
+
+  XSync(disp, False);
+
+  return ret;
+} /* }}} */
+
+ /** subSharedIpcSend {{{
+  * @brief Send message to subtle via socket
+  * @param[in]  disp    Display
+  * @param[in]  win     Message window
+  * @param[in]  type    Message type
+  * @param[in]  data    A #SubMessageData
+  * @param[in]  format  Data format
+  * @param[in]  string  Extra data or \p NULL
+  * @param[in]  len     Length of extra data
+  * @retval  True   Message was sent or queued
+  * @retval  False  No socket available
+  **/
+
+int
+subSharedIpcSend(Display *disp,
+  Window win,
+  Atom type,
+  SubMessageData data,
+  int format,
+  const char *string,
+  int len)
+{
+  int size = sizeof(SubIpcMessage) + len, ret = True;
+  char *buf = NULL;
+  SubIpcMessage msg;
+
+  if(IPCMAXLEN < len || !SharedIpcConnect(disp)) return False;
+
+  /* Assemble message */
+  memset(&msg, 0, sizeof(SubIpcMessage));
+  msg.win    = win;
+  msg.type   = type;
+  msg.format = format;
+  msg.len    = len;
+  msg.data   = data;
+
+  /* Append to batch or send header and data at once */
+  if(0 < ipcbatch)
+    {
+      ipcbuf = (char *)subSharedMemoryRealloc(ipcbuf, nipcbuf + size);
+      buf    = ipcbuf + nipcbuf;
+
+      nipcbuf += size;
+    }
+  else buf = (char *)subSharedMemoryAlloc(size, sizeof(char));
+
+  memcpy(buf, &msg, sizeof(SubIpcMessage));
+  if(0 < len) memcpy(buf + sizeof(SubIpcMessage), string, len);
+
+  if(0 == ipcbatch)
+    {
+      XFlush(disp); ///< Let queued X requests go first
+
+      /* Subtle drops incomplete messages, caller falls back to X */
+      if(size != SharedIpcWrite(buf, size))
+        {
+          subSharedIpcClose();
+
+          ret = False;
+        }
+
+      free(buf);
+    }
+
+  return ret;
+} /* }}} */
+
+ /** subSharedIpcBatch {{{
+  * @brief Start batch or send batched messages at once
+  * @param[in]  disp   Display
+  * @param[in]  batch  Start or end batch
+  * @retval  True   Batch was started or sent
+  * @retval  False  Batch could not be sent, not even via X
+  **/
+
+int
+subSharedIpcBatch(Display *disp,
+  int batch)
+{
+  int ret = True;
+
+  if(batch)
+    {
+      if(SharedIpcConnect(disp)) ipcbatch++;
+    }
+  else if(0 < ipcbatch && 0 == --ipcbatch && 0 < nipcbuf)
+    {
+      int sent = 0;
+
+      XSync(disp, False); ///< Batched messages may rely on X requests
+
+      sent = SharedIpcWrite(ipcbuf, nipcbuf);
+
+      /* Replay what's missing via X */
+      if(sent != nipcbuf)
+        {
+          ret = SharedIpcReplay(disp, ipcbuf, nipcbuf, sent);
+
+          subSharedIpcClose();
+        }
+
+      nipcbuf = 0;
+    }
+
+  return ret;
+} /* }}} */
+
+ /** subSharedIpcClose {{{
+  * @brief Close socket and drop pending batch
+  **/
+
+void
+subSharedIpcClose(void)
+{
+  if(0 <= ipcfd) close(ipcfd);
+
+  if(ipcbuf) free(ipcbuf);
+
+  ipcfd    = -1;
+  ipcbuf   = NULL;
+  ipcbatch = 0;
+  nipcbuf  = 0;
+} /* }}} */
+
+ /** subSharedIpcDisable {{{
+  * @brief Close socket and send all messages via X
+  **/
+
+void
+subSharedIpcDisable(void)
+{
+  subSharedIpcClose();
+
+  ipcfd = -2; ///< Treat like a missing socket
+} /* }}} */
+
+ /** subSharedTagsSend {{{
+  * @brief Send tag bits message with all words at once
+  * @param[in]  disp    Display
+  * @param[in]  type    Message type
+  * @param[in]  data    A #SubMessageData with target in first slot
+  * @param[in]  words   Tag words
+  * @param[in]  nwords  Number of words
+  * @returns
+  **/
+
+int
+subSharedTagsSend(Display *disp,
+  char *type,
+  SubMessageData data,
+  long *words,
+  int nwords)
+{
+  int status = 0;
+  Atom atom = None;
+
+  assert(disp && words && 0 < nwords && BITSWORDS >= nwords);
+
+  atom = subSharedAtomIntern(disp, type);
+
+  /* First word and count fit into the message */
+  data.l[1] = words[0];
+  data.l[3] = nwords;
+
+  if(1 == nwords)
+    return subSharedMessage(disp, DefaultRootWindow(disp), type,
+      data, 32, True);
+
+  /* Prefer socket of subtle, otherwise append words to the property */
+  if(subSharedIpcSend(disp, DefaultRootWindow(disp), atom, data, 32,
+      (const char *)words, nwords * sizeof(long)))
+    return True;
+
+  SharedTagsAppend(disp, atom, data.l[0], words, nwords);
+
+  status = SharedMessageSend(disp, DefaultRootWindow(disp), atom, data, 32);
+
+  XSync(disp, False);
+
+  return status;
+} /* }}} */
+
  /** subSharedMessage {{{
   * @brief Send client message to window
   * @param[in]  disp    Display
@@ -771,27 +2415,20 @@ subSharedMessage(Display *disp,
   int xsync)
 {
   int status = 0;
-  XEvent ev;
-  long mask = SubstructureRedirectMask|SubstructureNotifyMask;
+  Atom atom = None;
 
   assert(disp && win);
 
-  /* Assemble event */
-  ev.xclient.type         = ClientMessage;
-  ev.xclient.serial       = 0;
-  ev.xclient.send_event   = True;
-  ev.xclient.message_type = XInternAtom(disp, type, False);
-  ev.xclient.window       = win;
-  ev.xclient.format       = format;
+  atom = subSharedAtomIntern(disp, type);
 
-  /* Copy data over */
-  ev.xclient.data.l[0] = data.l[0];
-  ev.xclient.data.l[1] = data.l[1];
-  ev.xclient.data.l[2] = data.l[2];
-  ev.xclient.data.l[3] = data.l[3];
-  ev.xclient.data.l[4] = data.l[4];
+  /* Prefer socket of subtle, X requests must be handled first */
+  if(True == xsync && 0 == ipcbatch && SharedIpcConnect(disp))
+    XSync(disp, False);
+
+  if(subSharedIpcSend(disp, win, atom, data, format, NULL, 0))
+    return True;
 
-  status = XSendEvent(disp, DefaultRootWindow(disp), False, mask, &ev);
+  status = SharedMessageSend(disp, win, atom, data, format);
 
   if(True == xsync) XSync(disp, False);
 
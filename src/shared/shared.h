@@ -45,6 +45,11 @@
 
 #define DEFFONT   "-*-*-*-*-*-*-14-*-*-*-*-*-*-*"                 ///< Default font
 
+#define BITSWORDS 16                                              ///< Bitset words
+#define BITSMAX   (BITSWORDS * 32)                                ///< Bitset capacity
+
+#define IPCMAXLEN 65536                                           ///< Max IPC message data
+
 #define DATA(d)   ((SubData)d)                                    ///< Cast to SubData
 #define FONT(f)   ((SubFont *)f)                                  ///< Cast to SubFont
 #define TEXT(t)   ((SubText *)t)                                  ///< Cast to SubText
@@ -99,12 +104,138 @@ typedef struct subfont_t /* {{{ */
 #endif /* HAVE_X11_XFT_XFT_H */
 } SubFont; /* }}} */
 
+typedef enum subewmh_t /* {{{ */
+{
+  /* ICCCM */
+  SUB_EWMH_WM_NAME,                                               ///< Name of window
+  SUB_EWMH_WM_CLASS,                                              ///< Class of window
+  SUB_EWMH_WM_STATE,                                              ///< Window state
+  SUB_EWMH_WM_PROTOCOLS,                                          ///< Supported protocols
+  SUB_EWMH_WM_TAKE_FOCUS,                                         ///< Send focus messages
+  SUB_EWMH_WM_DELETE_WINDOW,                                      ///< Send close messages
+  SUB_EWMH_WM_NORMAL_HINTS,                                       ///< Window normal hints
+  SUB_EWMH_WM_SIZE_HINTS,                                         ///< Window size hints
+  SUB_EWMH_WM_HINTS,                                              ///< Window hints
+  SUB_EWMH_WM_WINDOW_ROLE,                                        ///< Window role
+  SUB_EWMH_WM_CLIENT_LEADER,                                      ///< Client leader
+
+  /* EWMH */
+  SUB_EWMH_NET_SUPPORTED,                                         ///< Supported states
+  SUB_EWMH_NET_CLIENT_LIST,                                       ///< List of clients
+  SUB_EWMH_NET_CLIENT_LIST_STACKING,                              ///< List of clients
+  SUB_EWMH_NET_NUMBER_OF_DESKTOPS,                                ///< Total number of views
+  SUB_EWMH_NET_DESKTOP_NAMES,                                     ///< Names of the views
+  SUB_EWMH_NET_DESKTOP_GEOMETRY,                                  ///< Desktop geometry
+  SUB_EWMH_NET_DESKTOP_VIEWPORT,                                  ///< Viewport of the view
+  SUB_EWMH_NET_CURRENT_DESKTOP,                                   ///< Number of current view
+  SUB_EWMH_NET_ACTIVE_WINDOW,                                     ///< Focus window
+  SUB_EWMH_NET_WORKAREA,                                          ///< Workarea of the views
+  SUB_EWMH_NET_SUPPORTING_WM_CHECK,                               ///< Check for compliant window manager
+  SUB_EWMH_NET_WM_FULL_PLACEMENT,                                 ///< WM does all placement
+  SUB_EWMH_NET_FRAME_EXTENTS,                                     ///< Extents of the client frame
+
+  /* Client */
+  SUB_EWMH_NET_CLOSE_WINDOW,                                      ///< Close window
+  SUB_EWMH_NET_RESTACK_WINDOW,                                    ///< Change window stacking
+  SUB_EWMH_NET_MOVERESIZE_WINDOW,                                 ///< Resize window
+  SUB_EWMH_NET_WM_NAME,                                           ///< Name of client
+  SUB_EWMH_NET_WM_PID,                                            ///< PID of client
+  SUB_EWMH_NET_WM_DESKTOP,                                        ///< Desktop client is on
+  SUB_EWMH_NET_WM_STRUT,                                          ///< Strut
+
+  /* Types */
+  SUB_EWMH_NET_WM_WINDOW_TYPE,                                    ///< Window type
+  SUB_EWMH_NET_WM_WINDOW_TYPE_DOCK,                               ///< Dock window
+  SUB_EWMH_NET_WM_WINDOW_TYPE_DESKTOP,                            ///< Desktop window
+  SUB_EWMH_NET_WM_WINDOW_TYPE_TOOLBAR,                            ///< Toolbar window
+  SUB_EWMH_NET_WM_WINDOW_TYPE_SPLASH,                             ///< Splash window
+  SUB_EWMH_NET_WM_WINDOW_TYPE_DIALOG,                             ///< Dialog window
+
+  /* States */
+  SUB_EWMH_NET_WM_STATE,                                          ///< Window state
+  SUB_EWMH_NET_WM_STATE_FULLSCREEN,                               ///< Fullscreen window
+  SUB_EWMH_NET_WM_STATE_ABOVE,                                    ///< Floating window
+  SUB_EWMH_NET_WM_STATE_STICKY,                                   ///< Sticky window
+  SUB_EWMH_NET_WM_STATE_ATTENTION,                                ///< Urgent window
+
+  /* Tray */
+  SUB_EWMH_NET_SYSTEM_TRAY_OPCODE,                                ///< Tray messages
+  SUB_EWMH_NET_SYSTEM_TRAY_MESSAGE_DATA,                          ///< Tray message data
+  SUB_EWMH_NET_SYSTEM_TRAY_SELECTION,                             ///< Tray selection
+
+  /* Misc */
+  SUB_EWMH_UTF8,                                                  ///< String encoding
+  SUB_EWMH_MANAGER,                                               ///< Selection manager
+  SUB_EWMH_MOTIF_WM_HINTS,                                        ///< Motif decoration hints
+
+  /* XEmbed */
+  SUB_EWMH_XEMBED,                                                ///< XEmbed
+  SUB_EWMH_XEMBED_INFO,                                           ///< XEmbed info
+
+  /* subtle */
+  SUB_EWMH_SUBTLE_CLIENT_TAGS,                                    ///< Subtle client tags
+  SUB_EWMH_SUBTLE_CLIENT_RETAG,                                   ///< Subtle client retag
+  SUB_EWMH_SUBTLE_CLIENT_GRAVITY,                                 ///< Subtle client gravity
+  SUB_EWMH_SUBTLE_CLIENT_SCREEN,                                  ///< Subtle client screen
+  SUB_EWMH_SUBTLE_CLIENT_FLAGS,                                   ///< Subtle client flags
+  SUB_EWMH_SUBTLE_CLIENT_NEIGHBOURS,                              ///< Subtle client neighbours
+  SUB_EWMH_SUBTLE_GRAVITY_NEW,                                    ///< Subtle gravity new
+  SUB_EWMH_SUBTLE_GRAVITY_FLAGS,                                  ///< Subtle gravity flags
+  SUB_EWMH_SUBTLE_GRAVITY_LIST,                                   ///< Subtle gravity list
+  SUB_EWMH_SUBTLE_GRAVITY_KILL,                                   ///< Subtle gravtiy kill
+  SUB_EWMH_SUBTLE_TAG_NEW,                                        ///< Subtle tag new
+  SUB_EWMH_SUBTLE_TAG_LIST,                                       ///< Subtle tag list
+  SUB_EWMH_SUBTLE_TAG_KILL,                                       ///< Subtle tag kill
+  SUB_EWMH_SUBTLE_TRAY_LIST,                                      ///< Subtle tray list
+  SUB_EWMH_SUBTLE_VIEW_NEW,                                       ///< Subtle view new
+  SUB_EWMH_SUBTLE_VIEW_TAGS,                                      ///< Subtle view tags
+  SUB_EWMH_SUBTLE_VIEW_STYLE,                                     ///< Subtle view style
+  SUB_EWMH_SUBTLE_VIEW_ICONS,                                     ///< Subtle view icons
+  SUB_EWMH_SUBTLE_VIEW_KILL,                                      ///< Subtle view kill
+  SUB_EWMH_SUBTLE_SUBLET_UPDATE,                                  ///< Subtle sublet update
+  SUB_EWMH_SUBTLE_SUBLET_DATA,                                    ///< Subtle sublet data
+  SUB_EWMH_SUBTLE_SUBLET_STYLE,                                   ///< Subtle sublet style
+  SUB_EWMH_SUBTLE_SUBLET_FLAGS,                                   ///< Subtle sublet flags
+  SUB_EWMH_SUBTLE_SUBLET_LIST,                                    ///< Subtle sublet list
+  SUB_EWMH_SUBTLE_SUBLET_KILL,                                    ///< Subtle sublet kill
+  SUB_EWMH_SUBTLE_SCREEN_PANELS,                                  ///< Subtle screen panels
+  SUB_EWMH_SUBTLE_SCREEN_VIEWS,                                   ///< Subtle screen views
+  SUB_EWMH_SUBTLE_SCREEN_JUMP,                                    ///< Subtle screen jump
+  SUB_EWMH_SUBTLE_VISIBLE_TAGS,                                   ///< Subtle visible tags
+  SUB_EWMH_SUBTLE_VISIBLE_VIEWS,                                  ///< Subtle visible views
+  SUB_EWMH_SUBTLE_RENDER,                                         ///< Subtle render
+  SUB_EWMH_SUBTLE_RELOAD,                                         ///< Subtle reload
+  SUB_EWMH_SUBTLE_RESTART,                                        ///< Subtle restart
+  SUB_EWMH_SUBTLE_QUIT,                                           ///< Subtle quit
+  SUB_EWMH_SUBTLE_COLORS,                                         ///< Subtle colors
+  SUB_EWMH_SUBTLE_FONT,                                           ///< Subtle font
+  SUB_EWMH_SUBTLE_DATA,                                           ///< Subtle data
+  SUB_EWMH_SUBTLE_VERSION,                                        ///< Subtle version
+  SUB_EWMH_SUBTLE_STATS,                                          ///< Subtle stats
+  SUB_EWMH_SUBTLE_TAGS,                                           ///< Subtle tags
+
+  SUB_EWMH_TOTAL
+} SubEwmh; /* }}} */
+
+typedef struct subbits_t /* {{{ */
+{
+  unsigned int words[BITSWORDS];                                  ///< Bits words
+} SubBits; /* }}} */
+
 typedef union submessagedata_t /* {{{ */
 {
   char  b[20];                                                    ///< MessageData char
   short s[10];                                                    ///< MessageData short
   long  l[5];                                                     ///< MessageData long
 } SubMessageData; /* }}} */
+
+typedef struct subipcmessage_t /* {{{ */
+{
+  Window         win;                                             ///< Message window
+  Atom           type;                                            ///< Message type
+  int            format, len;                                     ///< Message format, data length
+  SubMessageData data;                                            ///< Message data
+} SubIpcMessage; /* }}} */
 /* }}} */
 
 /* Memory {{{ */
@@ -118,6 +249,14 @@ int subSharedRegexMatch(regex_t *preg, char *string);             ///< Check if
 void subSharedRegexKill(regex_t *preg);                           ///< Kill regex
 /* }}} */
 
+/* Atom {{{ */
+void subSharedAtomInit(Display *disp, int screen);                ///< Intern known atoms
+Atom subSharedAtomGet(SubEwmh e);                                 ///< Get atom
+SubEwmh subSharedAtomFind(Atom atom);                             ///< Find atom id
+Atom subSharedAtomIntern(Display *disp, char *name);              ///< Get atom by name
+void subSharedAtomKill(void);                                     ///< Clear atom registry
+/* }}} */
+
 /* Property {{{ */
 char *subSharedPropertyGet(Display *disp, Window win,
   Atom type, Atom prop, unsigned long *size);                     ///< Get window property
@@ -133,6 +272,25 @@ void subSharedPropertyGeometry(Display *disp, Window win,
   XRectangle *geometry);                                          ///< Get window geometry
 void subSharedPropertyDelete(Display *disp, Window win,
   Atom prop);                                                     ///< Delete window property
+void subSharedPropertyPrefetch(Display *disp, Window *wins,
+  int nwins, Atom *props, int nprops);                            ///< Prefetch window properties
+void subSharedPropertyRelease(Display *disp);                     ///< Release prefetched properties
+void subSharedPropertyAttributes(Display *disp, Window *wins,
+  int nwins, XWindowAttributes *attrs);                           ///< Get attributes of windows
+/* }}} */
+
+/* Bits {{{ */
+void subSharedBitsClear(SubBits *b);                              ///< Clear all bits
+void subSharedBitsSet(SubBits *b, int bit);                       ///< Set bit
+void subSharedBitsUnset(SubBits *b, int bit);                     ///< Unset bit
+int subSharedBitsTest(SubBits *b, int bit);                       ///< Test bit
+int subSharedBitsAny(SubBits *a, SubBits *b);                     ///< Test for common bits
+int subSharedBitsEmpty(SubBits *b);                               ///< Test for no bits
+void subSharedBitsOr(SubBits *a, SubBits *b);                     ///< Add bits
+void subSharedBitsAndNot(SubBits *a, SubBits *b);                 ///< Remove bits
+void subSharedBitsRemove(SubBits *b, int bit);                    ///< Remove bit and shift down
+int subSharedBitsPack(SubBits *b, long *cardinals);               ///< Pack bits to cardinals
+void subSharedBitsUnpack(SubBits *b, long *cardinals, int n);     ///< Unpack bits from cardinals
 /* }}} */
 
 /* Draw {{{ */
@@ -151,11 +309,21 @@ void subSharedFontKill(Display *disp, SubFont *f);                ///< Kill font
 
 /* Misc {{{ */
 unsigned long subSharedParseColor(Display *disp, char *name);     ///< Parse color
+void subSharedColorGet(Display *disp, unsigned long pixel,
+  XColor *xcolor);                                                ///< Get cached color values
+void subSharedColorResolve(Display *disp,
+  unsigned long pixel);                                           ///< Cache color values
+void subSharedColorPin(Display *disp, long *pixels,
+  int npixels);                                                   ///< Pin colors in cache
 KeySym subSharedParseKey(Display *disp, const char *key,
   unsigned int *code, unsigned int *state, int *mouse);           ///< Parse keys
 pid_t subSharedSpawn(char *cmd);                                  ///< Spawn command
+void subSharedSocketPath(Display *disp, char *buf, int len);       ///< Get IPC socket path
 int subSharedStringWidth(Display *disp, SubFont *f,
   const char *text, int len, int *left, int *right, int center);  ///< Get text width
+void subSharedStringFlush(SubFont *f);                            ///< Drop cached text extents
+void subSharedStringStats(unsigned long *hits,
+  unsigned long *misses);                                         ///< Get text extent stats
 /* }}} */
 
 #ifndef SUBTLE
@@ -163,6 +331,13 @@ int subSharedStringWidth(Display *disp, SubFont *f,
 /* Message {{{ */
 int subSharedMessage(Display *disp, Window win, char *type,
   SubMessageData data, int format, int xsync);                    ///< Send client message
+int subSharedIpcSend(Display *disp, Window win, Atom type,
+  SubMessageData data, int format, const char *string, int len);  ///< Send message via socket
+int subSharedIpcBatch(Display *disp, int batch);                  ///< Start or flush batch
+int subSharedTagsSend(Display *disp, char *type, SubMessageData data,
+  long *words, int nwords);                                       ///< Send tag bits
+void subSharedIpcClose(void);                                     ///< Close socket
+void subSharedIpcDisable(void);                                   ///< Don't use socket
 /* }}} */
 
 #endif /* SUBTLE */
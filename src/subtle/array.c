@@ -12,6 +12,48 @@
 
 #include "subtle.h"
 
+#define ARRAYMIN 4                                                ///< Minimum array capacity
+
+/* ArrayReserve {{{ */
+static void
+ArrayReserve(SubArray *a,
+  int n)
+{
+  /* Grow geometrically */
+  if(n > a->size)
+    {
+      int size = MAX(ARRAYMIN, a->size);
+
+      while(size < n) size *= 2;
+
+      a->data = (void **)subSharedMemoryRealloc(a->data, size * sizeof(void *));
+      a->size = size;
+    }
+} /* }}} */
+
+/* ArrayShrink {{{ */
+static void
+ArrayShrink(SubArray *a)
+{
+  /* Give memory back when mostly empty */
+  if(ARRAYMIN < a->size && a->ndata < a->size / 4)
+    {
+      a->size /= 2;
+      a->data  = (void **)subSharedMemoryRealloc(a->data,
+        a->size * sizeof(void *));
+    }
+} /* }}} */
+
+/* ArrayCompare {{{ */
+static int
+ArrayCompare(const void *a,
+  const void *b)
+{
+  void *p1 = *(void **)a, *p2 = *(void **)b;
+
+  return p1 < p2 ? -1 : (p1 > p2 ? 1 : 0);
+} /* }}} */
+
  /** subArrayNew {{{
   * @brief Create new array and init it
   * @return Returns a #SubArray or \p NULL
@@ -37,11 +79,34 @@ subArrayPush(SubArray *a,
 
   if(elem)
     {
-      a->data = (void **)subSharedMemoryRealloc(a->data, (a->ndata + 1) * sizeof(void *));
+      ArrayReserve(a, a->ndata + 1);
+
       a->data[(a->ndata)++] = elem;
     }
 } /* }}} */
 
+ /** subArrayPushAll {{{
+  * @brief Push elements to array
+  * @param[in]  a      A #SubArray
+  * @param[in]  elems  New elements
+  * @param[in]  n      Number of elements
+  **/
+
+void
+subArrayPushAll(SubArray *a,
+  void **elems,
+  int n)
+{
+  int i;
+
+  assert(a);
+
+  ArrayReserve(a, a->ndata + n);
+
+  for(i = 0; i < n; i++)
+    if(elems[i]) a->data[(a->ndata)++] = elems[i];
+} /* }}} */
+
 /** subArrayInsert {{{
   * @brief Insert element at position
   * @param[in]  a     A #SubArray
@@ -54,20 +119,18 @@ subArrayInsert(SubArray *a,
   int pos,
   void *elem)
 {
-  int i;
-
   assert(a && elem);
 
   /* Check boundaries */
   if(pos < a->ndata)
     {
-      a->ndata++;
-      a->data = (void **)subSharedMemoryRealloc(a->data, a->ndata * sizeof(void *));
+      ArrayReserve(a, a->ndata + 1);
 
-      for(i = a->ndata - 1; i > pos; i--)
-        a->data[i] = a->data[i - 1];
+      memmove(&a->data[pos + 1], &a->data[pos],
+        (a->ndata - pos) * sizeof(void *));
 
       a->data[pos] = elem;
+      a->ndata++;
     }
   else subArrayPush(a, elem);
 } /* }}} */
@@ -82,18 +145,103 @@ void
 subArrayRemove(SubArray *a,
   void *elem)
 {
-  int i, idx;
-
   assert(a && elem);
 
-  if(0 <= (idx = subArrayIndex(a, elem)))
+  subArrayRemoveAt(a, subArrayIndex(a, elem));
+} /* }}} */
+
+ /** subArrayRemoveAt {{{
+  * @brief Remove element at position and keep order
+  * @param[in]  a    A #SubArray
+  * @param[in]  idx  Array index
+  * @return Returns the removed element or \p NULL
+  **/
+
+void *
+subArrayRemoveAt(SubArray *a,
+  int idx)
+{
+  void *elem = NULL;
+
+  assert(a);
+
+  if(0 <= idx && idx < a->ndata)
     {
-      for(i = idx; i < a->ndata - 1; i++)
-        a->data[i] = a->data[i + 1];
+      elem = a->data[idx];
+
+      memmove(&a->data[idx], &a->data[idx + 1],
+        (a->ndata - idx - 1) * sizeof(void *));
 
       a->ndata--;
-      a->data = (void **)subSharedMemoryRealloc(a->data, a->ndata * sizeof(void *));
+
+      ArrayShrink(a);
     }
+
+  return elem;
+} /* }}} */
+
+ /** subArraySwapRemove {{{
+  * @brief Remove element at position and fill gap with last element
+  * @param[in]  a    A #SubArray
+  * @param[in]  idx  Array index
+  * @return Returns the removed element or \p NULL
+  **/
+
+void *
+subArraySwapRemove(SubArray *a,
+  int idx)
+{
+  void *elem = NULL;
+
+  assert(a);
+
+  if(0 <= idx && idx < a->ndata)
+    {
+      elem         = a->data[idx];
+      a->data[idx] = a->data[--(a->ndata)];
+
+      ArrayShrink(a);
+    }
+
+  return elem;
+} /* }}} */
+
+ /** subArrayRemoveAll {{{
+  * @brief Remove elements from array in one pass and keep order
+  * @param[in]  a      A #SubArray
+  * @param[in]  elems  Array elements
+  * @param[in]  n      Number of elements
+  **/
+
+void
+subArrayRemoveAll(SubArray *a,
+  void **elems,
+  int n)
+{
+  int i, j;
+  void **sorted = NULL;
+
+  assert(a);
+
+  if(0 >= n || 0 == a->ndata) return;
+
+  /* Sort copy of elements for lookup */
+  sorted = (void **)subSharedMemoryAlloc(n, sizeof(void *));
+  memcpy(sorted, elems, n * sizeof(void *));
+  qsort(sorted, n, sizeof(void *), ArrayCompare);
+
+  /* Compact survivors */
+  for(i = 0, j = 0; i < a->ndata; i++)
+    {
+      if(!bsearch(&a->data[i], sorted, n, sizeof(void *), ArrayCompare))
+        a->data[j++] = a->data[i];
+    }
+
+  a->ndata = j;
+
+  ArrayShrink(a);
+
+  free(sorted);
 } /* }}} */
 
  /** subArrayGet {{{
@@ -185,6 +333,7 @@ subArrayClear(SubArray *a,
 
       a->data  = NULL;
       a->ndata = 0;
+      a->size  = 0;
     }
 } /* }}} */
 
@@ -29,8 +29,23 @@ typedef struct clientmwmhints_t
   long input_mode;
   unsigned long status;
 } ClientMWMHints;
+
+typedef struct clienttiles_t
+{
+  SubClient *head, *tail;
+} ClientTiles;
+
+typedef struct clientcell_t
+{
+  int      distance, id;
+  SubIndex *index;
+} ClientCell;
 /* }}} */
 
+/* Globals */
+static ClientTiles *tiles = NULL;
+static int ntilescreens = 0, ntilegravities = 0;
+
 /* Private */
 
 /* ClientMask {{{ */
@@ -41,6 +56,47 @@ ClientMask(XRectangle *geom)
     geom->width + 1, geom->height + 1);
 } /* }}} */
 
+/* ClientBorder {{{ */
+static void
+ClientBorder(SubClient *c,
+  XRectangle *geom)
+{
+  /* Subtract border width */
+  if(!(c->flags & SUB_CLIENT_MODE_BORDERLESS))
+    {
+      geom->x -= subtle->styles.clients.border.top;
+      geom->y -= subtle->styles.clients.border.top;
+    }
+} /* }}} */
+
+/* ClientMotion {{{ */
+static Bool
+ClientMotion(Display *display,
+  XEvent *ev,
+  XPointer arg)
+{
+  int *release = (int *)arg;
+
+  /* Motion after a release belongs to the next drag */
+  if(ButtonRelease == ev->type) *release = True;
+
+  return !*release && MotionNotify == ev->type;
+} /* }}} */
+
+/* ClientFrame {{{ */
+static void
+ClientFrame(SubClient *c,
+  XRectangle *geom)
+{
+  XRectangle frame = *geom;
+
+  /* Show drag position right away */
+  ClientBorder(c, &frame);
+  XMoveResizeWindow(subtle->dpy, c->win, frame.x, frame.y,
+    frame.width, frame.height);
+  XFlush(subtle->dpy);
+} /* }}} */
+
 /* ClientGravity {{{ */
 int
 ClientGravity(void)
@@ -167,27 +223,116 @@ ClientResize(SubClient *c,
     c->geom.width, c->geom.height);
 } /* }}} */
 
+/* ClientTileUnlink {{{ */
+static void
+ClientTileUnlink(SubClient *c)
+{
+  ClientTiles *l = NULL;
+
+  if(!c->tileid) return;
+
+  l = &tiles[c->tileid - 1];
+
+  /* Remove from list */
+  if(c->tileprev) c->tileprev->tilenext = c->tilenext;
+  else l->head = c->tilenext;
+
+  if(c->tilenext) c->tilenext->tileprev = c->tileprev;
+  else l->tail = c->tileprev;
+
+  c->tileprev = c->tilenext = NULL;
+  c->tileid   = 0;
+} /* }}} */
+
+/* ClientTileLink {{{ */
+static void
+ClientTileLink(SubClient *c)
+{
+  int id = 0;
+
+  /* Skip clients without valid gravity or screen */
+  if(0 <= c->gravityid && c->gravityid < ntilegravities &&
+      0 <= c->screenid && c->screenid < ntilescreens)
+    id = c->screenid * ntilegravities + c->gravityid + 1;
+
+  if(id == c->tileid) return;
+
+  ClientTileUnlink(c);
+
+  /* Append to list */
+  if(id)
+    {
+      ClientTiles *l = &tiles[id - 1];
+
+      c->tileprev = l->tail;
+      c->tilenext = NULL;
+
+      if(l->tail) l->tail->tilenext = c;
+      else l->head = c;
+
+      l->tail   = c;
+      c->tileid = id;
+    }
+} /* }}} */
+
+/* ClientTileCheck {{{ */
+static void
+ClientTileCheck(void)
+{
+  int i;
+
+  /* Rebuild lists when screens or gravities changed */
+  if(ntilescreens == subtle->screens->ndata &&
+      ntilegravities == subtle->gravities->ndata)
+    return;
+
+  if(tiles) free(tiles);
+
+  ntilescreens   = subtle->screens->ndata;
+  ntilegravities = subtle->gravities->ndata;
+  tiles          = (ClientTiles *)subSharedMemoryAlloc(
+    MAX(1, ntilescreens * ntilegravities), sizeof(ClientTiles));
+
+  for(i = 0; i < subtle->clients->ndata; i++)
+    {
+      SubClient *c = CLIENT(subtle->clients->data[i]);
+
+      c->tileprev = c->tilenext = NULL;
+      c->tileid   = 0;
+
+      ClientTileLink(c);
+    }
+
+  subSubtleLogDebugSubtle("TileCheck: screens=%d, gravities=%d\n",
+    ntilescreens, ntilegravities);
+} /* }}} */
+
 /* ClientTile {{{ */
 static void
 ClientTile(int gravity,
   int screen)
 {
-  int i, used = 0, pos = 0, calc = 0, fix = 0;
+  int used = 0, pos = 0, calc = 0, fix = 0;
   XRectangle geom = { 1 };
+  SubClient *c = NULL, *head = NULL;
   SubScreen *s = SCREEN(subArrayGet(subtle->screens, screen));
   SubGravity *g = GRAVITY(subArrayGet(subtle->gravities, gravity));
 
+  if(!s || !g) return;
+
+  ClientTileCheck();
+
+  head = tiles[screen * ntilegravities + gravity].head;
+
   /* Pass 1: Count clients with this gravity */
-  for(i = 0; i < subtle->clients->ndata; i++)
+  for(c = head; c; c = c->tilenext)
     {
-      SubClient *c = CLIENT(subtle->clients->data[i]);
-
       if(c->gravityid == gravity && c->screenid == screen &&
-        subtle->visible_tags & c->tags &&
+        subSharedBitsAny(&subtle->visible_tags, &c->tags) &&
         !(c->flags &(SUB_CLIENT_MODE_FLOAT|SUB_CLIENT_MODE_FULL))) used++;
     }
 
-  if(0 == used || !s || !g) return;
+  if(0 == used) return;
 
   /* Calculate tiled gravity value and rounding fix */
   subGravityGeometry(g, &(s->geom), &geom);
@@ -204,12 +349,10 @@ ClientTile(int gravity,
     }
 
   /* Pass 2: Update geometry of every client with this gravity */
-  for(i = 0; i < subtle->clients->ndata; i++)
+  for(c = head; c; c = c->tilenext)
     {
-      SubClient *c = CLIENT(subtle->clients->data[i]);
-
       if(c->gravityid == gravity && c->screenid == screen &&
-          subtle->visible_tags & c->tags &&
+          subSharedBitsAny(&subtle->visible_tags, &c->tags) &&
           !(c->flags & (SUB_CLIENT_MODE_FLOAT|SUB_CLIENT_MODE_FULL)))
         {
           if(g->flags & SUB_GRAVITY_HORZ)
@@ -269,66 +412,264 @@ ClientZaphod(SubClient *c,
     }
 } /* }}} */
 
-/* ClientCompare {{{ */
+/* ClientNormalHints {{{ */
 static int
-ClientCompare(const void *a,
-  const void *b)
+ClientNormalHints(SubClient *c,
+  XSizeHints *hints)
 {
-  int ret = 0, dirret = 0;
-  SubClient *c1 = *(SubClient **)a, *c2 = *(SubClient **)b;
+  unsigned long size = 0;
+  long *prop = NULL;
+
+  /* Decode like XGetWMNormalHints to allow prefetching */
+  if(!(prop = (long *)subSharedPropertyGet(subtle->dpy, c->win,
+      XA_WM_SIZE_HINTS, XA_WM_NORMAL_HINTS, &size)))
+    return False;
+
+  /* Check for pre-ICCCM hints at least */
+  if(15 > size)
+    {
+      XFree(prop);
+
+      return False;
+    }
+
+  hints->flags        = prop[0];
+  hints->x            = prop[1];
+  hints->y            = prop[2];
+  hints->width        = prop[3];
+  hints->height       = prop[4];
+  hints->min_width    = prop[5];
+  hints->min_height   = prop[6];
+  hints->max_width    = prop[7];
+  hints->max_height   = prop[8];
+  hints->width_inc    = prop[9];
+  hints->height_inc   = prop[10];
+  hints->min_aspect.x = prop[11];
+  hints->min_aspect.y = prop[12];
+  hints->max_aspect.x = prop[13];
+  hints->max_aspect.y = prop[14];
+
+  /* ICCCM hints */
+  if(18 <= size)
+    {
+      hints->base_width  = prop[15];
+      hints->base_height = prop[16];
+      hints->win_gravity = prop[17];
+    }
+  else hints->flags &= ~(PBaseSize|PWinGravity);
 
-  assert(a && b);
+  XFree(prop);
 
-  /* Direction is required when we change stacking on a level */
-  if(SUB_CLIENT_RESTACK_DOWN      == c1->dir) dirret = -1;
-  else if(SUB_CLIENT_RESTACK_UP   == c1->dir) dirret = 1;
-  else if(SUB_CLIENT_RESTACK_DOWN == c2->dir) dirret = 1;
-  else if(SUB_CLIENT_RESTACK_UP   == c2->dir) dirret = -1;
+  return True;
+} /* }}} */
 
-  /* Complicated comparisons to ensure stacking order. Our desired
-   * order is following: desktop < gravity < float < full
-   *
-   * This function returns following values:
-   * -1 => c1 is on a lower level
-   *  0 => c1 and c2 are on the same level
-   *  1 => c1 is on a higher level */
-  if(c1->flags & SUB_CLIENT_TYPE_DESKTOP)
+/* ClientSettle {{{ */
+static void
+ClientSettle(SubClient *c,
+  int screenid)
+{
+  /* Keep screen for tiling lists */
+  if(-1 != screenid && c->screenid != screenid)
     {
-      if(c2->flags & SUB_CLIENT_TYPE_DESKTOP) ret = dirret;
-      else ret = 0;
+      c->screenid = screenid;
+
+      ClientTileCheck();
+      ClientTileLink(c);
     }
-  else if(c1->flags & SUB_CLIENT_MODE_FULL)
+
+  c->flags &= ~SUB_CLIENT_ARRANGE; ///< Stay put until toggled or moved
+} /* }}} */
+
+/* ClientLayer {{{ */
+static int
+ClientLayer(SubClient *c)
+{
+  /* Our stacking layers are: desktop < gravity < float < full */
+  if(c->flags & SUB_CLIENT_TYPE_DESKTOP)    return 0;
+  else if(c->flags & SUB_CLIENT_MODE_FULL)  return 3;
+  else if(c->flags & SUB_CLIENT_MODE_FLOAT) return 2;
+
+  return 1;
+} /* }}} */
+
+/* ClientMatch {{{ */
+static int
+ClientMatch(int direction,
+  XRectangle *origin,
+  XRectangle *test)
+{
+  int cx_origin = 0, cx_test = 0, cy_origin = 0, cy_test = 0, dx = 0, dy = 0;
+
+  /* This check is complicated and consists of three parts:
+   * 1) Calculate window center positions
+   * 2) Check if x/y values decrease in given direction
+   * 3) Check if a corner of one of the rects is close enough to
+   *    a side of the other rect */
+
+  /* Calculate window centers */
+  cx_origin = origin->x + (origin->width / 2);
+  cx_test   = test->x + (test->width / 2);
+
+  cy_origin = origin->y + (origin->height / 2);
+  cy_test   = test->y + (test->height / 2);
+
+  /* Check geometries */
+  if((((SUB_GRAB_DIRECTION_LEFT  == direction && cx_test   <= cx_origin)                  ||
+       (SUB_GRAB_DIRECTION_RIGHT == direction && cx_test   >= cx_origin))                 &&
+       ((cy_test                 >= origin->y && cy_test   <= origin->y + origin->height) ||
+       (cy_origin                >= test->y   && cy_origin <= test->y   + test->height))) ||
+
+     (((SUB_GRAB_DIRECTION_UP    == direction && cy_test   <= cy_origin)                  ||
+       (SUB_GRAB_DIRECTION_DOWN  == direction && cy_test   >= cy_origin))                 &&
+       ((cx_test                 >= origin->x && cx_test   <= origin->x + origin->width)  ||
+       (cx_origin                >= test->x   && cx_origin <= test->x   + test->width))))
     {
-      if(c2->flags & SUB_CLIENT_MODE_FULL) ret = dirret;
-      else ret = 1;
+      /* Euclidean distance */
+      dx = abs(cx_origin - cx_test);
+      dy = abs(cy_origin - cy_test);
     }
-  else if(c1->flags & SUB_CLIENT_MODE_FLOAT)
+
+  /* Zero distance means same dimensions or no match at all */
+  return 0 == dx && 0 == dy ? -1 : dx + dy;
+} /* }}} */
+
+/* ClientCellCompare {{{ */
+static int
+ClientCellCompare(const void *a,
+  const void *b)
+{
+  ClientCell *c1 = (ClientCell *)a, *c2 = (ClientCell *)b;
+
+  return c1->distance - c2->distance;
+} /* }}} */
+
+/* ClientNeighbour {{{ */
+static SubClient *
+ClientNeighbour(SubClient *c,
+  int direction,
+  int history)
+{
+  int i, j, ncells = 0, best = (1L << 30), beststack = -1, slack = 0;
+  int cx = c->geom.x + c->geom.width / 2, cy = c->geom.y + c->geom.height / 2;
+  SubClient *found = NULL;
+  ClientCell *cells = (ClientCell *)subSharedMemoryAlloc(
+    subtle->screens->ndata * INDEXCELLS, sizeof(ClientCell));
+
+  /* Largest bonus a client can get for stack position and focus history */
+  slack = subtle->clients->ndata + (history ? HISTORYSIZE : 0);
+
+  /* Collect cells with client centers in given direction */
+  for(i = 0; i < subtle->screens->ndata; i++)
     {
-      if(c2->flags & SUB_CLIENT_MODE_FULL) ret = -1;
-      else if(c2->flags & SUB_CLIENT_MODE_FLOAT) ret = dirret;
-      else ret = 1;
+      SubIndex *idx = SCREEN(subtle->screens->data[i])->index;
+
+      for(j = 0; idx && j < INDEXCELLS; j++)
+        {
+          XRectangle *b = &idx->bounds[j];
+          int dx = 0, dy = 0;
+
+          if(idx->cells[j] == idx->cells[j + 1]) continue;
+
+          /* Skip cells behind the origin */
+          if((SUB_GRAB_DIRECTION_LEFT  == direction && b->x > cx) ||
+              (SUB_GRAB_DIRECTION_RIGHT == direction && b->x + b->width < cx) ||
+              (SUB_GRAB_DIRECTION_UP    == direction && b->y > cy) ||
+              (SUB_GRAB_DIRECTION_DOWN  == direction && b->y + b->height < cy))
+            continue;
+
+          /* Distance to the nearest possible center in this cell */
+          if(cx < b->x)                 dx = b->x - cx;
+          else if(cx > b->x + b->width) dx = cx - b->x - b->width;
+          if(cy < b->y)                 dy = b->y - cy;
+          else if(cy > b->y + b->height) dy = cy - b->y - b->height;
+
+          cells[ncells].distance = dx + dy;
+          cells[ncells].index    = idx;
+          cells[ncells].id       = j;
+          ncells++;
+        }
     }
-  else
+
+  qsort(cells, ncells, sizeof(ClientCell), ClientCellCompare);
+
+  /* Visit nearest cells first until no client can beat the best match */
+  for(i = 0; i < ncells && cells[i].distance - slack <= best; i++)
     {
-      if(c2->flags & SUB_CLIENT_TYPE_DESKTOP) ret = 1;
-      else if(c2->flags & (SUB_CLIENT_MODE_FLOAT|
-          SUB_CLIENT_MODE_FULL)) ret = -1;
-      else ret = dirret;
+      SubIndex *idx = cells[i].index;
+
+      for(j = idx->cells[cells[i].id]; j < idx->cells[cells[i].id + 1]; j++)
+        {
+          int k, stack = idx->stack[j], distance = 0;
+          SubClient *n = CLIENT(subtle->clients->data[stack]);
+
+          if(c == n || -1 == (distance = ClientMatch(direction,
+              &c->geom, &n->geom)))
+            continue;
+
+          /* Substract stack position index to get top window */
+          distance -= stack;
+
+          /* Substract history stack position index */
+          for(k = 1; history && k < HISTORYSIZE; k++)
+            {
+              if(subtle->windows.focus[k] == n->win)
+                {
+                  distance -= (HISTORYSIZE - k);
+                  break;
+                }
+            }
+
+          /* Finally compare distance; lower stack wins on a tie */
+          if(best > distance || (best == distance && beststack > stack))
+            {
+              best      = distance;
+              beststack = stack;
+              found     = n;
+            }
+        }
     }
 
-  return ret;
+  free(cells);
+
+  return found;
 } /* }}} */
 
 /* Public */
 
+ /** subClientPrefetch {{{
+  * @brief Queue property requests of client windows
+  * @param[in]  wins   Window list
+  * @param[in]  nwins  Number of windows
+  **/
+
+void
+subClientPrefetch(Window *wins,
+  int nwins)
+{
+  Atom props[] = {
+    XA_WM_CLASS, subEwmhGet(SUB_EWMH_NET_WM_NAME), XA_WM_NAME,
+    subEwmhGet(SUB_EWMH_WM_WINDOW_ROLE), subEwmhGet(SUB_EWMH_WM_PROTOCOLS),
+    subEwmhGet(SUB_EWMH_NET_WM_STRUT), subEwmhGet(SUB_EWMH_NET_WM_WINDOW_TYPE),
+    XA_WM_NORMAL_HINTS, XA_WM_HINTS, subEwmhGet(SUB_EWMH_NET_WM_STATE),
+    XA_WM_TRANSIENT_FOR, subEwmhGet(SUB_EWMH_MOTIF_WM_HINTS),
+    subEwmhGet(SUB_EWMH_WM_CLIENT_LEADER)
+  };
+
+  assert(wins);
+
+  subSharedPropertyPrefetch(subtle->dpy, wins, nwins, props, LENGTH(props));
+} /* }}} */
+
  /** subClientNew {{{
   * @brief Create new client
-  * @param[in]  win  Client window
+  * @param[in]  win     Client window
+  * @param[in]  wattrs  Attributes of a prefetched window or \p NULL
   * @return Returns a new #SubClient or \p NULL
   **/
 
 SubClient *
-subClientNew(Window win)
+subClientNew(Window win,
+  XWindowAttributes *wattrs)
 {
   int i, grav = 0, flags = 0;
   long vid = 0, extents[4] = { 0 };
@@ -339,16 +680,28 @@ subClientNew(Window win)
 
   assert(win);
 
+  /* Queue property requests, replies arrive with the attributes */
+  if(wattrs) attrs = *wattrs;
+  else
+    {
+      subClientPrefetch(&win, 1);
+      XGetWindowAttributes(subtle->dpy, win, &attrs);
+    }
+
   /* Check override_redirect */
-  XGetWindowAttributes(subtle->dpy, win, &attrs);
-  if(True == attrs.override_redirect) return NULL;
+  if(True == attrs.override_redirect)
+    {
+      if(!wattrs) subSharedPropertyRelease(subtle->dpy);
+
+      return NULL;
+    }
 
   /* Create new client */
   c = CLIENT(subSharedMemoryAlloc(1, sizeof(SubClient)));
   c->gravities = (int *)subSharedMemoryAlloc(subtle->views->ndata, sizeof(int));
   c->flags     = (SUB_TYPE_CLIENT|SUB_CLIENT_INPUT);
   c->gravityid = -1; ///< Force update
-  c->dir       = -1;
+  c->mapstate  = -1; ///< Force update
   c->win       = win;
 
   /* Window attributes */
@@ -402,6 +755,8 @@ subClientNew(Window win)
       free(leader);
     }
 
+  if(!wattrs) subSharedPropertyRelease(subtle->dpy);
+
   /* EWMH: Gravity, screen, desktop, extents */
   subEwmhSetCardinals(c->win, SUB_EWMH_SUBTLE_CLIENT_GRAVITY,
     (long *)&subtle->gravity, 1);
@@ -500,8 +855,8 @@ subClientFocus(SubClient *c,
   /* Remove urgent after getting focus */
   if(c->flags & SUB_CLIENT_MODE_URGENT)
     {
-      c->flags            &= ~SUB_CLIENT_MODE_URGENT;
-      subtle->urgent_tags &= ~c->tags;
+      c->flags &= ~SUB_CLIENT_MODE_URGENT;
+      subSharedBitsAndNot(&subtle->urgent_tags, &c->tags);
     }
 
   /* Unset current focus */
@@ -561,8 +916,7 @@ subClientFocus(SubClient *c,
   if(warp && !(subtle->flags & SUB_SUBTLE_SKIP_WARP)) subClientWarp(c);
 
   /* Update screen */
-  subScreenUpdate();
-  subScreenRender();
+  subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
 } /* }}} */
 
  /** subClientNext {{{
@@ -637,6 +991,172 @@ subClientWarp(SubClient *c)
   subSubtleLogDebugSubtle("Warp\n");
 } /* }}} */
 
+ /** subClientIndex {{{
+  * @brief Rebuild client index of screens
+  **/
+
+void
+subClientIndex(void)
+{
+  int i, j, *where = NULL;
+
+  /* Check if anything moved */
+  if(!(subtle->flags & SUB_SUBTLE_INDEX)) return;
+
+  subtle->flags &= ~SUB_SUBTLE_INDEX;
+  where = (int *)subSharedMemoryAlloc(MAX(1, subtle->clients->ndata),
+    sizeof(int));
+
+  /* Reset indices */
+  for(i = 0; i < subtle->screens->ndata; i++)
+    {
+      SubScreen *s = SCREEN(subtle->screens->data[i]);
+
+      if(!s->index)
+        s->index = (SubIndex *)subSharedMemoryAlloc(1, sizeof(SubIndex));
+
+      memset(s->index->cells, 0, sizeof(s->index->cells));
+    }
+
+  /* Pass 1: Count visible clients per cell of the screen with their center */
+  for(i = 0; i < subtle->clients->ndata; i++)
+    {
+      SubClient *c = CLIENT(subtle->clients->data[i]);
+
+      where[i] = -1;
+
+      if(ALIVE(c) && (subSharedBitsAny(&subtle->visible_tags, &c->tags) ||
+          c->flags & SUB_CLIENT_MODE_STICK))
+        {
+          int sid = 0, col = 0, row = 0;
+          int cx = c->geom.x + c->geom.width / 2;
+          int cy = c->geom.y + c->geom.height / 2;
+          SubScreen *s = subScreenFind(cx, cy, &sid);
+
+          col = (cx - s->geom.x) * INDEXSIZE / MAX(1, s->geom.width);
+          row = (cy - s->geom.y) * INDEXSIZE / MAX(1, s->geom.height);
+
+          where[i] = sid * INDEXCELLS + MINMAX(row, 0, INDEXSIZE - 1) *
+            INDEXSIZE + MINMAX(col, 0, INDEXSIZE - 1);
+
+          s->index->cells[where[i] % INDEXCELLS]++;
+        }
+    }
+
+  /* Pass 2: Turn counts into cell end offsets */
+  for(i = 0; i < subtle->screens->ndata; i++)
+    {
+      SubIndex *idx = SCREEN(subtle->screens->data[i])->index;
+
+      for(j = 0; j < INDEXCELLS; j++)
+        idx->cells[j] += 0 < j ? idx->cells[j - 1] : 0;
+
+      idx->nstack            = idx->cells[INDEXCELLS - 1];
+      idx->cells[INDEXCELLS] = idx->nstack;
+      idx->stack             = (int *)subSharedMemoryRealloc(idx->stack,
+        MAX(1, idx->nstack) * sizeof(int));
+    }
+
+  /* Pass 3: Fill backwards, this leaves offsets at cell starts */
+  for(i = subtle->clients->ndata - 1; 0 <= i; i--)
+    {
+      if(-1 != where[i])
+        {
+          SubIndex *idx = SCREEN(subtle->screens->data[
+            where[i] / INDEXCELLS])->index;
+
+          idx->stack[--idx->cells[where[i] % INDEXCELLS]] = i;
+        }
+    }
+
+  /* Pass 4: Store bounds of client centers per cell */
+  for(i = 0; i < subtle->screens->ndata; i++)
+    {
+      SubIndex *idx = SCREEN(subtle->screens->data[i])->index;
+
+      for(j = 0; j < INDEXCELLS; j++)
+        {
+          int k, x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+
+          for(k = idx->cells[j]; k < idx->cells[j + 1]; k++)
+            {
+              SubClient *c = CLIENT(subtle->clients->data[idx->stack[k]]);
+              int cx = c->geom.x + c->geom.width / 2;
+              int cy = c->geom.y + c->geom.height / 2;
+
+              if(k == idx->cells[j] || cx < x1) x1 = cx;
+              if(k == idx->cells[j] || cy < y1) y1 = cy;
+              if(k == idx->cells[j] || cx > x2) x2 = cx;
+              if(k == idx->cells[j] || cy > y2) y2 = cy;
+            }
+
+          idx->bounds[j].x      = x1;
+          idx->bounds[j].y      = y1;
+          idx->bounds[j].width  = x2 - x1;
+          idx->bounds[j].height = y2 - y1;
+        }
+    }
+
+  free(where);
+
+  subSubtleLogDebugSubtle("Index: clients=%d, screens=%d\n",
+    subtle->clients->ndata, subtle->screens->ndata);
+} /* }}} */
+
+ /** subClientNeighbour {{{
+  * @brief Find nearest client in direction
+  * @param[in]  c          A #SubClient
+  * @param[in]  direction  Grab direction
+  * @param[in]  history    Prefer clients from focus history and fall
+  *                        back to the topmost window
+  * @return Returns a #SubClient or \p NULL
+  **/
+
+SubClient *
+subClientNeighbour(SubClient *c,
+  int direction,
+  int history)
+{
+  int i, j, best = -1;
+  SubClient *found = NULL;
+
+  assert(c);
+
+  subClientIndex(); ///< Rebuild when necessary
+
+  if((found = ClientNeighbour(c, direction, history)) || !history)
+    return found;
+
+  /* Select topmost visible client when nothing is in that direction */
+  for(i = 0; i < subtle->clients->ndata; i++)
+    {
+      SubClient *k = CLIENT(subtle->clients->data[i]);
+      int stack = i;
+
+      if(c == k || !(subSharedBitsAny(&subtle->visible_tags, &k->tags) ||
+          k->flags & SUB_CLIENT_MODE_STICK))
+        continue;
+
+      /* Add history stack position index */
+      for(j = 1; j < HISTORYSIZE; j++)
+        {
+          if(subtle->windows.focus[j] == k->win)
+            {
+              stack += (HISTORYSIZE - j);
+              break;
+            }
+        }
+
+      if(best < stack)
+        {
+          best  = stack;
+          found = k;
+        }
+    }
+
+  return found;
+} /* }}} */
+
  /** subClientDrag {{{
   * @brief Move and/or drag client
   * @param[in]  c          A #SubClient
@@ -653,7 +1173,9 @@ subClientDrag(SubClient *c,
   Window root = None, win = None;
   unsigned int mask = 0;
   int loop = True, edge = 0, fx = 0, fy = 0, dx = 0, dy = 0;
-  int wx = 0, wy = 0, ww = 0, wh = 0, rx = 0, ry = 0;
+  int wx = 0, wy = 0, ww = 0, wh = 0, rx = 0, ry = 0, interval = 0;
+  int opaque = (subtle->flags & SUB_SUBTLE_OPAQUE), pending = False;
+  Time last = 0;
   SubScreen *s = NULL;
   XRectangle geom = { 0 };
   Cursor cursor;
@@ -671,6 +1193,9 @@ subClientDrag(SubClient *c,
   /* Set max width/height */
   s = SCREEN(subtle->screens->data[c->screenid]);
 
+  /* Limit configures to screen refresh */
+  interval = 1000 / MAX(1, s->refresh);
+
   /* Set variables according to mode */
   switch(mode)
     {
@@ -708,10 +1233,10 @@ subClientDrag(SubClient *c,
         break;
     } /* }}} */
 
-  /* Grab pointer server */
+  /* Grab pointer and server for frame drawing */
   XGrabPointer(subtle->dpy, c->win, True, GRABMASK, GrabModeAsync,
     GrabModeAsync, None, cursor, CurrentTime);
-  XGrabServer(subtle->dpy);
+  if(!opaque) XGrabServer(subtle->dpy);
 
   switch(direction)
     {
@@ -754,12 +1279,23 @@ subClientDrag(SubClient *c,
         ClientBounds(c, &(s->geom), &c->geom, False, False);
         break; /* }}}*/
       default: /* {{{ */
-        ClientMask(&geom);
+        if(!opaque) ClientMask(&geom);
 
         /* Start event loop */
         while(loop)
           {
-            XMaskEvent(subtle->dpy, DRAGMASK, &ev);
+            /* Apply throttled position before waiting for more events */
+            if(!XCheckMaskEvent(subtle->dpy, DRAGMASK, &ev))
+              {
+                if(pending)
+                  {
+                    ClientFrame(c, &geom);
+                    pending = False;
+                  }
+
+                XMaskEvent(subtle->dpy, DRAGMASK, &ev);
+              }
+
             switch(ev.type)
               {
                 case EnterNotify:   win = ev.xcrossing.window; break; ///< Find destination window
@@ -769,12 +1305,26 @@ subClientDrag(SubClient *c,
                 case MotionNotify: /* {{{ */
                   if(mode & (SUB_DRAG_MOVE|SUB_DRAG_RESIZE))
                     {
+                      /* Skip to latest motion, but never past a release */
+                      if(opaque)
+                        {
+                          int release = False;
+                          XEvent next;
+
+                          while(XCheckIfEvent(subtle->dpy, &next, ClientMotion,
+                              (XPointer)&release))
+                            {
+                              ev      = next;
+                              release = False; ///< Scan starts over
+                            }
+                        }
+
                       /* Check values */
                       if(!XYINRECT(ev.xmotion.x_root - dx,
                           ev.xmotion.y_root - dy, s->geom))
                         continue;
 
-                      ClientMask(&geom);
+                      if(!opaque) ClientMask(&geom);
 
                       /* Calculate selection rect */
                       switch(mode)
@@ -814,22 +1364,28 @@ subClientDrag(SubClient *c,
                             break; /* }}} */
                         }
 
-                      ClientMask(&geom);
+                      if(!opaque) ClientMask(&geom);
+                      else if(ev.xmotion.time - last >= interval)
+                        {
+                          /* Configure at most once per frame */
+                          last    = ev.xmotion.time;
+                          pending = False;
+
+                          ClientFrame(c, &geom);
+                        }
+                      else pending = True;
                     }
                   break; /* }}} */
               }
           }
 
-        ClientMask(&geom); ///< Erase mask
+        if(!opaque) ClientMask(&geom); ///< Erase mask
 
-        /* Subtract border width */
-        if(!(c->flags & SUB_CLIENT_MODE_BORDERLESS))
-          {
-            geom.x -= subtle->styles.clients.border.top;
-            geom.y -= subtle->styles.clients.border.top;
-          } /* }}} */
+        ClientBorder(c, &geom); /* }}} */
 
         c->geom = geom;
+
+        subtle->flags |= SUB_SUBTLE_INDEX;
     }
 
   XMoveResizeWindow(subtle->dpy, c->win, c->geom.x, c->geom.y,
@@ -837,7 +1393,7 @@ subClientDrag(SubClient *c,
 
   /* Remove grabs */
   XUngrabPointer(subtle->dpy, CurrentTime);
-  XUngrabServer(subtle->dpy);
+  if(!opaque) XUngrabServer(subtle->dpy);
 } /* }}} */
 
  /** subClientTag {{{
@@ -865,7 +1421,7 @@ subClientTag(SubClient *c,
 
       /* Collect flags and tags */
       *flags  |= (t->flags & (TYPES_ALL|MODES_ALL));
-      c->tags |= (1L << (tag + 1));
+      subSharedBitsSet(&c->tags, tag + 1);
 
       /* Set size/position and enable float */
       if(t->flags & (SUB_TAG_GEOMETRY|SUB_TAG_POSITION))
@@ -887,6 +1443,9 @@ subClientTag(SubClient *c,
         {
           c->flags    |= SUB_CLIENT_MODE_STICK_SCREEN;
           c->screenid  = t->screenid;
+
+          ClientTileCheck();
+          ClientTileLink(c);
         }
 
       /* Set gravity matching views */
@@ -895,13 +1454,14 @@ subClientTag(SubClient *c,
           SubView *v = VIEW(subtle->views->data[i]);
 
           /* Match views with this tag or sticky only */
-          if(v->tags & (1L << (tag + 1)) || t->flags & SUB_CLIENT_MODE_STICK)
+          if(subSharedBitsTest(&v->tags, tag + 1) ||
+              t->flags & SUB_CLIENT_MODE_STICK)
             if(t->flags & SUB_TAG_GRAVITY) c->gravities[i] = t->gravityid;
         }
 
       /* Call proc if any */
       if(t->flags & SUB_TAG_PROC)
-        subRubyCall(SUB_CALL_HOOKS, t->proc, (void *)c);
+        subRubyCall(SUB_CALL_HOOKS, t->proc, (void *)c, NULL);
     }
 } /* }}} */
 
@@ -916,19 +1476,18 @@ subClientRetag(SubClient *c,
   int *flags)
 {
   int i;
+  TAGS tags;
 
   DEAD(c);
   assert(c);
 
-  c->tags = 0; ///< Reset tags
+  subSharedBitsClear(&c->tags); ///< Reset tags
+
+  /* Check matching tags in one pass */
+  tags = subTagMatcherTags(c);
 
-  /* Check matching tags */
   for(i = 0; i < subtle->tags->ndata; i++)
-    {
-      /* Check if tag matches client */
-      if(subTagMatcherCheck(TAG(subtle->tags->data[i]), c))
-        subClientTag(c, i, flags);
-    }
+    if(subSharedBitsTest(&tags, i + 1)) subClientTag(c, i, flags);
 
   /* Check if client is visible on at least one screen w/o stick */
   if(!(c->flags & SUB_CLIENT_MODE_STICK) && !(*flags & SUB_CLIENT_MODE_STICK))
@@ -937,7 +1496,7 @@ subClientRetag(SubClient *c,
 
       for(i = 0; i < subtle->views->ndata; i++)
         {
-          if(VIEW(subtle->views->data[i])->tags & c->tags)
+          if(subSharedBitsAny(&VIEW(subtle->views->data[i])->tags, &c->tags))
             {
               visible++;
               break;
@@ -948,7 +1507,7 @@ subClientRetag(SubClient *c,
     }
 
   /* EWMH: Tags */
-  subEwmhSetCardinals(c->win, SUB_EWMH_SUBTLE_CLIENT_TAGS, (long *)&c->tags, 1);
+  subEwmhSetTags(c->win, SUB_EWMH_SUBTLE_CLIENT_TAGS, &c->tags);
 } /* }}} */
 
  /** subClientResize {{{
@@ -966,6 +1525,8 @@ subClientResize(SubClient *c,
   DEAD(c);
   assert(c);
 
+  subtle->flags |= SUB_SUBTLE_INDEX; ///< Geometry may change
+
   /* Honor size hints */
   if(size_hints) ClientBounds(c, bounds, &c->geom, False, False);
 
@@ -1006,7 +1567,7 @@ subClientResize(SubClient *c,
 } /* }}} */
 
  /** subClientRestack {{{
-  * @brief Restack client
+  * @brief Restack client to top or bottom of its layer
   * @param[in]  c    A #SubClient
   * @param[in]  dir  Either below or above
   **/
@@ -1015,17 +1576,51 @@ void
 subClientRestack(SubClient *c,
   int dir)
 {
-  c->dir = dir;
-  subArraySort(subtle->clients, ClientCompare);
-  c->dir = -1;
+  int i, pos = 0, layer = ClientLayer(c);
+  XWindowChanges wc;
+
+  /* Skip clients that aren't managed yet */
+  if(-1 == (i = subArrayIndex(subtle->clients, (void *)c))) return;
 
-  subClientPublish(True);
+  subArrayRemoveAt(subtle->clients, i);
 
-  subSubtleLogDebugSubtle("Restack: instance=%s, win=%#lx, dir=%s\n",
-    c->instance, c->win, SUB_CLIENT_RESTACK_DOWN == dir ? "down" : "up");
+  /* Find top or bottom of layer; clients are sorted from bottom to top */
+  if(SUB_CLIENT_RESTACK_UP == dir)
+    {
+      for(pos = subtle->clients->ndata; 0 < pos &&
+        ClientLayer(CLIENT(subtle->clients->data[pos - 1])) > layer; pos--);
+    }
+  else
+    {
+      for(pos = 0; pos < subtle->clients->ndata &&
+        ClientLayer(CLIENT(subtle->clients->data[pos])) < layer; pos++);
+    }
+
+  subArrayInsert(subtle->clients, pos, (void *)c);
+
+  /* Restack window relative to one of its new neighbours */
+  if(pos + 1 < subtle->clients->ndata)
+    {
+      wc.sibling    = CLIENT(subtle->clients->data[pos + 1])->win;
+      wc.stack_mode = Below;
+
+      XConfigureWindow(subtle->dpy, c->win, CWSibling|CWStackMode, &wc);
+    }
+  else if(0 < pos)
+    {
+      wc.sibling    = CLIENT(subtle->clients->data[pos - 1])->win;
+      wc.stack_mode = Above;
+
+      XConfigureWindow(subtle->dpy, c->win, CWSibling|CWStackMode, &wc);
+    }
+
+  subClientPublish(False);
+
+  subSubtleLogDebugSubtle("Restack: instance=%s, win=%#lx, dir=%s, pos=%d\n",
+    c->instance, c->win, SUB_CLIENT_RESTACK_DOWN == dir ? "down" : "up", pos);
 } /* }}} */
 
-  /** subClientArrange {{{
+ /** subClientArrange {{{
    * @brief Arrange position of client
    * @param[in]  c        A #SubClient
    * @param[in]  gravity  The gravity id
@@ -1042,19 +1637,25 @@ subClientArrange(SubClient *c,
   DEAD(c);
   assert(c && s);
 
+  subtle->flags |= SUB_SUBTLE_INDEX; ///< Geometry may change
+
   /* Check flags */
   if(c->flags & SUB_CLIENT_MODE_FULL)
     {
-      /* Use all screens when in zaphod mode */
-      if(c->flags & SUB_CLIENT_MODE_ZAPHOD)
+      if(c->flags & SUB_CLIENT_ARRANGE || (-1 != screenid && c->screenid != screenid))
         {
-          XMoveResizeWindow(subtle->dpy, c->win, 0, 0,
-            subtle->width, subtle->height);
-        }
-      else XMoveResizeWindow(subtle->dpy, c->win, s->base.x, s->base.y,
-        s->base.width, s->base.height);
+          /* Use all screens when in zaphod mode */
+          if(c->flags & SUB_CLIENT_MODE_ZAPHOD)
+            {
+              XMoveResizeWindow(subtle->dpy, c->win, 0, 0,
+                subtle->width, subtle->height);
+            }
+          else XMoveResizeWindow(subtle->dpy, c->win, s->base.x, s->base.y,
+            s->base.width, s->base.height);
 
-      XRaiseWindow(subtle->dpy, c->win);
+          XRaiseWindow(subtle->dpy, c->win);
+          ClientSettle(c, screenid);
+        }
     }
   else if(c->flags & SUB_CLIENT_MODE_FLOAT)
     {
@@ -1071,6 +1672,9 @@ subClientArrange(SubClient *c,
               c->geom.width  = c->geom.width;
               c->geom.height = c->geom.height;
               c->screenid    = screenid;
+
+              ClientTileCheck();
+              ClientTileLink(c);
             }
 
           /* Finally resize window */
@@ -1082,19 +1686,27 @@ subClientArrange(SubClient *c,
     }
   else if(c->flags & SUB_CLIENT_TYPE_DESKTOP)
     {
-      c->geom = s->geom;
+      if(c->flags & SUB_CLIENT_ARRANGE || (-1 != screenid && c->screenid != screenid))
+        {
+          c->geom = s->geom;
 
-      /* Just use screen size for desktop windows */
-      XMoveResizeWindow(subtle->dpy, c->win, c->geom.x, c->geom.y,
-        c->geom.width, c->geom.height);
-      XLowerWindow(subtle->dpy, c->win);
+          /* Just use screen size for desktop windows */
+          XMoveResizeWindow(subtle->dpy, c->win, c->geom.x, c->geom.y,
+            c->geom.width, c->geom.height);
+          XLowerWindow(subtle->dpy, c->win);
+          ClientSettle(c, screenid);
+        }
     }
   else if(c->flags & SUB_CLIENT_TYPE_DOCK)
     {
-      /* Just use screen size for desktop windows */
-      XMoveResizeWindow(subtle->dpy, c->win, c->geom.x, c->geom.y,
-        c->geom.width, c->geom.height);
-      XLowerWindow(subtle->dpy, c->win);
+      if(c->flags & SUB_CLIENT_ARRANGE || (-1 != screenid && c->screenid != screenid))
+        {
+          /* Docks keep their own geometry */
+          XMoveResizeWindow(subtle->dpy, c->win, c->geom.x, c->geom.y,
+            c->geom.width, c->geom.height);
+          XLowerWindow(subtle->dpy, c->win);
+          ClientSettle(c, screenid);
+        }
     }
   else
     {
@@ -1110,6 +1722,9 @@ subClientArrange(SubClient *c,
           if(-1 != gravityid)
             c->gravityid = c->gravities[s->viewid] = gravityid;
 
+          ClientTileCheck();
+          ClientTileLink(c);
+
           g     = GRAVITY(subArrayGet(subtle->gravities, gravityid));
           old_g = GRAVITY(subArrayGet(subtle->gravities, old_gravity));
 
@@ -1135,7 +1750,7 @@ subClientArrange(SubClient *c,
           subEwmhSetCardinals(c->win, SUB_EWMH_SUBTLE_CLIENT_GRAVITY,
             (long *)&c->gravityid, 1);
 
-          XSync(subtle->dpy, False); ///< Sync before going on
+          SYNC(); ///< Sync before going on
 
           /* Hook: Gravity */
           subHookCall((SUB_HOOK_TYPE_CLIENT|SUB_HOOK_ACTION_GRAVITY),
@@ -1156,7 +1771,7 @@ subClientToggle(SubClient *c,
   int flags,
   int set_gravity)
 {
-  int nstates = 0;
+  int nstates = 0, layer = 0;
   Atom states[3] = { None };
 
   DEAD(c);
@@ -1177,7 +1792,7 @@ subClientToggle(SubClient *c,
         {
           /* Update highlight urgent client */
           if(c->flags & SUB_CLIENT_MODE_URGENT)
-            subtle->urgent_tags &= ~c->tags;
+            subSharedBitsAndNot(&subtle->urgent_tags, &c->tags);
         }
       else
         {
@@ -1192,7 +1807,8 @@ subClientToggle(SubClient *c,
                   SubView *v = VIEW(subtle->views->data[i]);
 
                   /* Check visibility manually */
-                  if(!(v->tags & c->tags) && -1 != c->gravityid)
+                  if(!subSharedBitsAny(&v->tags, &c->tags) &&
+                      -1 != c->gravityid)
                     c->gravities[i] = c->gravityid;
                 }
             }
@@ -1206,6 +1822,9 @@ subClientToggle(SubClient *c,
                   CLIENTID))) && VISIBLE(focus))
                 c->screenid = focus->screenid;
               else subScreenCurrent(&c->screenid);
+
+              ClientTileCheck();
+              ClientTileLink(c);
             }
       }
   }
@@ -1253,7 +1872,7 @@ subClientToggle(SubClient *c,
 
   /* Handle urgent mode */
   if(flags & SUB_CLIENT_MODE_URGENT)
-    subtle->urgent_tags |= c->tags;
+    subSharedBitsOr(&subtle->urgent_tags, &c->tags);
 
   /* Handle center mode */
   if(flags & SUB_CLIENT_MODE_CENTER)
@@ -1283,6 +1902,8 @@ subClientToggle(SubClient *c,
     {
       XSetWindowBorderWidth(subtle->dpy, c->win, 0);
 
+      c->flags |= SUB_CLIENT_ARRANGE; ///< Force rearrange
+
       /* Special treatment */
       if(flags & SUB_CLIENT_TYPE_DESKTOP)
         {
@@ -1303,12 +1924,13 @@ subClientToggle(SubClient *c,
     }
 
   /* Finally toggle mode flags only */
+  layer    = ClientLayer(c);
   c->flags = ((c->flags & ~MODES_ALL) |
     ((c->flags & MODES_ALL) ^ (flags & MODES_ALL)));
 
-  /* Sort for keeping stacking order */
-  if(c->flags & (SUB_CLIENT_MODE_FLOAT|SUB_CLIENT_MODE_FULL|
-      SUB_CLIENT_TYPE_DESKTOP|SUB_CLIENT_TYPE_DOCK))
+  /* Move into new layer or keep stacking order */
+  if(layer != ClientLayer(c) || c->flags & (SUB_CLIENT_MODE_FLOAT|
+      SUB_CLIENT_MODE_FULL|SUB_CLIENT_TYPE_DESKTOP|SUB_CLIENT_TYPE_DOCK))
     subClientRestack(c, SUB_CLIENT_RESTACK_UP);
 
   /* EWMH: State and flags */
@@ -1328,7 +1950,7 @@ subClientToggle(SubClient *c,
 
   subEwmhSetCardinals(c->win, SUB_EWMH_SUBTLE_CLIENT_FLAGS, (long *)&flags, 1);
 
-  XSync(subtle->dpy, False); ///< Sync all changes
+  SYNC(); ///< Sync all changes
 
   /* Hook: Mode */
   subHookCall((SUB_HOOK_TYPE_CLIENT|SUB_HOOK_ACTION_MODE), (void *)c);
@@ -1365,9 +1987,12 @@ subClientSetStrut(SubClient *c)
           subtle->styles.subtle.padding.bottom =
             MAX(subtle->styles.subtle.padding.bottom, strut[3]);
 
-          /* Update screen and clients */
-          subScreenResize();
-          subScreenConfigure();
+          /* Update screen and clients, scan does it once afterwards */
+          if(!(subtle->flags & SUB_SUBTLE_SCAN))
+            {
+              subScreenResize();
+              subScreenConfigure();
+            }
         }
 
       XFree(strut);
@@ -1382,13 +2007,15 @@ subClientSetStrut(SubClient *c)
 void
 subClientSetProtocols(SubClient *c)
 {
-  int i, n = 0;
+  int i;
+  unsigned long n = 0;
   Atom *protos = NULL;
 
   assert(c);
 
   /* Window manager protocols */
-  if(XGetWMProtocols(subtle->dpy, c->win, &protos, &n))
+  if((protos = (Atom *)subSharedPropertyGet(subtle->dpy, c->win, XA_ATOM,
+      subEwmhGet(SUB_EWMH_WM_PROTOCOLS), &n)))
     {
       for(i = 0; i < n; i++)
         {
@@ -1414,7 +2041,6 @@ void
 subClientSetSizeHints(SubClient *c,
   int *flags)
 {
-  long supplied = 0;
   XSizeHints *hints = NULL;
   SubScreen *s = NULL;
 
@@ -1443,7 +2069,7 @@ subClientSetSizeHints(SubClient *c,
   c->baseh = 0; /* }}} */
 
   /* Size hints - no idea why it's called normal hints */
-  if(XGetWMNormalHints(subtle->dpy, c->win, hints, &supplied))
+  if(ClientNormalHints(c, hints))
     {
       /* Program min size */
       if(hints->flags & PMinSize)
@@ -1545,37 +2171,47 @@ void
 subClientSetWMHints(SubClient *c,
   int *flags)
 {
-  XWMHints *hints = NULL;
+  unsigned long size = 0;
+  long *hints = NULL;
 
   assert(c && flags);
 
-  /* Window manager hints (ICCCM 4.1.7) */
-  if((hints = XGetWMHints(subtle->dpy, c->win)))
+  /* Window manager hints (ICCCM 4.1.7): flags, input, initial state,
+   * icon pixmap, icon window, icon x, icon y, icon mask, window group */
+  if((hints = (long *)subSharedPropertyGet(subtle->dpy, c->win,
+      XA_WM_HINTS, XA_WM_HINTS, &size)) && 8 > size)
+    {
+      XFree(hints);
+      hints = NULL;
+    }
+
+  if(hints)
     {
       /* Handle urgency hint:
        * Set urgency if window hasn't focus and and
        * remove it after getting focus */
-      if(hints->flags & XUrgencyHint && c->win != subtle->windows.focus[0])
+      if(hints[0] & XUrgencyHint && c->win != subtle->windows.focus[0])
         {
           *flags |= SUB_CLIENT_MODE_URGENT;
         }
 
       /* Handle window group hint */
-      if(hints->flags & WindowGroupHint)
+      if(hints[0] & WindowGroupHint && 9 <= size)
         {
           SubClient *k = NULL;
 
           /* Copy tags and modes */
-          if((k = CLIENT(subSubtleFind(hints->window_group, CLIENTID))))
+          if((k = CLIENT(subSubtleFind(hints[8], CLIENTID))))
             {
               *flags      |= (k->flags & MODES_ALL);
-              c->tags     |= k->tags;
               c->screenid |= k->screenid;
+
+              subSharedBitsOr(&c->tags, &k->tags);
             }
         }
 
       /* Handle just false value of input hint since it is default */
-      if(hints->flags & InputHint && !hints->input)
+      if(hints[0] & InputHint && !hints[1])
         c->flags &= ~SUB_CLIENT_INPUT;
 
       XFree(hints);
@@ -1655,12 +2291,13 @@ void
 subClientSetTransient(SubClient *c,
   int *flags)
 {
-  Window trans = None;
+  Window *trans = NULL;
 
   assert(c && flags);
 
   /* Check for transient windows */
-  if(XGetTransientForHint(subtle->dpy, c->win, &trans))
+  if((trans = (Window *)subSharedPropertyGet(subtle->dpy, c->win, XA_WINDOW,
+      XA_WM_TRANSIENT_FOR, NULL)))
     {
       SubClient *k = NULL;
 
@@ -1669,12 +2306,15 @@ subClientSetTransient(SubClient *c,
         SUB_CLIENT_MODE_FLOAT|SUB_CLIENT_MODE_URGENT : SUB_CLIENT_MODE_FLOAT;
 
       /* Find parent window */
-      if((k = CLIENT(subSubtleFind(trans, CLIENTID))))
+      if((k = CLIENT(subSubtleFind(*trans, CLIENTID))))
         {
           *flags      |= (k->flags & MODES_ALL);
-          c->tags     |= k->tags;
           c->screenid |= k->screenid;
+
+          subSharedBitsOr(&c->tags, &k->tags);
         }
+
+      XFree(trans);
      }
 
   subSubtleLogDebugSubtle("SetTransient\n");
@@ -1767,8 +2407,7 @@ subClientClose(SubClient *c)
       subClientPublish(False);
 
       subScreenConfigure();
-      subScreenUpdate();
-      subScreenRender();
+      subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
 
       /* Update focus if necessary */
       if(-1 != sid)
@@ -1799,14 +2438,19 @@ subClientKill(SubClient *c)
   /* Remove _NET_WM_STATE (see EWMH 1.3) */
   subSharedPropertyDelete(subtle->dpy, c->win,
     subEwmhGet(SUB_EWMH_NET_WM_STATE));
+  subEwmhForget(c->win);
 
   /* Ignore further events and delete context */
   XSelectInput(subtle->dpy, c->win, NoEventMask);
   XDeleteContext(subtle->dpy, c->win, CLIENTID);
 
+  subtle->flags |= SUB_SUBTLE_INDEX; ///< Drop from client index
+
   /* Remove client tags from urgent tags */
   if(c->flags & SUB_CLIENT_MODE_URGENT)
-    subtle->urgent_tags &= ~c->tags;
+    subSharedBitsAndNot(&subtle->urgent_tags, &c->tags);
+
+  ClientTileUnlink(c);
 
   /* Tile remaining clients if necessary */
   if(VISIBLE(c))
@@ -1832,7 +2476,7 @@ subClientKill(SubClient *c)
 
  /** subClientPublish {{{
   * @brief Publish clients
-  * @param[in]  restack  Restack windows
+  * @param[in]  restack  Sort into layers and restack all windows
   **/
 
 void
@@ -1842,6 +2486,26 @@ subClientPublish(int restack)
   Window *wins = (Window *)subSharedMemoryAlloc(subtle->clients->ndata,
     sizeof(Window));
 
+  /* Stable sort into layers, only required after scanning */
+  if(restack && 1 < subtle->clients->ndata)
+    {
+      int layer, j = 0;
+      void **data = (void **)subSharedMemoryAlloc(subtle->clients->ndata,
+        sizeof(void *));
+
+      for(layer = 0; layer < 4; layer++)
+        {
+          for(i = 0; i < subtle->clients->ndata; i++)
+            if(layer == ClientLayer(CLIENT(subtle->clients->data[i])))
+              data[j++] = subtle->clients->data[i];
+        }
+
+      memcpy(subtle->clients->data, data,
+        subtle->clients->ndata * sizeof(void *));
+
+      free(data);
+    }
+
   /* Sort clients from top (=> 0) to bottom */
   for(i = 0; i < subtle->clients->ndata; i++)
     wins[subtle->clients->ndata - 1 - i] = CLIENT(subtle->clients->data[i])->win;
@@ -1855,7 +2519,7 @@ subClientPublish(int restack)
   /* Restack windows? We assembled the array anyway. */
   if(restack) XRestackWindows(subtle->dpy, wins, subtle->clients->ndata);
 
-  XSync(subtle->dpy, False); ///< Sync all changes
+  subtle->flags |= (SUB_SUBTLE_PUBLISH|SUB_SUBTLE_INDEX); ///< Sync once per loop
 
   free(wins);
 
@@ -15,6 +15,23 @@
 #include <locale.h>
 #include "subtle.h"
 
+#ifdef DEBUG
+#define NBATCHES 32                                               ///< Remembered flushes
+
+/* Typedef {{{ */
+typedef struct displaybatch_t
+{
+  unsigned long serial;                                           ///< First serial after flush
+  const char    *file;                                            ///< Flushing file
+  int           line;                                             ///< Flushing line
+} DisplayBatch;
+/* }}} */
+
+/* Globals */
+DisplayBatch batches[NBATCHES];
+unsigned long nbatches = 0, navoided = 0;
+#endif /* DEBUG */
+
 /* DisplayClaim {{{ */
 int
 DisplayClaim(void)
@@ -103,11 +120,32 @@ DisplayXError(Display *disp,
       if(42 != ev->request_code) /* X_SetInputFocus */
         {
           char error[255] = { 0 };
+          unsigned long i, serial = 0;
+          DisplayBatch *b = NULL;
 
           XGetErrorText(disp, ev->error_code, error, sizeof(error));
-          subSubtleLog(SUB_LOG_XERROR, __FILE__, __LINE__,
-            "%s: win=%#lx, request=%d\n",
-            error, ev->resourceid, ev->request_code);
+
+          /* Find flush that sent the failed request */
+          for(i = 0; i < MIN(nbatches, NBATCHES); i++)
+            {
+              if(batches[i].serial > ev->serial &&
+                  (0 == serial || batches[i].serial < serial))
+                {
+                  serial = batches[i].serial;
+                  b      = &batches[i];
+                }
+            }
+
+          if(b)
+            {
+              subSubtleLog(SUB_LOG_XERROR, __FILE__, __LINE__,
+                "%s: win=%#lx, request=%d, serial=%lu, flush=%s:%d\n",
+                error, ev->resourceid, ev->request_code, ev->serial,
+                b->file, b->line);
+            }
+          else subSubtleLog(SUB_LOG_XERROR, __FILE__, __LINE__,
+            "%s: win=%#lx, request=%d, serial=%lu\n",
+            error, ev->resourceid, ev->request_code, ev->serial);
         }
     }
 #endif /* DEBUG */
@@ -129,9 +167,12 @@ subDisplayInit(const char *display)
   XSetWindowAttributes sattrs;
   unsigned long mask = 0;
 
-#if defined HAVE_X11_EXTENSIONS_XINERAMA_H || defined HAVE_X11_EXTENSIONS_XRANDR_H
+#if defined HAVE_X11_EXTENSIONS_XINERAMA_H || \
+    defined HAVE_X11_EXTENSIONS_XRANDR_H || \
+    defined HAVE_X11_EXTENSIONS_XRENDER_H
   int event = 0, junk = 0;
-#endif /* HAVE_X11_EXTENSIONS_XINERAMA_H HAVE_X11_EXTENSIONS_XRANDR_H */
+#endif /* HAVE_X11_EXTENSIONS_XINERAMA_H HAVE_X11_EXTENSIONS_XRANDR_H
+          HAVE_X11_EXTENSIONS_XRENDER_H */
 
   assert(subtle);
 
@@ -223,6 +264,11 @@ subDisplayInit(const char *display)
 #endif /* HAVE_X11_EXTENSIONS_XRANDR_H */
     subtle->flags &= ~SUB_SUBTLE_XRANDR;
 
+#ifdef HAVE_X11_EXTENSIONS_XRENDER_H
+  if(!XRenderQueryExtension(subtle->dpy, &event, &junk))
+#endif /* HAVE_X11_EXTENSIONS_XRENDER_H */
+    subtle->flags &= ~SUB_SUBTLE_XRENDER;
+
   XSync(subtle->dpy, False);
 
   printf("Display (%s) is %dx%d\n", DisplayString(subtle->dpy),
@@ -263,7 +309,7 @@ subDisplayConfigure(void)
   subScreenResize();
   subScreenUpdate();
 
-  XSync(subtle->dpy, False); ///< Sync all changes
+  SYNC(); ///< Sync all changes
 
   subSubtleLogDebugSubtle("Configure\n");
 } /* }}} */
@@ -275,34 +321,70 @@ subDisplayConfigure(void)
 void
 subDisplayScan(void)
 {
-  unsigned int i, nwins = 0;
+  unsigned int i, nwins = 0, nviewable = 0;
   Window wroot = None, parent = None, *wins = NULL;
+  XWindowAttributes *attrs = NULL;
+  void **clients = NULL;
+
+#ifdef DEBUG
+  long long start = subSubtleTime();
+#endif /* DEBUG */
 
   assert(subtle);
 
   /* Scan for client windows */
   XQueryTree(subtle->dpy, ROOT, &wroot, &parent, &wins, &nwins);
 
-  for(i = 0; i < nwins; i++)
+  if(0 < nwins)
     {
-      SubClient *c = NULL;
-      XWindowAttributes attrs;
+      /* Get attributes of all windows in one round trip */
+      attrs = (XWindowAttributes *)subSharedMemoryAlloc(nwins,
+        sizeof(XWindowAttributes));
 
-      XGetWindowAttributes(subtle->dpy, wins[i], &attrs);
-      switch(attrs.map_state)
+      subSharedPropertyAttributes(subtle->dpy, wins, nwins, attrs);
+
+      /* Move candidates to the front */
+      for(i = 0; i < nwins; i++)
         {
-          case IsViewable:
-            if((c = subClientNew(wins[i])))
-              subArrayPush(subtle->clients, (void *)c);
-            break;
+          if(IsViewable == attrs[i].map_state && !attrs[i].override_redirect)
+            {
+              wins[nviewable]  = wins[i];
+              attrs[nviewable] = attrs[i];
+              nviewable++;
+            }
         }
+
+      /* Pipeline property requests of all candidates */
+      subClientPrefetch(wins, nviewable);
+
+      subtle->flags |= SUB_SUBTLE_SCAN;
+
+      /* Create clients and add them at once, failed ones are skipped */
+      clients = (void **)subSharedMemoryAlloc(MAX(1, nviewable),
+        sizeof(void *));
+
+      for(i = 0; i < nviewable; i++)
+        clients[i] = (void *)subClientNew(wins[i], &attrs[i]);
+
+      subArrayPushAll(subtle->clients, clients, nviewable);
+
+      subtle->flags &= ~SUB_SUBTLE_SCAN;
+
+      free(clients);
+
+      subSharedPropertyRelease(subtle->dpy);
+
+      free(attrs);
     }
 
-  XFree(wins);
+  if(wins) XFree(wins);
 
-  subClientPublish(False);
+  /* Update struts once, configure follows in event loop */
+  subScreenResize();
+  subClientPublish(True); ///< Sort scanned clients into layers
 
-  subSubtleLogDebugSubtle("Scan\n");
+  subSubtleLogDebugSubtle("Scan: windows=%d, clients=%d, time=%lldms\n",
+    nwins, subtle->clients->ndata, subSubtleTime() - start);
 } /* }}} */
 
  /** subDisplayPublish {{{
@@ -348,11 +430,39 @@ subDisplayPublish(void)
 
   free(colors);
 
-  XSync(subtle->dpy, False); ///< Sync all changes
+  subtle->flags |= SUB_SUBTLE_PUBLISH; ///< Sync once per loop
 
   subSubtleLogDebugSubtle("Publish: colors=%d\n", NCOLORS);
 } /* }}} */
 
+ /** subDisplaySync {{{
+  * @brief Sync with X server or just flush requests in async mode
+  * @param[in]  file  File name
+  * @param[in]  line  Line number
+  **/
+
+void
+subDisplaySync(const char *file,
+  int line)
+{
+  if(subtle->flags & SUB_SUBTLE_ASYNC)
+    {
+#ifdef DEBUG
+      DisplayBatch *b = &batches[nbatches++ % NBATCHES];
+
+      /* Store serial for error attribution */
+      b->serial = NextRequest(subtle->dpy);
+      b->file   = file;
+      b->line   = line;
+
+      navoided++;
+#endif /* DEBUG */
+
+      XFlush(subtle->dpy);
+    }
+  else XSync(subtle->dpy, False);
+} /* }}} */
+
  /** subDisplayFinish {{{
   * @brief Close connection
   **/
@@ -366,6 +476,17 @@ subDisplayFinish(void)
     {
       XSync(subtle->dpy, False); ///< Sync all changes
 
+#ifdef DEBUG
+      {
+        unsigned long hits = 0, misses = 0;
+
+        subSharedStringStats(&hits, &misses);
+
+        subSubtleLogDebugSubtle("Finish: avoided syncs=%lu, "
+          "extent hits=%lu, misses=%lu\n", navoided, hits, misses);
+      }
+#endif /* DEBUG */
+
       /* Free cursors */
       if(subtle->cursors.arrow)  XFreeCursor(subtle->dpy, subtle->cursors.arrow);
       if(subtle->cursors.move)   XFreeCursor(subtle->dpy, subtle->cursors.move);
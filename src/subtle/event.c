@@ -12,9 +12,15 @@
 
 #include <unistd.h>
 #include <X11/Xatom.h>
-#include <sys/poll.h>
 #include "subtle.h"
 
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#define EVENTS 32                                                 ///< Ready descriptors per wakeup
+#else
+#include <sys/poll.h>
+#endif /* HAVE_SYS_EPOLL_H */
+
 #ifdef HAVE_SYS_INOTIFY_H
 #define BUFLEN (sizeof(struct inotify_event))
 #endif /* HAVE_SYS_INOTIFY_H */
@@ -23,35 +29,104 @@
 #include <X11/extensions/Xrandr.h>
 #endif /* HAVE_X11_EXTENSIONS_XRANDR_H */
 
+/* Typedef {{{ */
+typedef struct eventwatch_t
+{
+  int      slot;                                                  ///< Watch poll slot (index + 1)
+  SubPanel *p;                                                    ///< Watch sublet panel
+} EventWatch;
+/* }}} */
+
 /* Globals */
-struct pollfd *watches = NULL;
+EventWatch *watches = NULL;
 XClientMessageEvent *queue = NULL;
-int nwatches = 0, nqueue = 0;
+SubPanel **timers = NULL;
+int nwatches = 0, nqueue = 0, ntimers = 0;
+unsigned long watchadds = 0, watchdels = 0, wakeups = 0, nready = 0;
+
+#ifdef HAVE_SYS_EPOLL_H
+int epollfd = -1;
+#else
+struct pollfd *pollfds = NULL;
+int npollfds = 0;
+#endif /* HAVE_SYS_EPOLL_H */
 
 /* EventUntag {{{ */
 static void
 EventUntag(SubClient *c,
   int id)
 {
-  int i, tag;
-
   /* Shift bits */
-  for(i = id; i < subtle->tags->ndata - 1; i++)
+  subSharedBitsRemove(&c->tags, id + 1);
+
+  /* EWMH: Tags */
+  subEwmhSetTags(c->win, SUB_EWMH_SUBTLE_CLIENT_TAGS, &c->tags);
+} /* }}} */
+
+/* EventTags {{{ */
+static int
+EventTags(TAGS *tags,
+  XClientMessageEvent *ev,
+  SubIpcData *extra)
+{
+  int nwords = (int)ev->data.l[3];
+
+  /* Messages carry the first word, larger sets come along as extra data */
+  if(1 >= nwords) subSharedBitsUnpack(tags, &ev->data.l[1], 1);
+  else if(extra && BITSWORDS >= nwords &&
+      nwords * (int)sizeof(long) == extra->len)
     {
-      tag = (1L << (i + 1));
+      long words[BITSWORDS] = { 0 };
 
-      if(c->tags & (1L << (i + 2))) ///< Next bit
-        c->tags |= tag;
-      else
-        c->tags &= ~tag;
+      memcpy(words, extra->data, extra->len);
+      subSharedBitsUnpack(tags, words, nwords);
     }
+  else
+    {
+      subSubtleLogWarn("Ignoring tags message with %d words\n", nwords);
 
-  /* EWMH: Tags */
-  if(c->flags & SUB_TYPE_CLIENT)
+      return False;
+    }
+
+  return True;
+} /* }}} */
+
+/* EventTagsDrain {{{ */
+static void
+EventTagsDrain(void)
+{
+  int format = 0;
+  unsigned long i = 0, nitems = 0, bytes = 0;
+  long *records = NULL;
+  Atom rtype = None;
+
+  /* Take and delete all records at once, senders append to it */
+  if(Success != XGetWindowProperty(subtle->dpy, ROOT,
+      subEwmhGet(SUB_EWMH_SUBTLE_TAGS), 0, LONG_MAX, True, XA_CARDINAL,
+      &rtype, &format, &nitems, &bytes, (unsigned char **)&records) ||
+      !records)
+    return;
+
+  /* Hand each record over like a socket message */
+  while(i + 3 <= nitems && 0 < records[i + 2] &&
+      BITSWORDS >= records[i + 2] && i + 3 + records[i + 2] <= nitems)
     {
-      subEwmhSetCardinals(c->win, SUB_EWMH_SUBTLE_CLIENT_TAGS,
-        (long *)&c->tags, 1);
+      SubMessageData data = { { 0, 0, 0, 0, 0 } };
+      SubIpcData extra;
+
+      data.l[0] = records[i + 1];
+      data.l[1] = records[i + 3];
+      data.l[3] = records[i + 2];
+
+      extra.data = (char *)&records[i + 3];
+      extra.len  = (int)records[i + 2] * sizeof(long);
+
+      subEventMessage(ROOT, (Atom)records[i], 32, &data, &extra);
+
+      i += 3 + records[i + 2];
     }
+
+  XFree(records);
 } /* }}} */
 
 /* EventFindSublet {{{ */
@@ -78,6 +153,49 @@ EventFindSublet(int id)
   return NULL;
 } /* }}} */
 
+/* EventTimerSwap {{{ */
+static void
+EventTimerSwap(int a,
+  int b)
+{
+  SubPanel *p = timers[a];
+
+  timers[a] = timers[b];
+  timers[b] = p;
+
+  /* Update heap slots */
+  timers[a]->sublet->timer = a + 1;
+  timers[b]->sublet->timer = b + 1;
+} /* }}} */
+
+/* EventTimerSift {{{ */
+static void
+EventTimerSift(int idx)
+{
+  int child = 0;
+
+  /* Move timer up while it expires before its parent */
+  while(0 < idx && timers[idx]->sublet->time <
+      timers[(idx - 1) / 2]->sublet->time)
+    {
+      EventTimerSwap(idx, (idx - 1) / 2);
+      idx = (idx - 1) / 2;
+    }
+
+  /* Move timer down while a child expires earlier */
+  while((child = 2 * idx + 1) < ntimers)
+    {
+      if(child + 1 < ntimers && timers[child + 1]->sublet->time <
+          timers[child]->sublet->time)
+        child++;
+
+      if(timers[idx]->sublet->time <= timers[child]->sublet->time) break;
+
+      EventTimerSwap(idx, child);
+      idx = child;
+    }
+} /* }}} */
+
 /* EventQueuePush {{{ */
 static void
 EventQueuePush(XClientMessageEvent *ev,
@@ -133,55 +251,6 @@ EventQueuePop(long value,
     }
 } /* }}} */
 
-/* EventMatch {{{ */
-static int
-EventMatch(int type,
-  XRectangle *origin,
-  XRectangle *test)
-{
-  int cx_origin = 0, cx_test = 0, cy_origin = 0, cy_test = 0, dx = 0, dy = 0;
-
-  /* This check is complicated and consists of three parts:
-   * 1) Calculate window center positions
-   * 2) Check if x/y values decrease in given direction
-   * 3) Check if a corner of one of the rects is close enough to
-   *    a side of the other rect */
-
-  /* Calculate window centers */
-  cx_origin = origin->x + (origin->width / 2);
-  cx_test   = test->x + (test->width / 2);
-
-  cy_origin = origin->y + (origin->height / 2);
-  cy_test   = test->y + (test->height / 2);
-
-  /* Check geometries */
-  if((((SUB_GRAB_DIRECTION_LEFT  == type      && cx_test   <= cx_origin)                  ||
-       (SUB_GRAB_DIRECTION_RIGHT == type      && cx_test   >= cx_origin))                 &&
-       ((cy_test                 >= origin->y && cy_test   <= origin->y + origin->height) ||
-       (cy_origin                >= test->y   && cy_origin <= test->y   + test->height))) ||
-
-     (((SUB_GRAB_DIRECTION_UP    == type      && cy_test   <= cy_origin)                  ||
-       (SUB_GRAB_DIRECTION_DOWN  == type      && cy_test   >= cy_origin))                 &&
-       ((cx_test                 >= origin->x && cx_test   <= origin->x + origin->width)  ||
-       (cx_origin                 >= test->x   && cx_origin <= test->x   + test->width))))
-    {
-      /* Euclidean distance */
-      dx = abs(cx_origin - cx_test);
-      dy = abs(cy_origin - cy_test);
-
-      /* Zero distance means same dimensions - highest distance */
-      if(0 == dx && 0 == dy) dx = dy = 1L << 15;
-    }
-  else
-    {
-      /* No match - highest distance too */
-      dx = 1L << 15;
-      dy = 1L << 15;
-    }
-
-  return dx + dy;
-} /* }}} */
-
 /* Events */
 
 /* EventColormap {{{ */
@@ -226,6 +295,7 @@ EventConfigure(XConfigureEvent *ev)
       subScreenInit();
 
       subRubyReloadConfig();
+      subHostInit();
       subScreenResize();
 
       /* Update size */
@@ -352,8 +422,7 @@ EventDestroy(XDestroyWindowEvent *ev)
       subClientPublish(False);
 
       subScreenConfigure();
-      subScreenUpdate();
-      subScreenRender();
+      subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
 
       /* Update focus if necessary */
       if((c = subClientNext(sid, False))) subClientFocus(c, True);
@@ -363,13 +432,13 @@ EventDestroy(XDestroyWindowEvent *ev)
       int focus = (subtle->windows.focus[0] == ev->window); ///< Save
 
       /* Kill tray */
-      subArrayRemove(subtle->trays, (void *)t);
+      subArraySwapRemove(subtle->trays, subArrayIndex(subtle->trays,
+        (void *)t)); ///< Tray order is arbitrary
       subTrayKill(t);
       subTrayUpdate();
       subTrayPublish();
 
-      subScreenUpdate();
-      subScreenRender();
+      subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
 
       /* Update focus if necessary */
       if(focus && (c = subClientNext(0, False))) subClientFocus(c, True);
@@ -395,7 +464,7 @@ EventDestroy(XDestroyWindowEvent *ev)
 static void
 EventExpose(XExposeEvent *ev)
 {
-  if(0 == ev->count) subScreenRender(); ///< Render once
+  if(0 == ev->count) subScreenDirty(NULL, SUB_SCREEN_RENDER); ///< Render once
 
   subSubtleLogDebugEvents("Expose: win=%#lx\n", ev->window);
 } /* }}} */
@@ -490,8 +559,7 @@ EventGrab(XEvent *ev)
 
           subtle->keychain = NULL;
 
-          subScreenUpdate();
-          subScreenRender();
+          subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
 
           /* Restore binds */
           subGrabUnset(ROOT);
@@ -552,8 +620,7 @@ EventGrab(XEvent *ev)
 
               subtle->panels.keychain.keychain->len += len;
 
-              subScreenUpdate();
-              subScreenRender();
+              subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
             }  /* }}} */
 
           /* Keep chain position */
@@ -576,7 +643,7 @@ EventGrab(XEvent *ev)
             break; /* }}} */
           case SUB_GRAB_PROC: /* {{{ */
             subRubyCall(SUB_CALL_HOOKS, g->data.num,
-              subSubtleFind(subtle->windows.focus[0], CLIENTID));
+              subSubtleFind(subtle->windows.focus[0], CLIENTID), NULL);
             break; /* }}} */
           case SUB_GRAB_WINDOW_MOVE:
           case SUB_GRAB_WINDOW_RESIZE: /* {{{ */
@@ -590,8 +657,7 @@ EventGrab(XEvent *ev)
                 if(!(c->flags & SUB_CLIENT_MODE_FLOAT))
                   {
                     subClientToggle(c, SUB_CLIENT_MODE_FLOAT, True);
-                    subScreenUpdate();
-                    subScreenRender();
+                    subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
                   }
 
                 /* Translate flags */
@@ -616,8 +682,7 @@ EventGrab(XEvent *ev)
                     if(!VISIBLE(c) && (c = subClientNext(c->screenid, False)))
                       subClientFocus(c, True);
 
-                    subScreenUpdate();
-                    subScreenRender();
+                    subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
                   }
               }
             break; /* }}} */
@@ -634,45 +699,11 @@ EventGrab(XEvent *ev)
               /* Check if a window is currently focussed or just select next*/
               if((c = CLIENT(subSubtleFind(subtle->windows.focus[0],
                   CLIENTID))))
-                {
-                  int i, j, match = (1L << 30), distance = 0;
-
-                  /* Iterate once to find a client with smallest distance */
-                  for(i = 0; i < subtle->clients->ndata; i++)
-                    {
-                      SubClient *k = CLIENT(subtle->clients->data[i]);
-
-                      /* Check if both clients are different and visible */
-                      if(c != k && (subtle->visible_tags & k->tags ||
-                          k->flags & SUB_CLIENT_MODE_STICK))
-                        {
-                          /* Substract stack position index to get top window */
-                          distance = EventMatch(g->data.num, &c->geom,
-                            &k->geom) - i;
-
-                          /* Substract history stack position index */
-                          for(j = 1; j < HISTORYSIZE; j++)
-                            {
-                              if(subtle->windows.focus[j] == k->win)
-                                {
-                                  distance -= (HISTORYSIZE - j);
-                                  break;
-                                }
-                            }
-
-                          /* Finally compare distance */
-                          if(match > distance)
-                            {
-                              match = distance;
-                              found = k;
-                            }
-                        }
-                    }
-                  }
-                else found = subClientNext(-1, True);
+                found = subClientNeighbour(c, g->data.num, True);
+              else found = subClientNext(-1, True);
 
-                if(found) subClientFocus(found, True);
-              }
+              if(found) subClientFocus(found, True);
+            }
             break; /* }}} */
           case SUB_GRAB_WINDOW_GRAVITY: /* {{{ */
             if((c = CLIENT(subSubtleFind(subtle->windows.focus[0], CLIENTID))) &&
@@ -686,8 +717,7 @@ EventGrab(XEvent *ev)
                   {
                     subClientToggle(c, c->flags &
                       (SUB_CLIENT_MODE_FLOAT|SUB_CLIENT_MODE_FULL), True);
-                    subScreenUpdate();
-                    subScreenRender();
+                    subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
 
                     c->gravityid = -1; ///< Reset
                   }
@@ -809,8 +839,7 @@ EventMap(XMapEvent *ev)
       t->flags &= ~SUB_TRAY_DEAD;
 
       subTrayUpdate();
-      subScreenUpdate();
-      subScreenRender();
+      subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
     }
 
   subSubtleLogDebugEvents("Map: win=%#lx\n", ev->window);
@@ -841,21 +870,20 @@ EventMapRequest(XMapRequestEvent *ev)
   /* Check if we know the window */
   if((c = CLIENT(subSubtleFind(ev->window, CLIENTID))))
     {
-      c->flags &= ~SUB_CLIENT_DEAD;
-      c->flags |= SUB_CLIENT_ARRANGE;
+      c->flags    &= ~SUB_CLIENT_DEAD;
+      c->flags    |= SUB_CLIENT_ARRANGE;
+      c->mapstate  = -1; ///< Force update
 
       subScreenConfigure();
-      subScreenUpdate();
-      subScreenRender();
+      subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
     }
-  else if((c = subClientNew(ev->window)))
+  else if((c = subClientNew(ev->window, NULL)))
     {
       subArrayPush(subtle->clients, (void *)c);
       subClientRestack(c, SUB_CLIENT_RESTACK_UP);
 
       subScreenConfigure();
-      subScreenUpdate();
-      subScreenRender();
+      subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
 
       EventQueuePop(ev->window, SUB_TYPE_CLIENT);
 
@@ -869,7 +897,8 @@ EventMapRequest(XMapRequestEvent *ev)
 
 /* EventMessage {{{ */
 static void
-EventMessage(XClientMessageEvent *ev)
+EventMessage(XClientMessageEvent *ev,
+  SubIpcData *extra)
 {
   SubClient *c = NULL;
   SubTray *r = NULL;
@@ -918,7 +947,8 @@ EventMessage(XClientMessageEvent *ev)
                     /* Find matching view */
                     for(i = 0; i < subtle->views->ndata; i++)
                       {
-                        if(c && (VIEW(subtle->views->data[i])->tags & c->tags ||
+                        if(c && (subSharedBitsAny(&VIEW(subtle->views->data[i])->tags,
+                            &c->tags) ||
                             c->flags & SUB_CLIENT_MODE_STICK))
                           {
                             subViewFocus(VIEW(subtle->views->data[i]),
@@ -944,27 +974,35 @@ EventMessage(XClientMessageEvent *ev)
 
           /* subtle */
           case SUB_EWMH_SUBTLE_CLIENT_TAGS: /* {{{ */
-            if((c = CLIENT(subSubtleFind(ev->data.l[0], CLIENTID))))
+            /* Larger sets sent via X wait in the tags property */
+            if(1 < ev->data.l[3] && !extra && 0 == ev->data.l[2])
+              EventTagsDrain();
+            else if((c = CLIENT(subSubtleFind(ev->data.l[0], CLIENTID))))
               {
-                int i, flags = 0, tags = 0;
+                int i, flags = 0;
+                TAGS tags = c->tags, added;
+
+                if(!EventTags(&tags, ev, extra)) break;
 
                 /* Select only new tags */
-                tags = (c->tags ^ (int)ev->data.l[1]) & (int)ev->data.l[1];
+                added = tags;
+                subSharedBitsAndNot(&added, &c->tags);
 
                 /* Remove highlight of tagless, urgent client */
-                if(0 == tags && c->flags & SUB_CLIENT_MODE_URGENT)
-                  subtle->urgent_tags &= ~c->tags;
+                if(subSharedBitsEmpty(&added) &&
+                    c->flags & SUB_CLIENT_MODE_URGENT)
+                  subSharedBitsAndNot(&subtle->urgent_tags, &c->tags);
 
                 /* Update tags and assign properties */
-                for(i = 0; i < 31; i++)
-                  if(tags & (1L << (i + 1))) subClientTag(c, i, &flags);
+                for(i = 0; i < subtle->tags->ndata; i++)
+                  if(subSharedBitsTest(&added, i + 1))
+                    subClientTag(c, i, &flags);
 
                 subClientToggle(c, flags, True); ///< Toggle flags
-                c->tags = (int)ev->data.l[1]; ///< Write all tags
+                c->tags = tags; ///< Write all tags
 
                 /* EWMH: Tags */
-                subEwmhSetCardinals(c->win, SUB_EWMH_SUBTLE_CLIENT_TAGS,
-                  (long *)&c->tags, 1);
+                subEwmhSetTags(c->win, SUB_EWMH_SUBTLE_CLIENT_TAGS, &c->tags);
 
                 subScreenConfigure();
 
@@ -977,18 +1015,35 @@ EventMessage(XClientMessageEvent *ev)
                     if(c) subClientFocus(c, True);
                   }
 
-                subScreenUpdate();
-                subScreenRender();
+                subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
               }
             else EventQueuePush(ev, SUB_TYPE_CLIENT);
             break; /* }}} */
+          case SUB_EWMH_SUBTLE_CLIENT_NEIGHBOURS: /* {{{ */
+            if((c = CLIENT(subSubtleFind(ev->data.l[0], CLIENTID))))
+              {
+                Window win = None;
+                SubClient *n = NULL;
+
+                /* Directions are up, right, down and left */
+                if(0 <= ev->data.l[1] && 4 > ev->data.l[1] &&
+                    VISIBLE(c) && (n = subClientNeighbour(c,
+                    (1L << ev->data.l[1]), False)))
+                  win = n->win;
+
+                /* Always set since clients wait for it */
+                XChangeProperty(subtle->dpy, c->win,
+                  subEwmhGet(SUB_EWMH_SUBTLE_CLIENT_NEIGHBOURS), XA_WINDOW,
+                  32, PropModeReplace, (unsigned char *)&win, 1);
+
+                subtle->flags |= SUB_SUBTLE_PUBLISH; ///< Sync once per loop
+              }
+            break; /* }}} */
           case SUB_EWMH_SUBTLE_CLIENT_RETAG: /* {{{ */
             if((c = CLIENT(subSubtleFind(ev->data.l[0], CLIENTID))))
               {
                 int flags = 0;
 
-                c->tags = 0; ///> Reset tags
-
                 subClientRetag(c, &flags);
                 subClientToggle(c, (~c->flags & flags), True); ///< Toggle flags
 
@@ -996,8 +1051,7 @@ EventMessage(XClientMessageEvent *ev)
                     flags & SUB_CLIENT_MODE_FULL)
                   {
                     subScreenConfigure();
-                    subScreenUpdate();
-                    subScreenRender();
+                    subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
                   }
               }
             break; /* }}} */
@@ -1011,10 +1065,11 @@ EventMessage(XClientMessageEvent *ev)
                   {
                     c->gravities[(int)ev->data.l[2]] = (int)ev->data.l[1];
 
-                    if(subtle->visible_views & (1L << ((int)ev->data.l[2] + 1)))
+                    if(subSharedBitsTest(&subtle->visible_views,
+                        (int)ev->data.l[2] + 1))
                       {
                         subClientArrange(c, c->gravities[(int)ev->data.l[2]], c->screenid);
-                        XRaiseWindow(subtle->dpy, c->win);
+                        subClientRestack(c, SUB_CLIENT_RESTACK_UP);
 
                         /* Warp pointer */
                         if(!(subtle->flags & SUB_SUBTLE_SKIP_WARP))
@@ -1027,7 +1082,7 @@ EventMessage(XClientMessageEvent *ev)
                 else if(VISIBLE(c))
                   {
                     subClientArrange(c, (int)ev->data.l[1], c->screenid);
-                    XRaiseWindow(subtle->dpy, c->win);
+                    subClientRestack(c, SUB_CLIENT_RESTACK_UP);
 
                     /* Warp pointer */
                     if(!(subtle->flags & SUB_SUBTLE_SKIP_WARP))
@@ -1060,8 +1115,7 @@ EventMessage(XClientMessageEvent *ev)
                     flags & (SUB_CLIENT_MODE_FULL|SUB_CLIENT_MODE_URGENT))
                   {
                     subScreenConfigure();
-                    subScreenUpdate();
-                    subScreenRender();
+                    subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
                   }
               }
             else EventQueuePush(ev, SUB_TYPE_CLIENT);
@@ -1104,29 +1158,39 @@ EventMessage(XClientMessageEvent *ev)
                   }
 
                 subScreenConfigure();
-                subScreenUpdate();
-                subScreenRender();
+                subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
               }
             break; /* }}} */
           case SUB_EWMH_SUBTLE_GRAVITY_KILL: /* {{{ */
             if((g = GRAVITY(subArrayGet(subtle->gravities, (int)ev->data.l[0]))))
               {
-                int i;
+                int i, nfound = 0;
+                SubClient **found = NULL;
+
+                /* Collect clients first, restacking reorders the array */
+                found = (SubClient **)subSharedMemoryAlloc(
+                  MAX(1, subtle->clients->ndata), sizeof(SubClient *));
 
-                /* Check clients if gravity is in use */
                 for(i = 0; i < subtle->clients->ndata; i++)
                   {
-                    if((c = CLIENT(subtle->clients->data[i])) && c->gravityid == ev->data.l[0])
-                      {
-                        subClientArrange(c, 0, -1); ///< Fallback to first gravity
-                        XRaiseWindow(subtle->dpy, c->win);
+                    if((c = CLIENT(subtle->clients->data[i])) &&
+                        c->gravityid == ev->data.l[0])
+                      found[nfound++] = c;
+                  }
 
-                        /* Warp pointer */
-                        if(!(subtle->flags & SUB_SUBTLE_SKIP_WARP))
-                          subClientWarp(c);
-                      }
+                /* Check clients if gravity is in use */
+                for(i = 0; i < nfound; i++)
+                  {
+                    subClientArrange(found[i], 0, -1); ///< Fallback to first gravity
+                    subClientRestack(found[i], SUB_CLIENT_RESTACK_UP);
+
+                    /* Warp pointer */
+                    if(!(subtle->flags & SUB_SUBTLE_SKIP_WARP))
+                      subClientWarp(found[i]);
                   }
 
+                free(found);
+
                 /* Finallly remove gravity */
                 subArrayRemove(subtle->gravities, (void *)g);
                 subGravityKill(g);
@@ -1144,9 +1208,9 @@ EventMessage(XClientMessageEvent *ev)
             if((p = EventFindSublet((int)ev->data.l[0])) &&
                 p->sublet->flags & SUB_SUBLET_DATA)
               {
-                subRubyCall(SUB_CALL_DATA, p->sublet->instance, NULL);
-                subScreenUpdate();
-                subScreenRender();
+                subRubyCall(SUB_CALL_DATA, p->sublet->instance, extra,
+                  &p->sublet->stats);
+                subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
               }
             break; /* }}} */
           case SUB_EWMH_SUBTLE_SUBLET_STYLE: /* {{{ */
@@ -1164,8 +1228,7 @@ EventMessage(XClientMessageEvent *ev)
                     subStyleFind(&subtle->styles.sublets, name, &styleid);
 
                     p->sublet->styleid = -1 != styleid ? styleid : -1;
-                    subScreenUpdate();
-                    subScreenRender();
+                    subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
                   }
               }
             break; /* }}} */
@@ -1177,32 +1240,30 @@ EventMessage(XClientMessageEvent *ev)
                     p->flags & SUB_PANEL_HIDDEN)
                   {
                     p->flags &= ~SUB_PANEL_HIDDEN;
-                    subScreenUpdate();
-                    subScreenRender();
+                    subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
                   }
                 else if(ev->data.l[1] & SUB_EWMH_HIDDEN &&
                     !(p->flags & SUB_PANEL_HIDDEN))
                   {
                     p->flags |= SUB_PANEL_HIDDEN;
-                    subScreenUpdate();
-                    subScreenRender();
+                    subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
                   }
               }
             break; /* }}} */
           case SUB_EWMH_SUBTLE_SUBLET_UPDATE: /* {{{ */
             if((p = EventFindSublet((int)ev->data.l[0])))
               {
-                subRubyCall(SUB_CALL_RUN, p->sublet->instance, NULL);
-                subScreenUpdate();
-                subScreenRender();
+                subRubyCall(SUB_CALL_RUN, p->sublet->instance, NULL,
+                  &p->sublet->stats);
+                subScreenDamage(SUB_PANEL_SUBLET, p->sublet);
               }
             break; /* }}} */
           case SUB_EWMH_SUBTLE_SUBLET_KILL: /* {{{ */
             if((p = EventFindSublet((int)ev->data.l[0])))
               {
                 subRubyUnloadSublet(p);
-                subScreenUpdate();
-                subScreenRender();
+                subHostInit(); ///< Sublet ids changed
+                subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
               }
             break; /* }}} */
           case SUB_EWMH_SUBTLE_TAG_NEW: /* {{{ */
@@ -1229,10 +1290,11 @@ EventMessage(XClientMessageEvent *ev)
                 /* Untag views */
                 for(i = 0; i < subtle->views->ndata; i++) ///< Views
                   {
-                    v      = VIEW(subtle->views->data[i]);
-                    reconf = v->tags & (1L << ((int)ev->data.l[0] + 1));
+                    v       = VIEW(subtle->views->data[i]);
+                    reconf |= subSharedBitsTest(&v->tags,
+                      (int)ev->data.l[0] + 1);
 
-                    EventUntag(CLIENT(v), (int)ev->data.l[0]);
+                    subSharedBitsRemove(&v->tags, (int)ev->data.l[0] + 1);
                   }
 
                 /* Untag clients */
@@ -1255,8 +1317,7 @@ EventMessage(XClientMessageEvent *ev)
                 subArrayPush(subtle->views, (void *)v);
                 subClientDimension(-1); ///< Grow
                 subViewPublish();
-                subScreenUpdate();
-                subScreenRender();
+                subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
 
                 EventQueuePop(subtle->views->ndata - 1, SUB_TYPE_VIEW);
 
@@ -1266,15 +1327,19 @@ EventMessage(XClientMessageEvent *ev)
               }
             break; /* }}} */
           case SUB_EWMH_SUBTLE_VIEW_TAGS: /* {{{ */
-            if((v = VIEW(subArrayGet(subtle->views,
+            /* Larger sets sent via X wait in the tags property */
+            if(1 < ev->data.l[3] && !extra && 0 == ev->data.l[2])
+              EventTagsDrain();
+            else if((v = VIEW(subArrayGet(subtle->views,
                 (int)ev->data.l[0]))))
               {
-                v->tags = (int)ev->data.l[1]; ///< Action
+                if(!EventTags(&v->tags, ev, extra)) break; ///< Action
 
                 subViewPublish();
 
                 /* Reconfigure if view is visible */
-                if(subtle->visible_views & (1L << (ev->data.l[0] + 1)))
+                if(subSharedBitsTest(&subtle->visible_views,
+                    (int)ev->data.l[0] + 1))
                   subScreenConfigure();
               }
             else EventQueuePush(ev, SUB_TYPE_VIEW);
@@ -1294,29 +1359,28 @@ EventMessage(XClientMessageEvent *ev)
                     subStyleFind(&subtle->styles.views, name, &style_id);
 
                     v->styleid = -1 != style_id ? style_id : -1;
-                    subScreenUpdate();
-                    subScreenRender();
+                    subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
                   }
               }
             break; /* }}} */
           case SUB_EWMH_SUBTLE_VIEW_KILL: /* {{{ */
             if((v = VIEW(subArrayGet(subtle->views, (int)ev->data.l[0]))))
               {
-                int visible = !!(subtle->visible_views & (1L << (ev->data.l[0] + 1)));
+                int visible = subSharedBitsTest(&subtle->visible_views,
+                  (int)ev->data.l[0] + 1);
 
                 subArrayRemove(subtle->views, (void *)v);
                 subClientDimension((int)ev->data.l[0]); ///< Shrink
                 subViewKill(v);
                 subViewPublish();
-                subScreenUpdate();
-                subScreenRender();
+                subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
 
                 if(visible)
                   subViewFocus(VIEW(subtle->views->data[0]), -1, False, True);
               }
             break; /* }}} */
           case SUB_EWMH_SUBTLE_RENDER: /* {{{ */
-            subScreenRender();
+            subScreenDirty(NULL, SUB_SCREEN_RENDER);
             break; /* }}} */
           case SUB_EWMH_SUBTLE_RELOAD: /* {{{ */
             if(subtle) subtle->flags |= SUB_SUBTLE_RELOAD;
@@ -1331,6 +1395,9 @@ EventMessage(XClientMessageEvent *ev)
           case SUB_EWMH_SUBTLE_QUIT: /* {{{ */
             if(subtle) subtle->flags &= ~SUB_SUBTLE_RUN;
             break; /* }}} */
+          case SUB_EWMH_SUBTLE_STATS: /* {{{ */
+            subRubyPublish();
+            break; /* }}} */
           default: break;
         }
     } /* }}} */
@@ -1350,8 +1417,7 @@ EventMessage(XClientMessageEvent *ev)
                           subArrayPush(subtle->trays, (void *)r);
                           subTrayPublish();
                           subTrayUpdate();
-                          subScreenUpdate();
-                          subScreenRender();
+                          subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
                         }
                     }
                   break; /* }}} */
@@ -1416,8 +1482,7 @@ EventMessage(XClientMessageEvent *ev)
                         if(c) subClientFocus(c, True);
                       }
 
-                    subScreenUpdate();
-                    subScreenRender();
+                    subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
                   }
               }
             break; /* }}} */
@@ -1443,8 +1508,7 @@ EventMessage(XClientMessageEvent *ev)
 
                 if(VISIBLE(c))
                   {
-                    subScreenUpdate();
-                    subScreenRender();
+                    subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
                   }
               }
             break; /* }}} */
@@ -1490,8 +1554,7 @@ EventProperty(XPropertyEvent *ev)
 
             if(subtle->windows.focus[0] == c->win)
               {
-                subScreenUpdate();
-                subScreenRender();
+                subScreenDamage(SUB_PANEL_TITLE, NULL);
               }
           }
         break; /* }}} */
@@ -1505,16 +1568,14 @@ EventProperty(XPropertyEvent *ev)
 
             if(VISIBLE(c))
               {
-                subScreenUpdate();
-                subScreenRender();
+                subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
               }
           }
         else if((t = TRAY(subSubtleFind(ev->window, TRAYID))))
           {
             subTrayConfigure(t);
             subTrayUpdate();
-            subScreenUpdate();
-            subScreenRender();
+            subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
           }
         break; /* }}} */
       case SUB_EWMH_WM_HINTS: /* {{{ */
@@ -1530,8 +1591,7 @@ EventProperty(XPropertyEvent *ev)
             if(VISIBLE(c) ||
                 flags & SUB_CLIENT_MODE_URGENT)
               {
-                subScreenUpdate();
-                subScreenRender();
+                subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
               }
           }
         break; /* }}} */
@@ -1539,7 +1599,7 @@ EventProperty(XPropertyEvent *ev)
          if((c = CLIENT(subSubtleFind(ev->window, CLIENTID))))
           {
             subClientSetStrut(c);
-            subScreenUpdate();
+            subScreenDirty(NULL, SUB_SCREEN_UPDATE);
             subSubtleLogDebug("Hints: Updated strut hints\n");
           }
         break; /* }}} */
@@ -1552,8 +1612,7 @@ EventProperty(XPropertyEvent *ev)
           {
             subTraySetState(t);
             subTrayUpdate();
-            subScreenUpdate();
-            subScreenRender();
+            subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
           }
         break; /* }}} */
     }
@@ -1619,8 +1678,7 @@ EventUnmap(XUnmapEvent *ev)
       subClientPublish(False);
 
       subScreenConfigure();
-      subScreenUpdate();
-      subScreenRender();
+      subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
 
       /* Update focus if necessary */
       if((c = subClientNext(sid, False))) subClientFocus(c, True);
@@ -1641,13 +1699,13 @@ EventUnmap(XUnmapEvent *ev)
         }
 
       /*  Kill tray */
-      subArrayRemove(subtle->trays, (void *)t);
+      subArraySwapRemove(subtle->trays, subArrayIndex(subtle->trays,
+        (void *)t)); ///< Tray order is arbitrary
       subTrayKill(t);
       subTrayUpdate();
       subTrayPublish();
 
-      subScreenUpdate();
-      subScreenRender();
+      subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
 
       /* Update focus if necessary */
       if(focus && (c = subClientNext(0, False))) subClientFocus(c, True);
@@ -1656,23 +1714,177 @@ EventUnmap(XUnmapEvent *ev)
   subSubtleLogDebugEvents("Unmap: win=%#lx\n", ev->window);
 } /* }}} */
 
+/* EventReady {{{ */
+static void
+EventReady(int fd)
+{
+  SubPanel *p = NULL;
+
+  if(fd == ConnectionNumber(subtle->dpy)) ///< X events {{{
+    {
+      XEvent ev;
+
+      while(XPending(subtle->dpy)) ///< X events
+        {
+          XNextEvent(subtle->dpy, &ev);
+          switch(ev.type)
+            {
+              case ColormapNotify:    EventColormap(&ev.xcolormap);                 break;
+              case ConfigureNotify:   EventConfigure(&ev.xconfigure);               break;
+              case ConfigureRequest:  EventConfigureRequest(&ev.xconfigurerequest); break;
+              case EnterNotify:
+              case LeaveNotify:       EventCrossing(&ev.xcrossing);                 break;
+              case DestroyNotify:     EventDestroy(&ev.xdestroywindow);             break;
+              case Expose:            EventExpose(&ev.xexpose);                     break;
+              case FocusIn:           EventFocus(&ev.xfocus);                       break;
+              case ButtonPress:
+              case KeyPress:          EventGrab(&ev);                               break;
+              case MapNotify:         EventMap(&ev.xmap);                           break;
+              case MappingNotify:     EventMapping(&ev.xmapping);                   break;
+              case MapRequest:        EventMapRequest(&ev.xmaprequest);             break;
+              case ClientMessage:     EventMessage(&ev.xclient, NULL);              break;
+              case PropertyNotify:    EventProperty(&ev.xproperty);                 break;
+              case SelectionClear:    EventSelection(&ev.xselectionclear);          break;
+              case UnmapNotify:       EventUnmap(&ev.xunmap);                       break;
+              default: break;
+            }
+        }
+    } /* }}} */
+#ifdef HAVE_SYS_INOTIFY_H
+  else if(fd == subtle->notify) ///< Inotify {{{
+    {
+      char buf[BUFLEN];
+
+      if(0 < read(subtle->notify, buf, BUFLEN)) ///< Inotify events
+        {
+          struct inotify_event *event = (struct inotify_event *)&buf[0];
+
+          /* Skip unwatch events */
+          if(event && IN_IGNORED != event->mask)
+            {
+              if((p = PANEL(subSubtleFind(
+                  subtle->windows.support, event->wd))))
+                {
+                  subRubyCall(SUB_CALL_WATCH, p->sublet->instance, NULL,
+                    &p->sublet->stats);
+                  subScreenDamage(SUB_PANEL_SUBLET, p->sublet);
+                }
+            }
+        }
+    } /* }}} */
+#endif /* HAVE_SYS_INOTIFY_H */
+  else if(0 < subtle->host && fd == subtle->host) ///< Sublet host {{{
+    {
+      subHostReceive();
+    } /* }}} */
+  else if(fd < nwatches && (p = watches[fd].p)) ///< Socket {{{
+    {
+      subRubyCall(SUB_CALL_WATCH, p->sublet->instance, NULL,
+        &p->sublet->stats);
+      subScreenDamage(SUB_PANEL_SUBLET, p->sublet);
+    } /* }}} */
+  else if(0 < subtle->ipc) subIpcReceive(fd); ///< Subtlext socket
+} /* }}} */
+
 /* Public */
 
+ /** subEventMessage {{{
+  * @brief Handle client message received via socket
+  * @param[in]  win     Message window
+  * @param[in]  type    Message type
+  * @param[in]  format  Data format
+  * @param[in]  data    A #SubMessageData
+  * @param[in]  extra   A #SubIpcData or \p NULL
+  **/
+
+void
+subEventMessage(Window win,
+  Atom type,
+  int format,
+  SubMessageData *data,
+  SubIpcData *extra)
+{
+  XClientMessageEvent ev = { 0 };
+
+  assert(data);
+
+  /* Assemble event */
+  ev.type         = ClientMessage;
+  ev.send_event   = True;
+  ev.display      = subtle->dpy;
+  ev.window       = win;
+  ev.message_type = type;
+  ev.format       = format;
+
+  memcpy(&ev.data, data, sizeof(ev.data));
+
+  EventMessage(&ev, extra);
+} /* }}} */
+
  /** subEventWatchAdd {{{
   * @brief Add descriptor to watch list
-  * @param[in]  fd  File descriptor
+  * @param[in]  fd    File descriptor
+  * @param[in]  p     A #SubPanel or \p NULL
+  * @param[in]  edge  Whether to report only new data
   **/
 
 void
-subEventWatchAdd(int fd)
+subEventWatchAdd(int fd,
+  SubPanel *p,
+  int edge)
 {
-  /* Add descriptor to list */
-  watches = (struct pollfd *)subSharedMemoryRealloc(watches,
-    (nwatches + 1) * sizeof(struct pollfd));
+  if(0 > fd) return;
+
+  /* Grow descriptor table */
+  if(fd >= nwatches)
+    {
+      watches = (EventWatch *)subSharedMemoryRealloc(watches,
+        (fd + 1) * sizeof(EventWatch));
+      memset(watches + nwatches, 0, (fd + 1 - nwatches) * sizeof(EventWatch));
+
+      nwatches = fd + 1;
+    }
 
-  watches[nwatches].fd        = fd;
-  watches[nwatches].events    = POLLIN;
-  watches[nwatches++].revents = 0;
+  watches[fd].p = p;
+
+#ifdef HAVE_SYS_EPOLL_H
+  {
+    struct epoll_event ev = { 0 };
+
+    /* Without epoll the loop would spin */
+    if(-1 == epollfd && -1 == (epollfd = epoll_create1(EPOLL_CLOEXEC)))
+      {
+        subSubtleLogError("Cannot create epoll instance: %s\n",
+          strerror(errno));
+
+        abort();
+      }
+
+    ev.events  = EPOLLIN|(edge ? EPOLLET : 0);
+    ev.data.fd = fd;
+
+    if(-1 == epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &ev) &&
+        (EEXIST != errno || -1 == epoll_ctl(epollfd, EPOLL_CTL_MOD, fd, &ev)))
+      subSubtleLogWarn("Cannot watch descriptor `%d': %s\n",
+        fd, strerror(errno));
+  }
+#else
+  /* Append to poll list */
+  if(!watches[fd].slot)
+    {
+      pollfds = (struct pollfd *)subSharedMemoryRealloc(pollfds,
+        (npollfds + 1) * sizeof(struct pollfd));
+
+      pollfds[npollfds].fd      = fd;
+      pollfds[npollfds].events  = POLLIN;
+      pollfds[npollfds].revents = 0;
+      watches[fd].slot          = ++npollfds;
+    }
+#endif /* HAVE_SYS_EPOLL_H */
+
+  watchadds++;
+
+  subSubtleLogDebugEvents("WatchAdd: fd=%d, edge=%d\n", fd, edge);
 } /* }}} */
 
  /** subEventWatchDel {{{
@@ -1683,21 +1895,86 @@ subEventWatchAdd(int fd)
 void
 subEventWatchDel(int fd)
 {
-  int i, j;
-
-  for(i = 0; i < nwatches; i++)
+  if(0 > fd || fd >= nwatches) return;
+
+#ifdef HAVE_SYS_EPOLL_H
+  /* Closed descriptors are already gone */
+  if(-1 != epollfd) epoll_ctl(epollfd, EPOLL_CTL_DEL, fd, NULL);
+#else
+  /* Fill gap with last descriptor */
+  if(watches[fd].slot)
     {
-      if(watches[i].fd == fd)
+      int idx = watches[fd].slot - 1;
+
+      if(idx != --npollfds)
         {
-          for(j = i; j < nwatches - 1; j++)
-            watches[j] = watches[j + 1];
-          break;
+          pollfds[idx]                  = pollfds[npollfds];
+          watches[pollfds[idx].fd].slot = idx + 1;
         }
     }
+#endif /* HAVE_SYS_EPOLL_H */
+
+  watches[fd].slot = 0;
+  watches[fd].p    = NULL;
 
-  nwatches--;
-  watches = (struct pollfd *)subSharedMemoryRealloc(watches,
-    nwatches * sizeof(struct pollfd));
+  watchdels++;
+
+  subSubtleLogDebugEvents("WatchDel: fd=%d\n", fd);
+} /* }}} */
+
+ /** subEventTimerAdd {{{
+  * @brief Add sublet to timer heap or update its position
+  * @param[in]  p  A #SubPanel
+  **/
+
+void
+subEventTimerAdd(SubPanel *p)
+{
+  assert(p && p->sublet);
+
+  /* Append new timer */
+  if(!p->sublet->timer)
+    {
+      timers = (SubPanel **)subSharedMemoryRealloc(timers,
+        (ntimers + 1) * sizeof(SubPanel *));
+
+      timers[ntimers++] = p;
+      p->sublet->timer  = ntimers; ///< Slot is index + 1
+    }
+
+  EventTimerSift(p->sublet->timer - 1);
+
+  subSubtleLogDebugSubtle("TimerAdd: name=%s, time=%lld, interval=%lld\n",
+    p->sublet->name, p->sublet->time, p->sublet->interval);
+} /* }}} */
+
+ /** subEventTimerDel {{{
+  * @brief Del sublet from timer heap
+  * @param[in]  p  A #SubPanel
+  **/
+
+void
+subEventTimerDel(SubPanel *p)
+{
+  int idx = 0;
+
+  assert(p && p->sublet);
+
+  if(!p->sublet->timer) return;
+
+  idx              = p->sublet->timer - 1;
+  p->sublet->timer = 0;
+
+  /* Fill gap with last timer */
+  if(idx != --ntimers)
+    {
+      timers[idx]                = timers[ntimers];
+      timers[idx]->sublet->timer = idx + 1;
+
+      EventTimerSift(idx);
+    }
+
+  subSubtleLogDebugSubtle("TimerDel: name=%s\n", p->sublet->name);
 } /* }}} */
 
  /** subEventLoop {{{
@@ -1707,15 +1984,14 @@ subEventWatchDel(int fd)
 void
 subEventLoop(void)
 {
-  int i, timeout = 1, nevents = 0;
-  XEvent ev;
-  time_t now;
+  int i, timeout = -1, delay = -1, nevents = 0;
+  long long now = 0, rendered = 0;
   SubPanel *p = NULL;
   SubClient *c = NULL;
 
-#ifdef HAVE_SYS_INOTIFY_H
-  char buf[BUFLEN];
-#endif /* HAVE_SYS_INOTIFY_H */
+#ifdef HAVE_SYS_EPOLL_H
+  struct epoll_event ready[EVENTS];
+#endif /* HAVE_SYS_EPOLL_H */
 
   /* Update screens and panels */
   subScreenConfigure();
@@ -1723,15 +1999,20 @@ subEventLoop(void)
   subScreenRender();
   subPanelPublish();
 
-  /* Add watches */
-  subEventWatchAdd(ConnectionNumber(subtle->dpy));
+  /* Add watches: Level-triggered, since Xlib may read ahead on any
+   * round trip without a new edge on the connection */
+  subEventWatchAdd(ConnectionNumber(subtle->dpy), NULL, False);
 #ifdef HAVE_SYS_INOTIFY_H
-  subEventWatchAdd(subtle->notify);
+  subEventWatchAdd(subtle->notify, NULL, False);
 #endif /* HAVE_SYS_INOTIFY_H */
 
   /* Set tray selection */
   if(subtle->flags & SUB_SUBTLE_TRAY) subTraySelect();
 
+  /* Open socket and move interval sublets out of the way */
+  subIpcInit();
+  subHostInit();
+
   subtle->flags |= SUB_SUBTLE_RUN;
   XSync(subtle->dpy, False); ///< Sync before going on
 
@@ -1746,8 +2027,6 @@ subEventLoop(void)
   /* Start main loop */
   while(subtle && subtle->flags & SUB_SUBTLE_RUN)
     {
-      now = subSubtleTime();
-
       /* Check if we need to reload */
       if(subtle->flags & SUB_SUBTLE_RELOAD)
         {
@@ -1755,6 +2034,7 @@ subEventLoop(void)
 
           subtle->flags &= ~SUB_SUBTLE_RELOAD;
           subRubyReloadConfig();
+          subHostInit();
 
           /* Update tray selection */
           if(tray && !(subtle->flags & SUB_SUBTLE_TRAY))
@@ -1763,120 +2043,131 @@ subEventLoop(void)
             subTraySelect();
         }
 
+      now = subSubtleTime();
+
+      /* Flush deferred updates once per batch of events {{{ */
+      delay = -1;
+      if(subtle->flags & SUB_SUBTLE_DIRTY)
+        {
+          /* Limit panel frame rate */
+          if(0 < subtle->fps && now < rendered + 1000 / subtle->fps)
+            delay = (int)(rendered + 1000 / subtle->fps - now);
+          else
+            {
+              subScreenFlush();
+              rendered = now;
+            }
+        } /* }}} */
+
+      /* Commit published properties once per batch of events, a flush
+       * is enough and doesn't read events behind our back */
+      if(subtle->flags & SUB_SUBTLE_PUBLISH)
+        {
+          subtle->flags &= ~SUB_SUBTLE_PUBLISH;
+
+          XFlush(subtle->dpy);
+        }
+
+      /* Restart host with changed intervals of our sublets */
+      if(subtle->flags & SUB_SUBTLE_RESPAWN) subHostInit();
+
+      /* Set timeout to next sublet timer, host check or pending flush */
+      if(0 < subtle->host)
+        timeout = subHostCheck(now);
+      else if(0 < ntimers)
+        {
+          timeout = (int)(timers[0]->sublet->time - now);
+          if(0 >= timeout) timeout = 1; ///< Sanitize
+        }
+      else timeout = -1;
+
+      if(-1 != delay && (-1 == timeout || delay < timeout)) timeout = delay;
+
+      /* Don't block when a sync already read events into the queue */
+      if(0 < QLength(subtle->dpy)) timeout = 0;
+
       /* Data ready on any connection */
-      if(0 < (nevents = poll(watches, nwatches, timeout * 1000)))
+#ifdef HAVE_SYS_EPOLL_H
+      if(0 < (nevents = epoll_wait(epollfd, ready, EVENTS, timeout)))
+        {
+          wakeups++;
+          nready += nevents;
+
+          for(i = 0; i < nevents; i++)
+            EventReady(ready[i].data.fd);
+        }
+#else
+      if(0 < (nevents = poll(pollfds, npollfds, timeout)))
         {
-          for(i = 0; i < nwatches; i++) ///< Find descriptor
+          wakeups++;
+          nready += nevents;
+
+          for(i = 0; 0 < nevents && i < npollfds; i++) ///< Find descriptors
             {
-              if(0 != watches[i].revents)
+              if(0 != pollfds[i].revents)
                 {
-                  if(watches[i].fd == ConnectionNumber(subtle->dpy)) ///< X events {{{
-                    {
-                      while(XPending(subtle->dpy)) ///< X events
-                        {
-                          XNextEvent(subtle->dpy, &ev);
-                          switch(ev.type)
-                            {
-                              case ColormapNotify:    EventColormap(&ev.xcolormap);                 break;
-                              case ConfigureNotify:   EventConfigure(&ev.xconfigure);               break;
-                              case ConfigureRequest:  EventConfigureRequest(&ev.xconfigurerequest); break;
-                              case EnterNotify:
-                              case LeaveNotify:       EventCrossing(&ev.xcrossing);                 break;
-                              case DestroyNotify:     EventDestroy(&ev.xdestroywindow);             break;
-                              case Expose:            EventExpose(&ev.xexpose);                     break;
-                              case FocusIn:           EventFocus(&ev.xfocus);                       break;
-                              case ButtonPress:
-                              case KeyPress:          EventGrab(&ev);                               break;
-                              case MapNotify:         EventMap(&ev.xmap);                           break;
-                              case MappingNotify:     EventMapping(&ev.xmapping);                   break;
-                              case MapRequest:        EventMapRequest(&ev.xmaprequest);             break;
-                              case ClientMessage:     EventMessage(&ev.xclient);                    break;
-                              case PropertyNotify:    EventProperty(&ev.xproperty);                 break;
-                              case SelectionClear:    EventSelection(&ev.xselectionclear);          break;
-                              case UnmapNotify:       EventUnmap(&ev.xunmap);                       break;
-                              default: break;
-                            }
-                        }
-                    } /* }}} */
-#ifdef HAVE_SYS_INOTIFY_H
-                  else if(watches[i].fd == subtle->notify) ///< Inotify {{{
-                    {
-                      if(0 < read(subtle->notify, buf, BUFLEN)) ///< Inotify events
-                        {
-                          struct inotify_event *event = (struct inotify_event *)&buf[0];
-
-                          /* Skip unwatch events */
-                          if(event && IN_IGNORED != event->mask)
-                            {
-                              if((p = PANEL(subSubtleFind(
-                                  subtle->windows.support, event->wd))))
-                                {
-                                  subRubyCall(SUB_CALL_WATCH,
-                                    p->sublet->instance, NULL);
-                                  subScreenUpdate();
-                                  subScreenRender();
-                                }
-                            }
-                        }
-                    } /* }}} */
-#endif /* HAVE_SYS_INOTIFY_H */
-                  else ///< Socket {{{
-                    {
-                      if((p = PANEL(subSubtleFind(subtle->windows.support,
-                          watches[i].fd))))
-                        {
-                          subRubyCall(SUB_CALL_WATCH,
-                            p->sublet->instance, NULL);
-                          subScreenUpdate();
-                          subScreenRender();
-                        }
-                    } /* }}} */
+                  pollfds[i].revents = 0;
+                  nevents--;
+
+                  EventReady(pollfds[i].fd);
                 }
             }
         }
-      else if(0 == nevents) ///< Timeout waiting for data or error {{{
+#endif /* HAVE_SYS_EPOLL_H */
+
+      /* Handle queued events that didn't wake us up */
+      if(0 < QLength(subtle->dpy)) EventReady(ConnectionNumber(subtle->dpy));
+
+      now = subSubtleTime();
+
+      /* Run expired sublet timers unless a host runs them {{{ */
+      if(0 >= subtle->host && 0 < ntimers && timers[0]->sublet->time <= now)
         {
-          if(0 < subtle->sublets->ndata)
+          while(0 < ntimers && (p = timers[0])->sublet->time <= now)
             {
-              p = PANEL(subtle->sublets->data[0]);
-
-              /* Update all pending sublets */
-              while(p && p->sublet->flags & SUB_SUBLET_INTERVAL &&
-                  p->sublet->time <= now)
+              /* Never run sublets that stalled the host */
+              if(p->sublet->flags & SUB_SUBLET_STALL)
                 {
-                  subRubyCall(SUB_CALL_RUN, p->sublet->instance, NULL);
+                  subEventTimerDel(p);
 
-                  /* This may change during run */
-                  if(p->sublet->flags & SUB_SUBLET_INTERVAL) 
-                    {
-                      p->sublet->time  = now + p->sublet->interval; ///< Adjust seconds
-                      p->sublet->time -= p->sublet->time % p->sublet->interval;
-                    }
-
-                  subArraySort(subtle->sublets, subPanelCompare);
+                  continue;
                 }
 
-              subScreenUpdate();
-              subScreenRender();
-            }
-        } /* }}} */
+              subRubyCall(SUB_CALL_RUN, p->sublet->instance, NULL,
+                &p->sublet->stats);
+              subScreenDamage(SUB_PANEL_SUBLET, p->sublet);
 
-      /* Set new timeout */
-      if(0 < subtle->sublets->ndata)
-        {
-          p = PANEL(subtle->sublets->data[0]);
+              /* Interval may change during run */
+              if(p->sublet->timer && p->sublet->time <= now)
+                {
+                  p->sublet->time  = now + p->sublet->interval; ///< Adjust to interval
+                  p->sublet->time -= p->sublet->time % p->sublet->interval;
 
-          timeout = p->sublet->flags & SUB_SUBLET_INTERVAL ?
-            p->sublet->time - now : 60;
-          if(0 >= timeout) timeout = 1; ///< Sanitize
-        }
-      else timeout = 60;
+                  subEventTimerAdd(p);
+                }
+            }
+        } /* }}} */
     }
 
   /* Drop tray selection */
   if(subtle->flags & SUB_SUBTLE_TRAY) subTrayDeselect();
 } /* }}} */
 
+ /** subEventStats {{{
+  * @brief Get event loop counters as call stats
+  * @param[inout]  stats  Added watches, removed watches, wakeups and
+  *                       ready fds, count is stored as calls
+  **/
+
+void
+subEventStats(SubStats *stats)
+{
+  stats[0].calls = watchadds;
+  stats[1].calls = watchdels;
+  stats[2].calls = wakeups;
+  stats[3].calls = nready;
+} /* }}} */
+
  /** subEventFinish {{{
   * @brief Finish event processing
   **/
@@ -1884,9 +2175,18 @@ subEventLoop(void)
 void
 subEventFinish(void)
 {
+  subSubtleLogDebugEvents("Finish: watches added=%lu, removed=%lu, "
+    "wakeups=%lu, ready=%lu\n", watchadds, watchdels, wakeups, nready);
+
+#ifdef HAVE_SYS_EPOLL_H
+  if(-1 != epollfd) close(epollfd);
+#else
+  if(pollfds) free(pollfds);
+#endif /* HAVE_SYS_EPOLL_H */
 
   if(watches) free(watches);
   if(queue)   free(queue);
+  if(timers)  free(timers);
 } /* }}} */
 
 // vim:ts=2:bs=2:sw=2:et:fdm=marker
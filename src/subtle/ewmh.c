@@ -15,13 +15,72 @@
 #include <X11/Xatom.h>
 #include "subtle.h"
 
-static Atom atoms[SUB_EWMH_TOTAL];
+#define SHADOWS 128                                               ///< Shadow hash buckets
 
 /* Typedef {{{ */
 typedef struct xembedinfo_t
 {
   CARD32 version, flags;
-} XEmbedInfo; /* }}} */
+} XEmbedInfo;
+
+typedef struct ewmhshadow_t
+{
+  Window              win;                                        ///< Shadow window
+  Atom                atom;                                       ///< Shadow property
+  int                 len;                                        ///< Shadow data length
+  unsigned char       *data;                                      ///< Shadow data
+  struct ewmhshadow_t *next;                                      ///< Shadow bucket link
+} EwmhShadow;
+/* }}} */
+
+/* Globals */
+static EwmhShadow *shadows[SHADOWS] = { NULL };
+static unsigned long shadowskips = 0;
+
+/* EwmhShadowUpdate {{{ */
+static int
+EwmhShadowUpdate(Window win,
+  Atom atom,
+  void *data,
+  int len)
+{
+  EwmhShadow *shadow = NULL;
+  int bucket = (int)((win * 31 + atom) % SHADOWS);
+
+  /* Find shadow copy */
+  for(shadow = shadows[bucket]; shadow; shadow = shadow->next)
+    if(shadow->win == win && shadow->atom == atom) break;
+
+  if(shadow)
+    {
+      /* Skip identical writes */
+      if(shadow->len == len && 0 == memcmp(shadow->data, data, len))
+        {
+          shadowskips++;
+
+          return False;
+        }
+
+      free(shadow->data);
+    }
+  else
+    {
+      shadow = (EwmhShadow *)subSharedMemoryAlloc(1, sizeof(EwmhShadow));
+      shadow->win  = win;
+      shadow->atom = atom;
+      shadow->next = shadows[bucket];
+
+      shadows[bucket] = shadow;
+    }
+
+  /* Store copy of new value */
+  shadow->len  = len;
+  shadow->data = (unsigned char *)subSharedMemoryAlloc(MAX(1, len),
+    sizeof(unsigned char));
+  memcpy(shadow->data, data, len);
+
+  return True;
+} /* }}} */
 
  /** subEwmhInit {{{
   * @brief Init and register ICCCM/EWMH atoms
@@ -30,80 +89,20 @@ typedef struct xembedinfo_t
 void
 subEwmhInit(void)
 {
-  int len = 0;
+  int i;
   long data[2] = { 0, 0 }, pid = (long)getpid();
-  char *selection = NULL, *names[] =
-  {
-    /* ICCCM */
-    "WM_NAME", "WM_CLASS", "WM_STATE", "WM_PROTOCOLS", "WM_TAKE_FOCUS",
-    "WM_DELETE_WINDOW", "WM_NORMAL_HINTS", "WM_SIZE_HINTS", "WM_HINTS",
-    "WM_WINDOW_ROLE", "WM_CLIENT_LEADER",
-
-    /* EWMH */
-    "_NET_SUPPORTED", "_NET_CLIENT_LIST", "_NET_CLIENT_LIST_STACKING",
-    "_NET_NUMBER_OF_DESKTOPS", "_NET_DESKTOP_NAMES", "_NET_DESKTOP_GEOMETRY",
-    "_NET_DESKTOP_VIEWPORT", "_NET_CURRENT_DESKTOP", "_NET_ACTIVE_WINDOW",
-    "_NET_WORKAREA", "_NET_SUPPORTING_WM_CHECK", "_NET_WM_FULL_PLACEMENT",
-    "_NET_FRAME_EXTENTS",
-
-    /* Client */
-    "_NET_CLOSE_WINDOW", "_NET_RESTACK_WINDOW", "_NET_MOVERESIZE_WINDOW",
-    "_NET_WM_NAME", "_NET_WM_PID", "_NET_WM_DESKTOP", "_NET_WM_STRUT",
-
-    /* Types */
-    "_NET_WM_WINDOW_TYPE", "_NET_WM_WINDOW_TYPE_DOCK",
-    "_NET_WM_WINDOW_TYPE_DESKTOP", "_NET_WM_WINDOW_TYPE_TOOLBAR",
-    "_NET_WM_WINDOW_TYPE_SPLASH", "_NET_WM_WINDOW_TYPE_DIALOG",
-
-    /* States */
-    "_NET_WM_STATE", "_NET_WM_STATE_FULLSCREEN", "_NET_WM_STATE_ABOVE",
-    "_NET_WM_STATE_STICKY", "_NET_WM_STATE_DEMANDS_ATTENTION",
-
-    /* Tray */
-    "_NET_SYSTEM_TRAY_OPCODE", "_NET_SYSTEM_TRAY_MESSAGE_DATA",
-    "_NET_SYSTEM_TRAY_S",
-
-    /* Misc */
-    "UTF8_STRING", "MANAGER", "_MOTIF_WM_HINTS",
-
-    /* XEmbed */
-    "_XEMBED", "_XEMBED_INFO",
-
-    /* subtle */
-    "SUBTLE_CLIENT_TAGS", "SUBTLE_CLIENT_RETAG",
-    "SUBTLE_CLIENT_GRAVITY", "SUBTLE_CLIENT_SCREEN", "SUBTLE_CLIENT_FLAGS",
-    "SUBTLE_GRAVITY_NEW", "SUBTLE_GRAVITY_FLAGS", "SUBTLE_GRAVITY_LIST",
-    "SUBTLE_GRAVITY_KILL",
-    "SUBTLE_TAG_NEW", "SUBTLE_TAG_LIST", "SUBTLE_TAG_KILL", "SUBTLE_TRAY_LIST",
-    "SUBTLE_VIEW_NEW", "SUBTLE_VIEW_TAGS", "SUBTLE_VIEW_STYLE",
-    "SUBTLE_VIEW_ICONS", "SUBTLE_VIEW_KILL",
-    "SUBTLE_SUBLET_UPDATE", "SUBTLE_SUBLET_DATA", "SUBTLE_SUBLET_STYLE",
-    "SUBTLE_SUBLET_FLAGS", "SUBTLE_SUBLET_LIST", "SUBTLE_SUBLET_KILL",
-    "SUBTLE_SCREEN_PANELS", "SUBTLE_SCREEN_VIEWS", "SUBTLE_SCREEN_JUMP",
-    "SUBTLE_VISIBLE_TAGS", "SUBTLE_VISIBLE_VIEWS",
-    "SUBTLE_RENDER", "SUBTLE_RELOAD", "SUBTLE_RESTART", "SUBTLE_QUIT",
-    "SUBTLE_COLORS", "SUBTLE_FONT", "SUBTLE_DATA", "SUBTLE_VERSION"
-  };
-
-  assert(SUB_EWMH_TOTAL == LENGTH(names));
-
-  /* Update tray selection name for current screen */
-  len       = strlen(names[SUB_EWMH_NET_SYSTEM_TRAY_SELECTION]) + 5; ///< For high screen counts
-  selection = (char *)subSharedMemoryAlloc(len, sizeof(char));
-
-  snprintf(selection, len, "%s%u", names[SUB_EWMH_NET_SYSTEM_TRAY_SELECTION], SCRN);
-  subSubtleLogDebug("Selection: len=%d, name=%s\n", len, selection);
-  names[SUB_EWMH_NET_SYSTEM_TRAY_SELECTION] = selection;
+  Atom supported[SUB_EWMH_TOTAL];
 
   /* Register atoms */
-  XInternAtoms(subtle->dpy, names, SUB_EWMH_TOTAL, 0, atoms);
+  subSharedAtomInit(subtle->dpy, SCRN);
   subtle->flags |= SUB_SUBTLE_EWMH; ///< Set EWMH flag
 
-  free(selection);
+  for(i = 0; i < SUB_EWMH_TOTAL; i++)
+    supported[i] = subSharedAtomGet(i);
 
   /* EWMH: Supported hints */
-  XChangeProperty(subtle->dpy, ROOT, atoms[SUB_EWMH_NET_SUPPORTED], XA_ATOM,
-    32, PropModeReplace, (unsigned char *)&atoms, SUB_EWMH_TOTAL);
+  XChangeProperty(subtle->dpy, ROOT, supported[SUB_EWMH_NET_SUPPORTED], XA_ATOM,
+    32, PropModeReplace, (unsigned char *)&supported, SUB_EWMH_TOTAL);
 
   /* EWMH: Window manager information */
   subEwmhSetWindows(ROOT, SUB_EWMH_NET_SUPPORTING_WM_CHECK,
@@ -135,9 +134,7 @@ subEwmhInit(void)
 Atom
 subEwmhGet(SubEwmh e)
 {
-  assert(e <= SUB_EWMH_TOTAL);
-
-  return atoms[e];
+  return subSharedAtomGet(e);
 } /* }}} */
 
  /** subEwmhFind {{{
@@ -150,12 +147,7 @@ subEwmhGet(SubEwmh e)
 SubEwmh
 subEwmhFind(Atom atom)
 {
-  int i;
-
-  for(i = 0; atom && i < SUB_EWMH_TOTAL; i++)
-    if(atoms[i] == atom) return i;
-
-  return -1;
+  return subSharedAtomFind(atom);
 } /* }}} */
 
  /** subEwmhGetWMState {{{
@@ -174,8 +166,9 @@ subEwmhGetWMState(Window win)
 
   assert(win);
 
-  if(Success == XGetWindowProperty(subtle->dpy, win, atoms[SUB_EWMH_WM_STATE], 0L, 2L, False,
-      atoms[SUB_EWMH_WM_STATE], &type, &format, &bytes, &unused,
+  if(Success == XGetWindowProperty(subtle->dpy, win,
+      subEwmhGet(SUB_EWMH_WM_STATE), 0L, 2L, False,
+      subEwmhGet(SUB_EWMH_WM_STATE), &type, &format, &bytes, &unused,
       (unsigned char **)&data) && bytes)
     {
       state = *data;
@@ -226,8 +219,9 @@ subEwmhSetWindows(Window win,
   Window *values,
   int size)
 {
-  XChangeProperty(subtle->dpy, win, atoms[e], XA_WINDOW, 32, PropModeReplace,
-    (unsigned char *)values, size);
+  if(EwmhShadowUpdate(win, subEwmhGet(e), values, size * sizeof(Window)))
+    XChangeProperty(subtle->dpy, win, subEwmhGet(e), XA_WINDOW, 32,
+      PropModeReplace, (unsigned char *)values, size);
 } /* }}} */
 
  /** subEwmhSetCardinals {{{
@@ -244,8 +238,30 @@ subEwmhSetCardinals(Window win,
   long *values,
   int size)
 {
-  XChangeProperty(subtle->dpy, win, atoms[e], XA_CARDINAL, 32, PropModeReplace,
-    (unsigned char *)values, size);
+  if(EwmhShadowUpdate(win, subEwmhGet(e), values, size * sizeof(long)))
+    XChangeProperty(subtle->dpy, win, subEwmhGet(e), XA_CARDINAL, 32,
+      PropModeReplace, (unsigned char *)values, size);
+} /* }}} */
+
+ /** subEwmhSetTags {{{
+  * @brief Change window property to tag bits
+  * @param[in]  win   Window
+  * @param[in]  e     A #SubEwmh
+  * @param[in]  tags  A #TAGS bitset
+  **/
+
+void
+subEwmhSetTags(Window win,
+  SubEwmh e,
+  TAGS *tags)
+{
+  int n = 0;
+  long cardinals[BITSWORDS] = { 0 };
+
+  /* One cardinal per word, trailing empty words omitted */
+  n = subSharedBitsPack(tags, cardinals);
+
+  subEwmhSetCardinals(win, e, cardinals, n);
 } /* }}} */
 
  /** subEwmhSetString {{{
@@ -260,8 +276,50 @@ subEwmhSetString(Window win,
   SubEwmh e,
   char *value)
 {
-  XChangeProperty(subtle->dpy, win, atoms[e], atoms[SUB_EWMH_UTF8], 8,
-    PropModeReplace, (unsigned char *)value, strlen(value));
+  if(EwmhShadowUpdate(win, subEwmhGet(e), value, strlen(value)))
+    {
+      XChangeProperty(subtle->dpy, win, subEwmhGet(e),
+        subEwmhGet(SUB_EWMH_UTF8), 8, PropModeReplace,
+        (unsigned char *)value, strlen(value));
+    }
+} /* }}} */
+
+ /** subEwmhSetStrings {{{
+  * @brief Change window property
+  * @param[in]  win    Window
+  * @param[in]  e      A #SubEwmh
+  * @param[in]  list   String list
+  * @param[in]  nlist  Size of the list
+  **/
+
+void
+subEwmhSetStrings(Window win,
+  SubEwmh e,
+  char **list,
+  int nlist)
+{
+  int i, len = 0;
+  char *buf = NULL;
+
+  /* Join list with null bytes like the property itself */
+  for(i = 0; i < nlist; i++)
+    if(list[i]) len += strlen(list[i]) + 1;
+
+  buf = (char *)subSharedMemoryAlloc(MAX(1, len), sizeof(char));
+
+  for(i = 0, len = 0; i < nlist; i++)
+    {
+      if(list[i])
+        {
+          strcpy(buf + len, list[i]);
+          len += strlen(list[i]) + 1;
+        }
+    }
+
+  if(EwmhShadowUpdate(win, subEwmhGet(e), buf, len))
+    subSharedPropertySetStrings(subtle->dpy, win, subEwmhGet(e), list, nlist);
+
+  free(buf);
 } /* }}} */
 
  /** subEwmhSetWMState {{{
@@ -280,8 +338,43 @@ subEwmhSetWMState(Window win,
 
   assert(win);
 
-  XChangeProperty(subtle->dpy, win, atoms[SUB_EWMH_WM_STATE],
-    atoms[SUB_EWMH_WM_STATE], 32, PropModeReplace, (unsigned char *)data, 2);
+  if(EwmhShadowUpdate(win, subEwmhGet(SUB_EWMH_WM_STATE), data, sizeof(data)))
+    {
+      XChangeProperty(subtle->dpy, win, subEwmhGet(SUB_EWMH_WM_STATE),
+        subEwmhGet(SUB_EWMH_WM_STATE), 32, PropModeReplace,
+        (unsigned char *)data, 2);
+    }
+} /* }}} */
+
+ /** subEwmhForget {{{
+  * @brief Drop shadow copies of window properties
+  * @param[in]  win  Window or \p None for all
+  **/
+
+void
+subEwmhForget(Window win)
+{
+  int i;
+
+  for(i = 0; i < SHADOWS; i++)
+    {
+      EwmhShadow **link = &shadows[i];
+
+      while(*link)
+        {
+          EwmhShadow *shadow = *link;
+
+          /* Unlink and free matching shadows */
+          if(None == win || shadow->win == win)
+            {
+              *link = shadow->next;
+
+              free(shadow->data);
+              free(shadow);
+            }
+          else link = &shadow->next;
+        }
+    }
 } /* }}} */
 
  /** subEwmhTranslateWMState {{{
@@ -362,7 +455,7 @@ subEwmhMessage(Window win,
 
   /* Assemble message */
   ev.type         = ClientMessage;
-  ev.message_type = atoms[e];
+  ev.message_type = subEwmhGet(e);
   ev.window       = win;
   ev.format       = 32;
   ev.data.l[0]    = data0;
@@ -408,9 +501,14 @@ subEwmhFinish(void)
       subSharedPropertyDelete(subtle->dpy, ROOT, subEwmhGet(SUB_EWMH_SUBTLE_SCREEN_VIEWS));
       subSharedPropertyDelete(subtle->dpy, ROOT, subEwmhGet(SUB_EWMH_SUBTLE_VISIBLE_VIEWS));
       subSharedPropertyDelete(subtle->dpy, ROOT, subEwmhGet(SUB_EWMH_SUBTLE_VISIBLE_TAGS));
+      subSharedPropertyDelete(subtle->dpy, ROOT, subEwmhGet(SUB_EWMH_SUBTLE_STATS));
+      subSharedPropertyDelete(subtle->dpy, ROOT, subEwmhGet(SUB_EWMH_SUBTLE_TAGS));
     }
 
-  subSubtleLogDebugSubtle("Finish\n");
+  subEwmhForget(None);
+  subSharedAtomKill();
+
+  subSubtleLogDebugSubtle("Finish: skipped writes=%lu\n", shadowskips);
 } /* }}} */
 
 // vim:ts=2:bs=2:sw=2:et:fdm=marker
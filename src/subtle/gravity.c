@@ -157,15 +157,14 @@ subGravityPublish(void)
     }
 
   /* EWMH: Gravity list and geometries */
-  subSharedPropertySetStrings(subtle->dpy, ROOT,
-    subEwmhGet(SUB_EWMH_SUBTLE_GRAVITY_LIST), gravities,
+  subEwmhSetStrings(ROOT, SUB_EWMH_SUBTLE_GRAVITY_LIST, gravities,
     subtle->gravities->ndata);
 
   /* Tidy up */
   for(i = 0; i < subtle->gravities->ndata; i++)
     free(gravities[i]);
 
-  XSync(subtle->dpy, False); ///< Sync all changes
+  subtle->flags |= SUB_SUBTLE_PUBLISH; ///< Sync once per loop
 
   free(gravities);
 
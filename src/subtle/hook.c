@@ -10,8 +10,60 @@
   * See the file COPYING for details.
   **/
 
+#include <strings.h>
 #include "subtle.h"
 
+#define HOOKSLOTS 42                                              ///< Hook types times actions
+
+/* Globals */
+static int slots[HOOKSLOTS + 1] = { 0 };
+static SubHook **table = NULL;
+
+/* HookSlot {{{ */
+static int
+HookSlot(int type)
+{
+  /* Combine position of type and action bit */
+  return (ffs((type >> 10) & 0x7f) - 1) * 6 + ffs((type >> 17) & 0x1f);
+} /* }}} */
+
+/* HookIndex {{{ */
+static void
+HookIndex(void)
+{
+  int i, slot = 0;
+
+  subtle->flags &= ~SUB_SUBTLE_HOOKS;
+
+  /* Count hooks per slot */
+  memset(slots, 0, sizeof(slots));
+
+  for(i = 0; i < subtle->hooks->ndata; i++)
+    slots[HookSlot(HOOK(subtle->hooks->data[i])->flags & ~SUB_TYPE_HOOK) + 1]++;
+
+  for(i = 0; i < HOOKSLOTS; i++)
+    slots[i + 1] += slots[i];
+
+  /* Fill slots in registration order */
+  table = (SubHook **)subSharedMemoryRealloc(table,
+    MAX(1, subtle->hooks->ndata) * sizeof(SubHook *));
+
+  for(i = 0; i < subtle->hooks->ndata; i++)
+    {
+      SubHook *h = HOOK(subtle->hooks->data[i]);
+
+      slot = HookSlot(h->flags & ~SUB_TYPE_HOOK);
+      table[slots[slot]++] = h;
+    }
+
+  /* Restore slot offsets */
+  for(i = HOOKSLOTS; 0 < i; i--)
+    slots[i] = slots[i - 1];
+  slots[0] = 0;
+
+  subSubtleLogDebugSubtle("HookIndex: hooks=%d\n", subtle->hooks->ndata);
+} /* }}} */
+
  /** subHookNew {{{
   * @brief Create new hook
   * @param[in]  type  Type of hook
@@ -47,20 +99,21 @@ void
 subHookCall(int type,
   void *data)
 {
-  int i;
+  int i, slot = 0;
 
-  /* Call matching hooks */
-  for(i = 0; i < subtle->hooks->ndata; i++)
+  if(subtle->flags & SUB_SUBTLE_HOOKS) HookIndex();
+
+  /* Call hooks of slot */
+  slot = HookSlot(type);
+
+  for(i = slots[slot]; i < slots[slot + 1]; i++)
     {
-      SubHook *h = HOOK(subtle->hooks->data[i]);
+      SubHook *h = table[i];
 
-      if((h->flags & ~SUB_TYPE_HOOK) == type)
-        {
-          subRubyCall(SUB_CALL_HOOKS, h->proc, data);
+      subRubyCall(SUB_CALL_HOOK, (unsigned long)h, data, &h->stats);
 
-          subSubtleLogDebug("call=hook, type=%d, proc=%ld, data=%p\n",
-            type, h->proc, data);
-        }
+      subSubtleLogDebug("call=hook, type=%d, proc=%ld, data=%p\n",
+        type, h->proc, data);
     }
 } /* }}} */
 
@@ -0,0 +1,395 @@
+ /**
+  * @package subtle
+  *
+  * @file Sublet host functions
+  * @copyright (c) 2005-2012 Christoph Kappel <unexist@subforge.org>
+  * @version $Id$
+  *
+  * This program can be distributed under the terms of the GNU GPLv2.
+  * See the file COPYING for details.
+  **/
+
+#include <unistd.h>
+#include <limits.h>
+#include <signal.h>
+#include <sys/poll.h>
+#include "subtle.h"
+
+/* Globals */
+static pid_t pid = -1;
+static int running = -1;
+static long long started = 0, forked = 0;
+
+/* HostSublet {{{ */
+static SubPanel *
+HostSublet(int id)
+{
+  SubPanel *p = NULL;
+
+  /* Only hand out sublets that are still hosted */
+  if((p = PANEL(subArrayGet(subtle->sublets, id))) &&
+      !(p->sublet->flags & SUB_SUBLET_STALL))
+    return p;
+
+  return NULL;
+} /* }}} */
+
+/* HostLoop {{{ */
+static void
+HostLoop(int fd)
+{
+  int i;
+  long long now = 0, next = 0;
+  struct pollfd pfd = { 0 };
+
+  /* Wait for errors on the pipe, they indicate subtle is gone */
+  pfd.fd     = fd;
+  pfd.events = 0;
+
+  while(1)
+    {
+      now  = subSubtleTime();
+      next = -1;
+
+      /* Run expired sublets and find next one */
+      for(i = 0; i < subtle->sublets->ndata; i++)
+        {
+          SubPanel *p = PANEL(subtle->sublets->data[i]);
+
+          if(!(p->sublet->flags & SUB_SUBLET_INTERVAL) ||
+              p->sublet->flags & SUB_SUBLET_STALL)
+            continue;
+
+          if(p->sublet->time <= now)
+            {
+              /* Hand stats of this run over to subtle */
+              memset(&p->sublet->stats, 0, sizeof(SubStats));
+
+              subHostSend(p, SUB_HOST_RUN, NULL, 0);
+              subRubyCall(SUB_CALL_RUN, p->sublet->instance, NULL,
+                &p->sublet->stats);
+              subHostSend(p, SUB_HOST_DONE, (char *)&p->sublet->stats,
+                sizeof(SubStats));
+
+              /* Interval may change during run */
+              if(0 < p->sublet->interval)
+                {
+                  now              = subSubtleTime();
+                  p->sublet->time  = now + p->sublet->interval; ///< Adjust to interval
+                  p->sublet->time -= p->sublet->time % p->sublet->interval;
+                }
+            }
+
+          /* Sublet may have dropped its interval during run */
+          if(p->sublet->flags & SUB_SUBLET_INTERVAL &&
+              (-1 == next || p->sublet->time < next))
+            next = p->sublet->time;
+        }
+
+      /* Nothing left to do, tell subtle we quit on purpose */
+      if(-1 == next)
+        {
+          SubHostMessage msg = { SUB_HOST_EXIT, -1, 0 };
+
+          _exit(-1 == write(fd, &msg, sizeof(SubHostMessage)));
+        }
+
+      /* Sleep until next sublet is due */
+      now = subSubtleTime();
+      if(0 < poll(&pfd, 1, next > now ? (int)(next - now) : 0)) break;
+    }
+
+  _exit(0);
+} /* }}} */
+
+/* Public */
+
+ /** subHostInit {{{
+  * @brief Start sublet host process for interval sublets
+  **/
+
+void
+subHostInit(void)
+{
+  int i, fds[2] = { -1, -1 }, hosted = 0;
+
+  subHostFinish();
+
+  subtle->flags &= ~SUB_SUBTLE_RESPAWN;
+
+  if(!(subtle->flags & SUB_SUBTLE_HOST)) return;
+
+  /* Check if there is anything to host */
+  for(i = 0; i < subtle->sublets->ndata; i++)
+    {
+      SubPanel *p = PANEL(subtle->sublets->data[i]);
+
+      if(p->sublet->flags & SUB_SUBLET_INTERVAL &&
+          !(p->sublet->flags & SUB_SUBLET_STALL))
+        hosted++;
+    }
+
+  if(0 == hosted) return;
+
+  /* Create pipe and fork */
+  if(-1 == pipe(fds))
+    {
+      subSubtleLogWarn("Cannot create sublet host pipe: %s\n",
+        strerror(errno));
+      subtle->flags &= ~SUB_SUBTLE_HOST;
+
+      return;
+    }
+
+  XFlush(subtle->dpy); ///< Don't duplicate pending requests
+
+  switch((pid = subRubyFork()))
+    {
+      case 0: ///< Child
+        close(fds[0]);
+        close(ConnectionNumber(subtle->dpy));
+
+        subtle->flags |= SUB_SUBTLE_HOSTED;
+        subtle->host   = fds[1];
+
+        subIpcFinish(); ///< Leave socket to subtle
+
+        HostLoop(fds[1]);
+        break;
+      case -1: ///< Error
+        subSubtleLogWarn("Cannot fork sublet host\n");
+        subtle->flags &= ~SUB_SUBTLE_HOST;
+
+        close(fds[0]);
+        close(fds[1]);
+        break;
+      default: ///< Parent
+        close(fds[1]);
+
+        subtle->host = fds[0];
+        forked       = subSubtleTime();
+        subEventWatchAdd(subtle->host, NULL, False);
+
+        subSubtleLogDebugSubtle("HostInit: pid=%d, sublets=%d\n",
+          pid, hosted);
+    }
+} /* }}} */
+
+ /** subHostReceive {{{
+  * @brief Read and apply one message of the sublet host
+  **/
+
+void
+subHostReceive(void)
+{
+  char data[PIPE_BUF + 1] = { 0 };
+  SubHostMessage msg = { 0 };
+  SubPanel *p = NULL;
+
+  /* Messages are written at once, so the payload is always there */
+  if(sizeof(SubHostMessage) != read(subtle->host, &msg,
+      sizeof(SubHostMessage)) || 0 > msg.len || PIPE_BUF < msg.len ||
+      (0 < msg.len && msg.len != read(subtle->host, data, msg.len)))
+    {
+      /* Blame running sublet for death of host */
+      if((p = HostSublet(running)))
+        {
+          subSubtleLogWarn("Sublet host died in sublet `%s'\n",
+            p->sublet->name);
+
+          p->sublet->flags |= SUB_SUBLET_STALL;
+        }
+      else if(subSubtleTime() - forked < HOSTRESPAWN)
+        {
+          /* Don't restart a host that dies on its own */
+          subSubtleLogWarn("Sublet host died too fast, "
+            "running sublets in subtle\n");
+
+          subtle->flags &= ~SUB_SUBTLE_HOST;
+        }
+
+      subHostInit();
+
+      return;
+    }
+
+  /* Host exited on purpose, nothing to restart */
+  if(SUB_HOST_EXIT == msg.type)
+    {
+      pid = -1; ///< Already gone
+
+      subHostFinish();
+
+      return;
+    }
+
+  if(!(p = HostSublet(msg.id))) return;
+
+  /* Check message type */
+  switch(msg.type)
+    {
+      case SUB_HOST_RUN:
+        running = msg.id;
+        started = subSubtleTime();
+        break;
+      case SUB_HOST_DONE:
+        running = -1;
+
+        /* Merge stats of run */
+        if(sizeof(SubStats) == msg.len)
+          {
+            SubStats *stats = (SubStats *)data;
+
+            p->sublet->stats.calls   += stats->calls;
+            p->sublet->stats.total   += stats->total;
+            p->sublet->stats.max      = MAX(p->sublet->stats.max, stats->max);
+            p->sublet->stats.objects += stats->objects;
+          }
+
+        subScreenDamage(SUB_PANEL_SUBLET, p->sublet);
+        break;
+      case SUB_HOST_DATA:
+          {
+            SubStyle *s = &subtle->styles.sublets, *style = NULL;
+
+            /* Select style */
+            if(s->styles && (style = subArrayGet(s->styles,
+                p->sublet->styleid)))
+              s = style;
+
+            p->sublet->width = subTextParse(p->sublet->text,
+              subtle->styles.sublets.font, data) + STYLE_WIDTH((*s));
+          }
+        break;
+      case SUB_HOST_STYLE:
+        if(sizeof(int) == msg.len)
+          p->sublet->styleid = *((int *)data);
+        break;
+      case SUB_HOST_SHOW:
+        p->flags &= ~SUB_PANEL_HIDDEN;
+
+        subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
+        break;
+      case SUB_HOST_HIDE:
+        p->flags |= SUB_PANEL_HIDDEN;
+
+        subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
+        break;
+      case SUB_HOST_INTERVAL:
+        if(sizeof(long long) == msg.len)
+          {
+            /* Keep our copy in sync for restarts and fallback */
+            p->sublet->interval = *((long long *)data);
+            p->sublet->time     = subSubtleTime() + p->sublet->interval;
+
+            if(0 < p->sublet->interval)
+              {
+                p->sublet->flags |= SUB_SUBLET_INTERVAL;
+                subEventTimerAdd(p);
+              }
+            else
+              {
+                p->sublet->flags &= ~SUB_SUBLET_INTERVAL;
+                subEventTimerDel(p);
+              }
+          }
+        break;
+    }
+
+  subSubtleLogDebugSubtle("HostReceive: type=%d, sublet=%s, len=%d\n",
+    msg.type, p->sublet->name, msg.len);
+} /* }}} */
+
+ /** subHostCheck {{{
+  * @brief Stop sublets that stall the host
+  * @param[in]  now  Current time in milliseconds
+  * @return Returns time left for the running sublet or \p -1
+  **/
+
+int
+subHostCheck(long long now)
+{
+  SubPanel *p = NULL;
+
+  if(!(p = HostSublet(running))) return -1;
+
+  /* Check run time */
+  if(now - started < HOSTTIMEOUT)
+    return (int)(started + HOSTTIMEOUT - now);
+
+  subSubtleLogWarn("Sublet `%s' took longer than %dms, stopping it\n",
+    p->sublet->name, HOSTTIMEOUT);
+
+  p->sublet->flags |= SUB_SUBLET_STALL;
+
+  subHostInit();
+
+  return -1;
+} /* }}} */
+
+ /** subHostSend {{{
+  * @brief Send message from the sublet host
+  * @param[in]  p     A #SubPanel
+  * @param[in]  type  Message type
+  * @param[in]  data  Message data or \p NULL
+  * @param[in]  len   Data length
+  **/
+
+void
+subHostSend(SubPanel *p,
+  int type,
+  const char *data,
+  int len)
+{
+  char buf[PIPE_BUF];
+  SubHostMessage *msg = (SubHostMessage *)buf;
+
+  assert(p);
+
+  /* Keep message below PIPE_BUF to make the write atomic */
+  if((int)(PIPE_BUF - sizeof(SubHostMessage)) < len)
+    {
+      subSubtleLogWarn("Dropping %d bytes message of sublet `%s', "
+        "host limit is %d\n", len, p->sublet->name,
+        (int)(PIPE_BUF - sizeof(SubHostMessage)));
+
+      return;
+    }
+
+  msg->type = type;
+  msg->id   = subArrayIndex(subtle->sublets, (void *)p);
+  msg->len  = len;
+
+  if(0 < msg->len) memcpy(msg + 1, data, msg->len);
+
+  if(-1 == write(subtle->host, buf, sizeof(SubHostMessage) + msg->len))
+    _exit(0); ///< Subtle is gone
+} /* }}} */
+
+ /** subHostFinish {{{
+  * @brief Stop sublet host process
+  **/
+
+void
+subHostFinish(void)
+{
+  /* Stop host */
+  if(0 < pid)
+    {
+      kill(pid, SIGKILL);
+
+      pid = -1;
+    }
+
+  if(0 < subtle->host)
+    {
+      subEventWatchDel(subtle->host);
+      close(subtle->host);
+
+      subtle->host = 0;
+    }
+
+  running = -1;
+} /* }}} */
+
+// vim:ts=2:bs=2:sw=2:et:fdm=marker
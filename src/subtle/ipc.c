@@ -0,0 +1,230 @@
+ /**
+  * @package subtle
+  *
+  * @file Socket functions
+  * @copyright (c) 2005-2012 Christoph Kappel <unexist@subforge.org>
+  * @version $Id$
+  *
+  * This program can be distributed under the terms of the GNU GPLv2.
+  * See the file COPYING for details.
+  **/
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "subtle.h"
+
+/* Typedefs {{{ */
+typedef struct ipcclient_t
+{
+  int  fd, nbuf;                                                  ///< Client descriptor, buffer length
+  char *buf;                                                      ///< Client buffer
+} IpcClient;
+/* }}} */
+
+/* Globals */
+static IpcClient *clients = NULL;
+static int nclients = 0;
+static char path[sizeof(((struct sockaddr_un *)0)->sun_path)] = { 0 };
+
+#define IPCBUFLEN (sizeof(SubIpcMessage) + IPCMAXLEN)
+
+/* IpcDrop {{{ */
+static void
+IpcDrop(int idx)
+{
+  if(!(subtle->flags & SUB_SUBTLE_HOSTED))
+    subEventWatchDel(clients[idx].fd);
+
+  close(clients[idx].fd);
+  free(clients[idx].buf);
+
+  subSubtleLogDebugSubtle("IpcDrop: fd=%d\n", clients[idx].fd);
+
+  /* Fill gap with last client */
+  if(idx != --nclients) clients[idx] = clients[nclients];
+} /* }}} */
+
+/* IpcAccept {{{ */
+static void
+IpcAccept(void)
+{
+  int fd = -1;
+
+  if(-1 == (fd = accept(subtle->ipc, NULL, NULL))) return;
+
+  fcntl(fd, F_SETFL, O_NONBLOCK);
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+  clients = (IpcClient *)subSharedMemoryRealloc(clients,
+    (nclients + 1) * sizeof(IpcClient));
+
+  clients[nclients].fd   = fd;
+  clients[nclients].nbuf = 0;
+  clients[nclients].buf  = (char *)subSharedMemoryAlloc(IPCBUFLEN,
+    sizeof(char));
+
+  nclients++;
+
+  subEventWatchAdd(fd, NULL, False);
+
+  subSubtleLogDebugSubtle("IpcAccept: fd=%d\n", fd);
+} /* }}} */
+
+/* IpcRead {{{ */
+static void
+IpcRead(int idx)
+{
+  int n, off = 0;
+  IpcClient *c = &clients[idx];
+
+  /* Read once, the watch fires again for the rest */
+  if(0 >= (n = read(c->fd, c->buf + c->nbuf, IPCBUFLEN - c->nbuf)))
+    {
+      if(0 == n || (EAGAIN != errno && EINTR != errno)) IpcDrop(idx);
+
+      return;
+    }
+
+  c->nbuf += n;
+
+  /* Handle complete messages */
+  while(c->nbuf - off >= (int)sizeof(SubIpcMessage))
+    {
+      SubIpcMessage msg;
+      SubIpcData extra;
+
+      memcpy(&msg, c->buf + off, sizeof(SubIpcMessage));
+
+      if(0 > msg.len || IPCMAXLEN < msg.len)
+        {
+          subSubtleLogWarn("Dropping client with malformed message\n");
+          IpcDrop(idx);
+
+          return;
+        }
+
+      if(c->nbuf - off < (int)sizeof(SubIpcMessage) + msg.len) break;
+
+      off += sizeof(SubIpcMessage);
+
+      /* Pass extra data along as is */
+      extra.data = c->buf + off;
+      extra.len  = msg.len;
+
+      subEventMessage(msg.win, msg.type, msg.format, &msg.data,
+        0 < msg.len ? &extra : NULL);
+
+      off += msg.len;
+    }
+
+  /* Keep partial message */
+  if(0 < off)
+    {
+      memmove(c->buf, c->buf + off, c->nbuf - off);
+      c->nbuf -= off;
+    }
+} /* }}} */
+
+/* Public */
+
+ /** subIpcInit {{{
+  * @brief Create socket for subtlext
+  **/
+
+void
+subIpcInit(void)
+{
+  struct sockaddr_un addr = { 0 };
+
+  subIpcFinish();
+
+  addr.sun_family = AF_UNIX;
+  subSharedSocketPath(subtle->dpy, addr.sun_path, sizeof(addr.sun_path));
+
+  /* Remove stale socket of previous run */
+  unlink(addr.sun_path);
+
+  if(-1 == (subtle->ipc = socket(AF_UNIX,
+      SOCK_STREAM|SOCK_NONBLOCK|SOCK_CLOEXEC, 0)) ||
+      -1 == bind(subtle->ipc, (struct sockaddr *)&addr, sizeof(addr)) ||
+      -1 == listen(subtle->ipc, SOMAXCONN))
+    {
+      subSubtleLogWarn("Cannot create socket `%s': %s\n",
+        addr.sun_path, strerror(errno));
+
+      if(0 <= subtle->ipc) close(subtle->ipc);
+      subtle->ipc = 0;
+
+      return;
+    }
+
+  strncpy(path, addr.sun_path, sizeof(path) - 1);
+  subEventWatchAdd(subtle->ipc, NULL, False);
+
+  subSubtleLogDebugSubtle("IpcInit: path=%s\n", path);
+} /* }}} */
+
+ /** subIpcReceive {{{
+  * @brief Handle socket activity
+  * @param[in]  fd  File descriptor
+  * @retval  True   Descriptor belongs to socket
+  * @retval  False  Unknown descriptor
+  **/
+
+int
+subIpcReceive(int fd)
+{
+  int i;
+
+  if(fd == subtle->ipc)
+    {
+      IpcAccept();
+
+      return True;
+    }
+
+  /* Find client */
+  for(i = 0; i < nclients; i++)
+    {
+      if(fd == clients[i].fd)
+        {
+          IpcRead(i);
+
+          return True;
+        }
+    }
+
+  return False;
+} /* }}} */
+
+ /** subIpcFinish {{{
+  * @brief Close socket and clients
+  **/
+
+void
+subIpcFinish(void)
+{
+  while(0 < nclients) IpcDrop(nclients - 1);
+
+  if(clients)
+    {
+      free(clients);
+      clients = NULL;
+    }
+
+  if(0 < subtle->ipc)
+    {
+      if(!(subtle->flags & SUB_SUBTLE_HOSTED))
+        {
+          subEventWatchDel(subtle->ipc);
+          unlink(path);
+        }
+
+      close(subtle->ipc);
+      subtle->ipc = 0;
+    }
+} /* }}} */
+
+// vim:ts=2:bs=2:sw=2:et:fdm=marker
@@ -12,6 +12,27 @@
 
 #include "subtle.h"
 
+#ifdef HAVE_X11_EXTENSIONS_XRENDER_H
+#define PIECES 64                                                 ///< Cached panel pieces
+
+/* Typedef {{{ */
+typedef struct panelpiece_t
+{
+  void          *key;                                             ///< Piece owner
+  SubStyle      style;                                            ///< Piece style
+  unsigned long bg, used;                                         ///< Piece background, last use
+  int           width;                                            ///< Piece width
+  Pixmap        pixmap;                                           ///< Piece pixmap
+  Picture       picture;                                          ///< Piece picture
+} PanelPiece;
+/* }}} */
+
+/* Globals */
+static PanelPiece pieces[PIECES];
+static int npieces = 0;
+static unsigned long piececlock = 0;
+#endif /* HAVE_X11_EXTENSIONS_XRENDER_H */
+
 /* PanelRect {{{ */
 static void
 PanelRect(Drawable drawable,
@@ -107,7 +128,8 @@ PanelViewStyle(SubView *v,
         {
           if(subtle->styles.focus && focus)
             style = subtle->styles.focus;
-          else if(subtle->styles.occupied && subtle->client_tags & v->tags)
+          else if(subtle->styles.occupied && subSharedBitsAny(&subtle->client_tags,
+              &v->tags))
             style = subtle->styles.occupied;
         }
 
@@ -115,12 +137,13 @@ PanelViewStyle(SubView *v,
       subStyleMerge(s, !style ? &subtle->styles.views : style);
 
       /* Apply modifiers */
-      if(subtle->styles.urgent && subtle->urgent_tags & v->tags)
+      if(subtle->styles.urgent &&
+          subSharedBitsAny(&subtle->urgent_tags, &v->tags))
         subStyleMerge(s, subtle->styles.urgent);
 
       if(subtle->styles.visible)
         {
-          if(subtle->visible_views & (1L << (idx + 1)))
+          if(subSharedBitsTest(&subtle->visible_views, idx + 1))
             subStyleMerge(s, subtle->styles.visible);
         }
 
@@ -141,6 +164,196 @@ PanelSubletStyle(SubPanel *p)
   return s ? s : &subtle->styles.sublets;
 } /* }}} */
 
+/* PanelView {{{ */
+static void
+PanelView(SubView *v,
+  int vx,
+  SubStyle *s,
+  Drawable drawable)
+{
+  int x = STYLE_LEFT((*s));
+
+  /* Set window background and border*/
+  PanelRect(drawable, vx, v->width, s);
+
+  /* Draw view icon and/or text */
+  if(v->flags & SUB_VIEW_ICON)
+    {
+      int y = 0, icony = 0;
+
+      y     = s->font->y + STYLE_TOP((*s));
+      icony = v->icon->height > y ? s->margin.top : y - v->icon->height;
+
+      subSharedDrawIcon(subtle->dpy, subtle->gcs.draw,
+        drawable, vx + x, icony, v->icon->width,
+        v->icon->height, s->icon, s->bg, v->icon->pixmap,
+        v->icon->bitmap);
+    }
+
+  if(!(v->flags & SUB_VIEW_ICON_ONLY))
+    {
+      if(v->flags & SUB_VIEW_ICON) x += v->icon->width + 3;
+
+      subSharedDrawString(subtle->dpy, subtle->gcs.draw,
+        s->font, drawable, vx + x, s->font->y +
+        STYLE_TOP((*s)), s->fg, s->bg, v->name, strlen(v->name));
+    }
+} /* }}} */
+
+/* PanelIcon {{{ */
+static void
+PanelIcon(SubIcon *i,
+  int x,
+  Drawable drawable)
+{
+  int y = 0, icony = 0;
+
+  y     = subtle->styles.separator.font->y +
+    STYLE_TOP(subtle->styles.separator);
+  icony = i->height > y ? subtle->styles.separator.margin.top :
+    y - i->height;
+
+  subSharedDrawIcon(subtle->dpy, subtle->gcs.draw,
+    drawable, x + 2 + subtle->styles.separator.padding.left, icony,
+    i->width, i->height, subtle->styles.sublets.fg,
+    subtle->styles.sublets.bg, i->pixmap, i->bitmap);
+} /* }}} */
+
+/* PanelDraw {{{ */
+static void
+PanelDraw(int type,
+  void *key,
+  int x,
+  SubStyle *s,
+  Drawable drawable)
+{
+  /* Draw piece by type */
+  switch(type)
+    {
+      case SUB_PANEL_ICON:
+        PanelIcon((SubIcon *)key, x, drawable);
+        break;
+      case SUB_PANEL_VIEWS:
+        PanelView((SubView *)key, x, s, drawable);
+        break;
+      default:
+        PanelSeparator(x, s, drawable);
+    }
+} /* }}} */
+
+#ifdef HAVE_X11_EXTENSIONS_XRENDER_H
+/* PanelPieceStyle {{{ */
+static int
+PanelPieceStyle(SubStyle *s1,
+  SubStyle *s2)
+{
+  /* Compare everything that ends up in the piece */
+  return s1->fg == s2->fg && s1->bg == s2->bg && s1->icon == s2->icon &&
+    s1->top == s2->top && s1->right == s2->right &&
+    s1->bottom == s2->bottom && s1->left == s2->left &&
+    s1->font == s2->font && s1->separator == s2->separator &&
+    0 == memcmp(&s1->border, &s2->border, sizeof(s1->border)) &&
+    0 == memcmp(&s1->padding, &s2->padding, sizeof(s1->padding)) &&
+    0 == memcmp(&s1->margin, &s2->margin, sizeof(s1->margin));
+} /* }}} */
+
+/* PanelPieceGet {{{ */
+static PanelPiece *
+PanelPieceGet(SubPanel *p,
+  void *key,
+  SubStyle *s,
+  int width,
+  Drawable drawable,
+  int *fresh)
+{
+  int i;
+  unsigned long bg = 0;
+  PanelPiece *piece = NULL;
+
+  /* Pieces are opaque, so skip stipple and foreign drawables */
+  if(!(subtle->flags & SUB_SUBTLE_COMPOSITE) || !p->screen ||
+      !p->screen->picture || drawable != p->screen->drawable ||
+      p->screen->flags & SUB_SCREEN_STIPPLE || 0 >= width)
+    return NULL;
+
+  bg = p->flags & SUB_PANEL_BOTTOM ? subtle->styles.subtle.bottom :
+    subtle->styles.subtle.top;
+
+  /* Find matching piece */
+  for(i = 0; i < npieces; i++)
+    {
+      if(pieces[i].key == key && pieces[i].width == width &&
+          pieces[i].bg == bg && PanelPieceStyle(&pieces[i].style, s))
+        {
+          pieces[i].used = ++piececlock;
+          *fresh         = False;
+
+          return &pieces[i];
+        }
+    }
+
+  /* Take free or replace least recently used piece */
+  if(PIECES > npieces) piece = &pieces[npieces++];
+  else
+    {
+      for(i = 0; i < npieces; i++)
+        if(!piece || pieces[i].used < piece->used) piece = &pieces[i];
+    }
+
+  if(piece->picture) XRenderFreePicture(subtle->dpy, piece->picture);
+  if(piece->pixmap)  XFreePixmap(subtle->dpy, piece->pixmap);
+
+  piece->key     = key;
+  piece->style   = *s;
+  piece->bg      = bg;
+  piece->width   = width;
+  piece->used    = ++piececlock;
+  piece->pixmap  = XCreatePixmap(subtle->dpy, ROOT, width, subtle->ph,
+    XDefaultDepth(subtle->dpy, DefaultScreen(subtle->dpy)));
+  piece->picture = XRenderCreatePicture(subtle->dpy, piece->pixmap,
+    XRenderFindVisualFormat(subtle->dpy,
+    DefaultVisual(subtle->dpy, DefaultScreen(subtle->dpy))), 0, NULL);
+
+  /* Fill with panel background */
+  XSetForeground(subtle->dpy, subtle->gcs.draw, bg);
+  XFillRectangle(subtle->dpy, piece->pixmap, subtle->gcs.draw,
+    0, 0, width, subtle->ph);
+
+  *fresh = True;
+
+  return piece;
+} /* }}} */
+#endif /* HAVE_X11_EXTENSIONS_XRENDER_H */
+
+/* PanelRender {{{ */
+static void
+PanelRender(SubPanel *p,
+  int type,
+  void *key,
+  int x,
+  int width,
+  SubStyle *s,
+  Drawable drawable)
+{
+#ifdef HAVE_X11_EXTENSIONS_XRENDER_H
+  int fresh = False;
+  PanelPiece *piece = NULL;
+
+  /* Render piece once and composite it afterwards */
+  if((piece = PanelPieceGet(p, key, s, width, drawable, &fresh)))
+    {
+      if(fresh) PanelDraw(type, key, 0, s, piece->pixmap);
+
+      XRenderComposite(subtle->dpy, PictOpSrc, piece->picture, None,
+        p->screen->picture, 0, 0, 0, 0, x, 0, width, subtle->ph);
+
+      return;
+    }
+#endif /* HAVE_X11_EXTENSIONS_XRENDER_H */
+
+  PanelDraw(type, key, x, s, drawable);
+} /* }}} */
+
 /* Public */
 
  /** subPanelNew {{{
@@ -272,7 +485,7 @@ subPanelUpdate(SubPanel *p)
 
                 /* Skip dynamic views */
                 if(v->flags & SUB_VIEW_DYNAMIC &&
-                    !(subtle->client_tags & v->tags))
+                    !subSharedBitsAny(&subtle->client_tags, &v->tags))
                   continue;
 
                 PanelViewStyle(v, i, (p->screen->viewid == i), &s);
@@ -319,7 +532,9 @@ subPanelRender(SubPanel *p,
   /* Draw separator before panel */
   if(p->flags & SUB_PANEL_SEPARATOR1 && subtle->styles.separator.separator)
     {
-      PanelSeparator(p->x - subtle->styles.separator.separator->width,
+      PanelRender(p, SUB_PANEL_SEPARATOR1, &subtle->styles.separator,
+        p->x - subtle->styles.separator.separator->width,
+        subtle->styles.separator.separator->width,
         &subtle->styles.separator, drawable);
     }
 
@@ -328,19 +543,8 @@ subPanelRender(SubPanel *p,
       SUB_PANEL_SUBLET|SUB_PANEL_TITLE|SUB_PANEL_VIEWS))
     {
       case SUB_PANEL_ICON: /* {{{ */
-          {
-            int y = 0, icony = 0;
-
-            y     = subtle->styles.separator.font->y +
-              STYLE_TOP(subtle->styles.separator);
-            icony = p->icon->height > y ? subtle->styles.separator.margin.top :
-              y - p->icon->height;
-
-            subSharedDrawIcon(subtle->dpy, subtle->gcs.draw,
-              drawable, p->x + 2 + subtle->styles.separator.padding.left, icony,
-              p->icon->width, p->icon->height, subtle->styles.sublets.fg,
-              subtle->styles.sublets.bg, p->icon->pixmap, p->icon->bitmap);
-          }
+        PanelRender(p, SUB_PANEL_ICON, p->icon, p->x, p->width,
+          &subtle->styles.sublets, drawable);
         break; /* }}} */
       case SUB_PANEL_KEYCHAIN: /* {{{ */
         if(p->keychain && p->keychain->keys)
@@ -415,51 +619,25 @@ subPanelRender(SubPanel *p,
             /* View buttons */
             for(i = 0; i < subtle->views->ndata; i++)
               {
-                int x = 0;
                 SubView *v = VIEW(subtle->views->data[i]);
 
                 /* Skip dynamic views */
                 if(v->flags & SUB_VIEW_DYNAMIC &&
-                    !(subtle->client_tags & v->tags))
+                    !subSharedBitsAny(&subtle->client_tags, &v->tags))
                   continue;
 
                 PanelViewStyle(v, i, (p->screen->viewid == i), &s);
-
-                /* Set window background and border*/
-                PanelRect(drawable, vx, v->width, &s);
-
-                x += STYLE_LEFT((s));
-
-                /* Draw view icon and/or text */
-                if(v->flags & SUB_VIEW_ICON)
-                  {
-                    int y = 0, icony = 0;
-
-                    y     = s.font->y + STYLE_TOP((s));
-                    icony = v->icon->height > y ? s.margin.top :
-                      y - v->icon->height;
-
-                    subSharedDrawIcon(subtle->dpy, subtle->gcs.draw,
-                      drawable, vx + x, icony, v->icon->width,
-                      v->icon->height, s.icon, s.bg, v->icon->pixmap,
-                      v->icon->bitmap);
-                  }
-
-                if(!(v->flags & SUB_VIEW_ICON_ONLY))
-                  {
-                    if(v->flags & SUB_VIEW_ICON) x += v->icon->width + 3;
-
-                    subSharedDrawString(subtle->dpy, subtle->gcs.draw,
-                      s.font, drawable, vx + x, s.font->y +
-                      STYLE_TOP((s)), s.fg, s.bg, v->name, strlen(v->name));
-                  }
+                PanelRender(p, SUB_PANEL_VIEWS, v, vx, v->width, &s, drawable);
 
                 vx += v->width;
 
                 /* Draw view separator if any */
                 if(subtle->styles.viewsep && i < subtle->views->ndata - 1)
                   {
-                    PanelSeparator(vx, subtle->styles.viewsep, drawable);
+                    PanelRender(p, SUB_PANEL_SEPARATOR1,
+                      subtle->styles.viewsep, vx,
+                      subtle->styles.viewsep->separator->width,
+                      subtle->styles.viewsep, drawable);
 
                     vx += subtle->styles.viewsep->separator->width;
                   }
@@ -474,38 +652,13 @@ subPanelRender(SubPanel *p,
       SubStyle *s = p->flags & SUB_PANEL_SUBLET && subtle->styles.subletsep ?
         subtle->styles.subletsep : &subtle->styles.separator;
 
-      PanelSeparator(p->x + p->width, s, drawable);
+      PanelRender(p, SUB_PANEL_SEPARATOR2, s, p->x + p->width,
+        s->separator->width, s, drawable);
     }
 
   subSubtleLogDebugSubtle("Render\n");
 } /* }}} */
 
- /** subPanelCompare {{{
-  * @brief Compare two panels
-  * @param[in]  a  A #SubPanel
-  * @param[in]  b  A #SubPanel
-  * @return Returns the result of the comparison of both panels
-  * @retval  -1  a is smaller
-  * @retval  0   a and b are equal
-  * @retval  1   a is greater
-  **/
-
-int
-subPanelCompare(const void *a,
-  const void *b)
-{
-  SubPanel *p1 = *(SubPanel **)a, *p2 = *(SubPanel **)b;
-
-  assert(a && b);
-
-  /* Include only interval sublets */
-  if(!(p1->sublet->flags & (SUB_SUBLET_INTERVAL))) return 1;
-  if(!(p2->sublet->flags & (SUB_SUBLET_INTERVAL))) return -1;
-
-  return p1->sublet->time < p2->sublet->time ? -1 :
-    (p1->sublet->time == p2->sublet->time ? 0 : 1);
-} /* }}} */
-
  /** subPanelAction {{{
   * @brief Handle panel action based on type
   * @param[in]  panels  A #SubArray
@@ -552,23 +705,24 @@ subPanelAction(SubArray *panels,
                 switch(type)
                   {
                     case SUB_PANEL_OUT:
-                      subRubyCall(SUB_CALL_OUT, p->sublet->instance, NULL);
+                      subRubyCall(SUB_CALL_OUT, p->sublet->instance, NULL,
+                        &p->sublet->stats);
                       break;
                     case SUB_PANEL_OVER:
-                      subRubyCall(SUB_CALL_OVER, p->sublet->instance, NULL);
+                      subRubyCall(SUB_CALL_OVER, p->sublet->instance, NULL,
+                        &p->sublet->stats);
                       break;
                     case SUB_PANEL_DOWN:
                         {
                           int args[3] = { x - p->x, y, button };
 
                           subRubyCall(SUB_CALL_DOWN, p->sublet->instance,
-                            (void *)&args);
+                            (void *)&args, &p->sublet->stats);
                         }
                       break;
                   }
 
-                subScreenUpdate();
-                subScreenRender();
+                subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
                 break; /* }}} */
               case SUB_PANEL_VIEWS: /* {{{ */
                   {
@@ -580,7 +734,7 @@ subPanelAction(SubArray *panels,
 
                         /* Skip dynamic views */
                         if(v->flags & SUB_VIEW_DYNAMIC &&
-                            !(subtle->client_tags & v->tags))
+                            !subSharedBitsAny(&subtle->client_tags, &v->tags))
                           continue;
 
                         /* Check if x is in view rect */
@@ -674,8 +828,8 @@ subPanelPublish(void)
     }
 
   /* EWMH: Sublet list and geometries */
-  subSharedPropertySetStrings(subtle->dpy, ROOT,
-    subEwmhGet(SUB_EWMH_SUBTLE_SUBLET_LIST), sublets, subtle->sublets->ndata);
+  subEwmhSetStrings(ROOT, SUB_EWMH_SUBTLE_SUBLET_LIST, sublets,
+    subtle->sublets->ndata);
 
   /* Tidy up */
   for(i = 0; i < subtle->sublets->ndata; i++)
@@ -683,11 +837,35 @@ subPanelPublish(void)
 
   subSubtleLogDebugSubtle("Publish: sublets=%d\n", subtle->sublets->ndata);
 
-  XSync(subtle->dpy, False); ///< Sync all changes
+  subtle->flags |= SUB_SUBTLE_PUBLISH; ///< Sync once per loop
 
   free(sublets);
 } /* }}} */
 
+ /** subPanelPurge {{{
+  * @brief Purge cached panel pieces
+  **/
+
+void
+subPanelPurge(void)
+{
+#ifdef HAVE_X11_EXTENSIONS_XRENDER_H
+  int i;
+
+  /* Free pictures and pixmaps */
+  for(i = 0; i < npieces; i++)
+    {
+      if(pieces[i].picture) XRenderFreePicture(subtle->dpy, pieces[i].picture);
+      if(pieces[i].pixmap)  XFreePixmap(subtle->dpy, pieces[i].pixmap);
+    }
+
+  subSubtleLogDebugSubtle("Purge: pieces=%d\n", npieces);
+
+  memset(pieces, 0, sizeof(pieces));
+  npieces = 0;
+#endif /* HAVE_X11_EXTENSIONS_XRENDER_H */
+} /* }}} */
+
  /** subPanelKill {{{
   * @brief Kill a panel
   * @param[in]  p  A #SubPanel
@@ -704,6 +882,8 @@ subPanelKill(SubPanel *p)
     {
       case SUB_PANEL_COPY: break;
       case SUB_PANEL_ICON: /* {{{ */
+        subPanelPurge(); ///< Pieces are keyed by icon
+
         if(p->icon) free(p->icon);
         break; /* }}} */
       case SUB_PANEL_KEYCHAIN: /* {{{ */
@@ -720,17 +900,17 @@ subPanelKill(SubPanel *p)
           {
             /* Call unload */
             if(p->sublet->flags & SUB_SUBLET_UNLOAD)
-              subRubyCall(SUB_CALL_UNLOAD, p->sublet->instance, NULL);
+              subRubyCall(SUB_CALL_UNLOAD, p->sublet->instance, NULL,
+                &p->sublet->stats);
 
             subRubyRelease(p->sublet->instance);
 
+            /* Remove timer */
+            if(p->sublet->timer) subEventTimerDel(p);
+
             /* Remove socket watch */
             if(p->sublet->flags & SUB_SUBLET_SOCKET)
-              {
-                XDeleteContext(subtle->dpy, subtle->windows.support,
-                  p->sublet->watch);
-                subEventWatchDel(p->sublet->watch);
-              }
+              subEventWatchDel(p->sublet->watch);
 
 #ifdef HAVE_SYS_INOTIFY_H
             /* Remove inotify watch */
@@ -738,7 +918,7 @@ subPanelKill(SubPanel *p)
               {
                 XDeleteContext(subtle->dpy, subtle->windows.support,
                   p->sublet->watch);
-                inotify_rm_watch(subtle->notify, p->sublet->interval);
+                inotify_rm_watch(subtle->notify, p->sublet->watch);
               }
 #endif /* HAVE_SYS_INOTIFY_H */
 
@@ -17,6 +17,7 @@
 #include <fnmatch.h>
 #include <fcntl.h>
 #include <ctype.h>
+#include <time.h>
 #include <ruby.h>
 #include <ruby/encoding.h>
 #include <X11/Xresource.h>
@@ -48,8 +49,138 @@ typedef struct rubymethods_t
   VALUE sym, real;
   int   flags, arity;
 } RubyMethods;
+
+typedef struct rubyhooks_t
+{
+  const char *name;
+  int        flags;
+} RubyHooks;
 /* }}} */
 
+/* Hooks {{{ */
+static const RubyHooks hooks[] =
+{
+  { "start",          SUB_HOOK_START                                 },
+  { "exit",           SUB_HOOK_EXIT                                  },
+  { "tile",           SUB_HOOK_TILE                                  },
+  { "reload",         SUB_HOOK_RELOAD                                },
+  { "client_create",  (SUB_HOOK_TYPE_CLIENT|SUB_HOOK_ACTION_CREATE)  },
+  { "client_mode",    (SUB_HOOK_TYPE_CLIENT|SUB_HOOK_ACTION_MODE)    },
+  { "client_gravity", (SUB_HOOK_TYPE_CLIENT|SUB_HOOK_ACTION_GRAVITY) },
+  { "client_focus",   (SUB_HOOK_TYPE_CLIENT|SUB_HOOK_ACTION_FOCUS)   },
+  { "client_kill",    (SUB_HOOK_TYPE_CLIENT|SUB_HOOK_ACTION_KILL)    },
+  { "tag_create",     (SUB_HOOK_TYPE_TAG|SUB_HOOK_ACTION_CREATE)     },
+  { "tag_kill",       (SUB_HOOK_TYPE_TAG|SUB_HOOK_ACTION_KILL)       },
+  { "view_create",    (SUB_HOOK_TYPE_VIEW|SUB_HOOK_ACTION_CREATE)    },
+  { "view_focus",     (SUB_HOOK_TYPE_VIEW|SUB_HOOK_ACTION_FOCUS)     },
+  { "view_kill",      (SUB_HOOK_TYPE_VIEW|SUB_HOOK_ACTION_KILL)      }
+};
+/* }}} */
+
+/* RubyTime {{{ */
+static long long
+RubyTime(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+} /* }}} */
+
+/* RubyObjects {{{ */
+static size_t
+RubyObjects(void)
+{
+#ifdef HAVE_RB_GC_STAT
+  static VALUE key = Qnil;
+
+  /* Look up symbol once, rb_gc_stat is called twice per call */
+  if(NIL_P(key)) key = CHAR2SYM("total_allocated_objects");
+
+  return rb_gc_stat(key);
+#else /* HAVE_RB_GC_STAT */
+  return 0;
+#endif /* HAVE_RB_GC_STAT */
+} /* }}} */
+
+/* RubyStatsEntry {{{ */
+static char *
+RubyStatsEntry(const char *type,
+  const char *name,
+  SubStats *stats)
+{
+  int len = 0;
+  char *entry = NULL;
+
+  /* Name goes last, it may contain anything */
+  len = snprintf(NULL, 0, "%s#%lu#%lld#%lld#%lu#%s", type, stats->calls,
+    stats->total, stats->max, stats->objects, name) + 1;
+
+  entry = (char *)subSharedMemoryAlloc(len, sizeof(char));
+  snprintf(entry, len, "%s#%lu#%lld#%lld#%lu#%s", type, stats->calls,
+    stats->total, stats->max, stats->objects, name);
+
+  return entry;
+} /* }}} */
+
+/* RubyStats {{{ */
+static char **
+RubyStats(int *nlist)
+{
+  int i, j;
+  char **list = NULL;
+  SubStats events[4] = { { 0 } };
+  const char *names[] = { "watch_add", "watch_del", "wakeup", "ready" };
+
+  /* Alloc space */
+  list = (char **)subSharedMemoryAlloc(subtle->sublets->ndata +
+    LENGTH(hooks) + LENGTH(names), sizeof(char *));
+
+  *nlist = 0;
+
+  /* Sublets */
+  for(i = 0; i < subtle->sublets->ndata; i++)
+    {
+      SubSublet *s = PANEL(subtle->sublets->data[i])->sublet;
+
+      list[(*nlist)++] = RubyStatsEntry("sublet", s->name, &s->stats);
+    }
+
+  /* Hooks per type */
+  for(i = 0; LENGTH(hooks) > i; i++)
+    {
+      int nhooks = 0;
+      SubStats stats = { 0 };
+
+      for(j = 0; j < subtle->hooks->ndata; j++)
+        {
+          SubHook *h = HOOK(subtle->hooks->data[j]);
+
+          if((h->flags & ~SUB_TYPE_HOOK) == hooks[i].flags)
+            {
+              stats.calls   += h->stats.calls;
+              stats.total   += h->stats.total;
+              stats.max      = MAX(stats.max, h->stats.max);
+              stats.objects += h->stats.objects;
+
+              nhooks++;
+            }
+        }
+
+      if(0 < nhooks)
+        list[(*nlist)++] = RubyStatsEntry("hook", hooks[i].name, &stats);
+    }
+
+  /* Event loop counters */
+  subEventStats(events);
+
+  for(i = 0; LENGTH(names) > i; i++)
+    list[(*nlist)++] = RubyStatsEntry("event", names[i], &events[i]);
+
+  return list;
+} /* }}} */
+
 /* RubyBacktrace {{{ */
 static void
 RubyBacktrace(void)
@@ -99,6 +230,26 @@ RubyReceiver(unsigned long instance,
   return receiver == instance;
 } /* }}} */
 
+/* RubyTagsToValue {{{ */
+static VALUE
+RubyTagsToValue(TAGS *tags)
+{
+  int i;
+  VALUE value = INT2FIX(0);
+
+  /* Find highest used word */
+  for(i = BITSWORDS - 1; 0 < i && 0 == tags->words[i]; i--);
+
+  /* Integers grow as needed */
+  for(; 0 <= i; i--)
+    {
+      value = rb_funcall(value, rb_intern("<<"), 1, INT2FIX(32));
+      value = rb_funcall(value, rb_intern("|"), 1, UINT2NUM(tags->words[i]));
+    }
+
+  return value;
+} /* }}} */
+
 /* RubyFont {{{ */
 static SubFont *
 RubyFont(const char *fontname)
@@ -159,7 +310,7 @@ RubySubtleToSubtlext(void *data)
           /* Set properties */
           rb_iv_set(object, "@win",      LONG2NUM(c->win));
           rb_iv_set(object, "@flags",    INT2FIX(flags));
-          rb_iv_set(object, "@tags",     INT2FIX(c->tags));
+          rb_iv_set(object, "@tags",     RubyTagsToValue(&c->tags));
           rb_iv_set(object, "@name",     rb_str_new2(c->name));
           rb_iv_set(object, "@instance", rb_str_new2(c->instance));
           rb_iv_set(object, "@klass",    rb_str_new2(c->klass));
@@ -232,7 +383,7 @@ RubySubtleToSubtlext(void *data)
 
           /* Set properties */
           rb_iv_set(object, "@id",   INT2FIX(id));
-          rb_iv_set(object, "@tags", INT2FIX(v->tags));
+          rb_iv_set(object, "@tags", RubyTagsToValue(&v->tags));
         } /* }}} */
     }
 
@@ -555,36 +706,39 @@ RubyEvalHook(VALUE event,
   int i;
   SubHook *h = NULL;
 
-  RubySymbols hooks[] =
-  {
-    { CHAR2SYM("start"),          SUB_HOOK_START                                 },
-    { CHAR2SYM("exit"),           SUB_HOOK_EXIT                                  },
-    { CHAR2SYM("tile"),           SUB_HOOK_TILE                                  },
-    { CHAR2SYM("reload"),         SUB_HOOK_RELOAD                                },
-    { CHAR2SYM("client_create"),  (SUB_HOOK_TYPE_CLIENT|SUB_HOOK_ACTION_CREATE)  },
-    { CHAR2SYM("client_mode"),    (SUB_HOOK_TYPE_CLIENT|SUB_HOOK_ACTION_MODE)    },
-    { CHAR2SYM("client_gravity"), (SUB_HOOK_TYPE_CLIENT|SUB_HOOK_ACTION_GRAVITY) },
-    { CHAR2SYM("client_focus"),   (SUB_HOOK_TYPE_CLIENT|SUB_HOOK_ACTION_FOCUS)   },
-    { CHAR2SYM("client_kill"),    (SUB_HOOK_TYPE_CLIENT|SUB_HOOK_ACTION_KILL)    },
-    { CHAR2SYM("tag_create"),     (SUB_HOOK_TYPE_TAG|SUB_HOOK_ACTION_CREATE)     },
-    { CHAR2SYM("tag_kill"),       (SUB_HOOK_TYPE_TAG|SUB_HOOK_ACTION_KILL)       },
-    { CHAR2SYM("view_create"),    (SUB_HOOK_TYPE_VIEW|SUB_HOOK_ACTION_CREATE)    },
-    { CHAR2SYM("view_focus"),     (SUB_HOOK_TYPE_VIEW|SUB_HOOK_ACTION_FOCUS)     },
-    { CHAR2SYM("view_kill"),      (SUB_HOOK_TYPE_VIEW|SUB_HOOK_ACTION_KILL)      }
-  };
-
   if(subtle->flags & SUB_SUBTLE_CHECK) return; ///< Skip on check
 
   /* Generic hooks */
   for(i = 0; LENGTH(hooks) > i; i++)
     {
-      if(hooks[i].sym == event)
+      if(CHAR2SYM(hooks[i].name) == event)
         {
           /* Create new hook */
           if((h = subHookNew(hooks[i].flags, proc)))
             {
+              /* Resolve receiver, method and arity once */
+              if(rb_obj_is_instance_of(proc, rb_cMethod))
+                {
+                  int arity = FIX2INT(rb_funcall(proc, rb_intern("arity"),
+                    0, NULL));
+
+                  /* Keep the method object, names of generic sublet
+                   * hooks are reused for every block */
+                  h->recv  = rb_funcall(proc, rb_intern("receiver"), 0, NULL);
+                  h->meth  = rb_intern("call");
+                  h->arity = -1 == arity ? 2 : MINMAX(arity, 1, 2);
+                }
+              else
+                {
+                  h->recv  = Qnil;
+                  h->meth  = rb_intern("call");
+                  h->arity = MINMAX(rb_proc_arity(proc), 0, 1);
+                }
+
               subArrayPush(subtle->hooks, (void *)h);
               rb_ary_push(shelter, proc); ///< Protect from GC
+
+              subtle->flags |= SUB_SUBTLE_HOOKS;
             }
 
           break;
@@ -1125,8 +1279,8 @@ RubyEvalConfig(void)
     {
       subSubtleLogWarn("Cannot find any tags\n");
     }
-  else if(32 < subtle->tags->ndata)
-    subSubtleLogWarn("Cannot handle more than 32 tags\n");
+  else if(BITSMAX - 1 < subtle->tags->ndata)
+    subSubtleLogWarn("Cannot handle more than %d tags\n", BITSMAX - 1);
 
   /* Check and update views */
   if(0 == subtle->views->ndata) ///< Create default view
@@ -1142,13 +1296,14 @@ RubyEvalConfig(void)
 
       /* Check for view with default tag */
       for(i = subtle->views->ndata - 1; 0 <= i; i--)
-        if((v = VIEW(subtle->views->data[i])) && v->tags & DEFAULTTAG)
+        if((v = VIEW(subtle->views->data[i])) &&
+            subSharedBitsTest(&v->tags, DEFAULTTAG))
           {
             subSubtleLogDebugRuby("EvalConfig: default view=%s\n", v->name);
             break;
           }
 
-      v->tags |= DEFAULTTAG; ///< Set default tag
+      subSharedBitsSet(&v->tags, DEFAULTTAG); ///< Set default tag
     }
 
   subViewPublish();
@@ -1370,13 +1525,83 @@ RubyForeachStyle(VALUE key,
   return ST_CONTINUE;
 } /* }}} */
 
+/* Subtlext */
+
+/* RubySubtlextNeighbour {{{ */
+/*
+ * call-seq: __neighbour(win, direction) -> Fixnum or nil
+ *
+ * Get nearest visible client in direction without a round trip,
+ * used by Subtlext::Client#neighbour inside of subtle
+ *
+ *  Subtlext.__neighbour(123, 3)
+ *  => 456
+ */
+
+static VALUE
+RubySubtlextNeighbour(VALUE self,
+  VALUE win,
+  VALUE direction)
+{
+  int dir = 0;
+  SubClient *c = NULL, *n = NULL;
+
+  /* Directions are up, right, down and left */
+  if(FIXNUM_P(direction) &&
+      0 <= (dir = FIX2INT(direction)) && 4 > dir &&
+      (c = CLIENT(subSubtleFind(NUM2LONG(win), CLIENTID))) &&
+      VISIBLE(c) && (n = subClientNeighbour(c, (1L << dir), False)))
+    return LONG2NUM(n->win);
+
+  return Qnil;
+} /* }}} */
+
+/* RubySubtlextStats {{{ */
+/*
+ * call-seq: __stats -> Array
+ *
+ * Get call stats in the format of the stats property without a round
+ * trip, used by Subtlext::Subtle.stats inside of subtle
+ *
+ *  Subtlext.__stats
+ *  => [ "sublet#12#3021#415#840#clock" ]
+ */
+
+static VALUE
+RubySubtlextStats(VALUE self)
+{
+  int i, nlist = 0;
+  char **list = RubyStats(&nlist);
+  VALUE ret = rb_ary_new2(nlist);
+
+  for(i = 0; i < nlist; i++)
+    {
+      rb_ary_push(ret, rb_str_new2(list[i]));
+      free(list[i]);
+    }
+
+  free(list);
+
+  return ret;
+} /* }}} */
+
 /* Wrap */
 
 /* RubyWrapLoadSubtlext {{{ */
 static VALUE
 RubyWrapLoadSubtlext(VALUE data)
 {
-  return rb_require("subtle/subtlext");
+  VALUE ret = rb_require("subtle/subtlext");
+  VALUE subtlext = rb_const_get(rb_cObject, rb_intern("Subtlext"));
+
+  /* Keep subtlext off our own socket, we'd block on it */
+  rb_funcall(subtlext, rb_intern("__local"), 0, NULL);
+
+  /* Answer requests directly, subtle can't answer itself while busy */
+  rb_define_singleton_method(subtlext, "__neighbour", RubySubtlextNeighbour, 2);
+  rb_define_singleton_method(subtlext, "__stats",     RubySubtlextStats,     0);
+
+  return ret;
 }/* }}} */
 
 /* RubyWrapLoadPanels {{{ */
@@ -1470,8 +1695,6 @@ RubyWrapLoadPanels(VALUE data)
             subRubyUnloadSublet(p);
         }
 
-      /* Finally sort sublets */
-      subArraySort(subtle->sublets, subPanelCompare);
     }
 
   return Qnil;
@@ -1499,8 +1722,14 @@ RubyWrapCall(VALUE data)
             Atom prop = subEwmhGet(SUB_EWMH_SUBTLE_DATA);
             VALUE meth = rb_intern("__data"), str = Qnil;
 
-            /* Fetch data or create empty string */
-            if((list = subSharedPropertyGetStrings(subtle->dpy, ROOT,
+            /* Take data from socket, property or create empty string */
+            if(rargs[2])
+              {
+                SubIpcData *extra = (SubIpcData *)rargs[2];
+
+                str = rb_str_new(extra->data, extra->len);
+              }
+            else if((list = subSharedPropertyGetStrings(subtle->dpy, ROOT,
                 prop, &nlist)))
               {
                 if(list && 0 < nlist)
@@ -1510,7 +1739,7 @@ RubyWrapCall(VALUE data)
               }
             else str = rb_str_new2("");
 
-            subSharedPropertyDelete(subtle->dpy, ROOT, prop);
+            if(!rargs[2]) subSharedPropertyDelete(subtle->dpy, ROOT, prop);
 
             /* Finally call method */
             rb_funcall(rargs[1], meth,
@@ -1540,6 +1769,27 @@ RubyWrapCall(VALUE data)
       case SUB_CALL_UNLOAD: /* {{{ */
         rb_funcall(rargs[1], rb_intern("__unload"), 1, rargs[1]);
         break; /* }}} */
+      case SUB_CALL_HOOK: /* {{{ */
+          {
+            SubHook *h = HOOK(rargs[1]);
+            VALUE object = Qnil;
+
+            /* Only convert object when the hook takes it */
+            if(h->arity > (NIL_P(h->recv) ? 0 : 1))
+              object = RubySubtleToSubtlext((VALUE *)rargs[2]);
+
+            if(NIL_P(h->recv))
+              rb_funcall(h->proc, h->meth, h->arity, object);
+            else
+              {
+                VALUE args[2] = { h->recv, object };
+
+                rb_method_call(h->arity, args, h->proc);
+
+                subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
+              }
+          }
+        break; /* }}} */
       default: /* {{{ */
         /* Call instance methods or just a proc */
         if(rb_obj_is_instance_of(rargs[1], rb_cMethod))
@@ -1556,8 +1806,7 @@ RubyWrapCall(VALUE data)
             rb_funcall(rargs[1], rb_intern("call"), arity, receiver,
               RubySubtleToSubtlext((VALUE *)rargs[2]));
 
-            subScreenUpdate();
-            subScreenRender();
+            subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
           }
         else
           {
@@ -1571,6 +1820,23 @@ RubyWrapCall(VALUE data)
   return Qnil;
 } /* }}} */
 
+/* RubyWrapFork {{{ */
+static VALUE
+RubyWrapFork(VALUE data)
+{
+  VALUE pid = Qnil;
+
+  /* Let ruby handle its threads after fork */
+  pid = rb_funcall(rb_mProcess, rb_intern("fork"), 0, NULL);
+
+  /* Drop connection subtlext shares with the parent */
+  if(NIL_P(pid) && rb_const_defined(rb_cObject, rb_intern("Subtlext")))
+    rb_funcall(rb_const_get(rb_cObject, rb_intern("Subtlext")),
+      rb_intern("__fork"), 0, NULL);
+
+  return pid;
+} /* }}} */
+
 /* RubyWrapRelease {{{ */
 static VALUE
 RubyWrapRelease(VALUE value)
@@ -1612,7 +1878,9 @@ RubyWrapSubletConfig(VALUE data)
 
       /* Set sublet interval */
       if(FIXNUM_P(value = rb_hash_lookup(hash, CHAR2SYM("interval"))))
-        s->interval = FIX2INT(value);
+        s->interval = FIX2INT(value) * 1000LL;
+      else if(T_FLOAT == rb_type(value))
+        s->interval = (long long)(RFLOAT_VALUE(value) * 1000);
 
       /* Set sublet style */
       if(T_SYMBOL == rb_type(value = rb_hash_lookup(hash,
@@ -1939,6 +2207,11 @@ RubyConfigSet(VALUE self,
                 if(!(subtle->flags & SUB_SUBTLE_CHECK))
                   subtle->snap = FIX2INT(value);
               }
+            else if(CHAR2SYM("panel_fps") == option)
+              {
+                if(!(subtle->flags & SUB_SUBTLE_CHECK))
+                  subtle->fps = MAX(0, FIX2INT(value));
+              }
             else if(CHAR2SYM("gravity") == option ||
                 CHAR2SYM("default_gravity") == option)
               {
@@ -1991,6 +2264,30 @@ RubyConfigSet(VALUE self,
                 if(!(subtle->flags & SUB_SUBTLE_CHECK) && Qtrue == value)
                   subtle->flags |= SUB_SUBTLE_SKIP_URGENT_WARP;
               }
+            else if(CHAR2SYM("async_requests") == option)
+              {
+                if(!(subtle->flags & SUB_SUBTLE_CHECK) && Qtrue == value)
+                  subtle->flags |= SUB_SUBTLE_ASYNC;
+              }
+            else if(CHAR2SYM("opaque_drag") == option)
+              {
+                if(!(subtle->flags & SUB_SUBTLE_CHECK) && Qtrue == value)
+                  subtle->flags |= SUB_SUBTLE_OPAQUE;
+              }
+            else if(CHAR2SYM("sublet_host") == option)
+              {
+                if(!(subtle->flags & SUB_SUBTLE_CHECK) && Qtrue == value)
+                  subtle->flags |= SUB_SUBTLE_HOST;
+              }
+            else if(CHAR2SYM("panel_xrender") == option)
+              {
+                if(!(subtle->flags & SUB_SUBTLE_CHECK) && Qtrue == value)
+                  {
+                    if(subtle->flags & SUB_SUBTLE_XRENDER)
+                      subtle->flags |= SUB_SUBTLE_COMPOSITE;
+                    else subSubtleLogWarn("Xrender is not available\n");
+                  }
+              }
             else subSubtleLogWarn("Unknown option `:%s'\n", SYM2CHAR(option));
             break; /* }}} */
           case T_STRING: /* {{{ */
@@ -2954,7 +3251,7 @@ RubySubletRender(VALUE self)
   SubPanel *p = NULL;
 
   Data_Get_Struct(self, SubPanel, p);
-  if(p) subScreenRender();
+  if(p) subScreenDamage(SUB_PANEL_SUBLET, p->sublet);
 
   return Qnil;
 } /* }}} */
@@ -2981,32 +3278,48 @@ RubySubletNameReader(VALUE self)
 
 /* RubySubletIntervalReader {{{ */
 /*
- * call-seq: interval -> Fixnum
+ * call-seq: interval -> Fixnum or Float
  *
- * Get interval time of Sublet
+ * Get interval time of Sublet in seconds
  *
  *  puts sublet.interval
  *  => 60
+ *
+ *  puts sublet.interval
+ *  => 0.25
  */
 
 static VALUE
 RubySubletIntervalReader(VALUE self)
 {
+  VALUE ret = Qnil;
   SubPanel *p = NULL;
 
   Data_Get_Struct(self, SubPanel, p);
+  if(p)
+    {
+      /* Return fractions only when required */
+      if(0 == p->sublet->interval % 1000)
+        ret = INT2FIX(p->sublet->interval / 1000);
+      else ret = rb_float_new((double)p->sublet->interval / 1000);
+    }
 
-  return p ? INT2FIX(p->sublet->interval) : Qnil;
+  return ret;
 } /* }}} */
 
 /* RubySubletIntervalWriter {{{ */
 /*
  * call-seq: interval=(fixnum) -> nil
+ *            interval=(float)  -> nil
  *
- * Set interval time of Sublet
+ * Set interval time of Sublet in seconds, fractions allow intervals
+ * below one second
  *
  *  sublet.interval = 60
  *  => nil
+ *
+ *  sublet.interval = 0.25
+ *  => nil
  */
 
 static VALUE
@@ -3018,14 +3331,37 @@ RubySubletIntervalWriter(VALUE self,
   Data_Get_Struct(self, SubPanel, p);
   if(p)
     {
-      if(FIXNUM_P(value))
+      if(FIXNUM_P(value) || T_FLOAT == rb_type(value))
         {
-          p->sublet->interval = FIX2INT(value);
-          p->sublet->time     = subSubtleTime() + p->sublet->interval;
+          long long interval = p->sublet->interval;
 
+          /* Store interval in milliseconds */
+          if(FIXNUM_P(value))
+            p->sublet->interval = FIX2INT(value) * 1000LL;
+          else p->sublet->interval = (long long)(RFLOAT_VALUE(value) * 1000);
+
+          p->sublet->time = subSubtleTime() + p->sublet->interval;
+
+          /* Keep subtle and host in sync */
+          if(subtle->flags & SUB_SUBTLE_HOSTED)
+            subHostSend(p, SUB_HOST_INTERVAL, (char *)&p->sublet->interval,
+              sizeof(long long));
+          else if(subtle->flags & SUB_SUBTLE_HOST &&
+              interval != p->sublet->interval &&
+              !(p->sublet->flags & SUB_SUBLET_STALL))
+            subtle->flags |= SUB_SUBTLE_RESPAWN;
+
+          /* Update timer */
           if(0 < p->sublet->interval)
-            p->sublet->flags |= SUB_SUBLET_INTERVAL;
-          else p->sublet->flags &= ~SUB_SUBLET_INTERVAL;
+            {
+              p->sublet->flags |= SUB_SUBLET_INTERVAL;
+              subEventTimerAdd(p);
+            }
+          else
+            {
+              p->sublet->flags &= ~SUB_SUBLET_INTERVAL;
+              subEventTimerDel(p);
+            }
         }
       else rb_raise(rb_eArgError, "Unknown value type `%s'", rb_obj_classname(value));
     }
@@ -3089,7 +3425,12 @@ RubySubletDataWriter(VALUE self,
   if(p)
     {
       /* Check value type */
-      if(T_STRING == rb_type(value))
+      if(T_STRING == rb_type(value) && subtle->flags & SUB_SUBTLE_HOSTED)
+        {
+          subHostSend(p, SUB_HOST_DATA, RSTRING_PTR(value),
+            RSTRING_LEN(value));
+        }
+      else if(T_STRING == rb_type(value))
         {
           SubStyle *s = &subtle->styles.sublets, *style = NULL;
 
@@ -3190,7 +3531,13 @@ RubySubletStyleWriter(VALUE self,
   if(p)
     {
       /* Check value type */
-      if(FIXNUM_P(value))
+      if(FIXNUM_P(value) && subtle->flags & SUB_SUBTLE_HOSTED)
+        {
+          int styleid = FIX2INT(value);
+
+          subHostSend(p, SUB_HOST_STYLE, (char *)&styleid, sizeof(int));
+        }
+      else if(FIXNUM_P(value))
         {
           SubStyle *s = &subtle->styles.sublets, *style = NULL;
 
@@ -3201,9 +3548,8 @@ RubySubletStyleWriter(VALUE self,
               p->sublet->styleid = FIX2INT(value);
             }
 
-          p->sublet->width = subTextParse(p->sublet->text,
-            subtle->styles.sublets.font, RSTRING_PTR(value)) +
-            STYLE_WIDTH((*s));
+          /* Text layout doesn't depend on style */
+          p->sublet->width = p->sublet->text->width + STYLE_WIDTH((*s));
         }
       else rb_raise(rb_eArgError, "Unknown value type");
     }
@@ -3227,13 +3573,14 @@ RubySubletShow(VALUE self)
   SubPanel *p = NULL;
 
   Data_Get_Struct(self, SubPanel, p);
-  if(p)
+  if(p && subtle->flags & SUB_SUBTLE_HOSTED)
+    subHostSend(p, SUB_HOST_SHOW, NULL, 0);
+  else if(p)
     {
       p->flags &= ~SUB_PANEL_HIDDEN;
 
       /* Update screens */
-      subScreenUpdate();
-      subScreenRender();
+      subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
     }
 
   return Qnil;
@@ -3256,13 +3603,14 @@ RubySubletHide(VALUE self,
   SubPanel *p = NULL;
 
   Data_Get_Struct(self, SubPanel, p);
-  if(p)
+  if(p && subtle->flags & SUB_SUBTLE_HOSTED)
+    subHostSend(p, SUB_HOST_HIDE, NULL, 0);
+  else if(p)
     {
       p->flags |= SUB_PANEL_HIDDEN;
 
       /* Update screens */
-      subScreenUpdate();
-      subScreenRender();
+      subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
     }
 
   return Qnil;
@@ -3288,6 +3636,14 @@ RubySubletWatch(VALUE self,
   VALUE ret = Qfalse;
   SubPanel *p = NULL;
 
+  /* Epoll and inotify instances are shared with subtle */
+  if(subtle->flags & SUB_SUBTLE_HOSTED)
+    {
+      subSubtleLogWarn("Cannot watch from within the sublet host\n");
+
+      return Qfalse;
+    }
+
   Data_Get_Struct(self, SubPanel, p);
   if(p)
     {
@@ -3309,9 +3665,8 @@ RubySubletWatch(VALUE self,
                     0, NULL));
                 }
 
-              XSaveContext(subtle->dpy, subtle->windows.support,
-                p->sublet->watch, (void *)p);
-              subEventWatchAdd(p->sublet->watch);
+              /* Level-triggered, sublets might not read everything */
+              subEventWatchAdd(p->sublet->watch, p, False);
 
               /* Set nonblocking */
               if(-1 == (flags = fcntl(p->sublet->watch, F_GETFL, 0))) flags = 0;
@@ -3378,13 +3733,15 @@ RubySubletUnwatch(VALUE self)
   VALUE ret = Qfalse;
   SubPanel *p = NULL;
 
+  /* Watches belong to subtle */
+  if(subtle->flags & SUB_SUBTLE_HOSTED) return Qfalse;
+
   Data_Get_Struct(self, SubPanel, p);
   if(p)
     {
       /* Probably a socket */
       if(p->sublet->flags & SUB_SUBLET_SOCKET)
         {
-          XDeleteContext(subtle->dpy, subtle->windows.support, p->sublet->watch);
           subEventWatchDel(p->sublet->watch);
 
           p->sublet->flags &= ~SUB_SUBLET_SOCKET;
@@ -3647,12 +4004,14 @@ subRubyReloadConfig(void)
   Window root = None, win = None;
   SubClient *c = NULL;
 
-  /* Reset panel height */
-  subtle->ph = 0;
+  /* Reset panel height and frame rate */
+  subtle->ph  = 0;
+  subtle->fps = 0;
 
   /* Reset flags before reloading */
   subtle->flags &= (SUB_SUBTLE_DEBUG|SUB_SUBTLE_EWMH|SUB_SUBTLE_RUN|
-    SUB_SUBTLE_XINERAMA|SUB_SUBTLE_XRANDR|SUB_SUBTLE_URGENT);
+    SUB_SUBTLE_XINERAMA|SUB_SUBTLE_XRANDR|SUB_SUBTLE_XRENDER|
+    SUB_SUBTLE_PUBLISH|SUB_SUBTLE_URGENT);
 
   /* Unregister config values */
   rb_gc_unregister_address(&config_sublets);
@@ -3685,11 +4044,13 @@ subRubyReloadConfig(void)
 
   /* Clear arrays */
   subArrayClear(subtle->hooks,     True); ///< Must be first
+  subtle->flags |= SUB_SUBTLE_HOOKS;
   subArrayClear(subtle->grabs,     True);
   subArrayClear(subtle->gravities, True);
   subArrayClear(subtle->sublets,   False);
   subArrayClear(subtle->tags,      True);
   subArrayClear(subtle->views,     True);
+  subTextFlush();
 
   /* Load and configure */
   subRubyLoadConfig();
@@ -3711,6 +4072,7 @@ subRubyReloadConfig(void)
 
       c            = CLIENT(subtle->clients->data[i]);
       c->gravityid = -1;
+      c->mapstate  = -1;
       c->flags     = (c->flags & (SUB_TYPE_CLIENT|SUB_CLIENT_FOCUS|
         SUB_CLIENT_INPUT|SUB_CLIENT_CLOSE)); ///< Reset flags
 
@@ -3789,7 +4151,8 @@ subRubyLoadSublet(const char *file)
     }
 
   /* Carefully configure sublet */
-  if(!subRubyCall(SUB_CALL_CONFIGURE, p->sublet->instance, NULL))
+  if(!subRubyCall(SUB_CALL_CONFIGURE, p->sublet->instance, NULL,
+    &p->sublet->stats))
     {
       subRubyUnloadSublet(p);
 
@@ -3797,11 +4160,12 @@ subRubyLoadSublet(const char *file)
     }
 
   /* Sanitize interval time */
-  if(0 >= p->sublet->interval) p->sublet->interval = 60;
+  if(0 >= p->sublet->interval) p->sublet->interval = 60000;
 
   /* First run */
   if(p->sublet->flags & SUB_SUBLET_RUN)
-    subRubyCall(SUB_CALL_RUN, p->sublet->instance, NULL);
+    subRubyCall(SUB_CALL_RUN, p->sublet->instance, NULL,
+      &p->sublet->stats);
 
   subArrayPush(subtle->sublets, (void *)p);
 
@@ -3816,7 +4180,8 @@ subRubyLoadSublet(const char *file)
 void
 subRubyUnloadSublet(SubPanel *p)
 {
-  int i;
+  int i, nfound = 0;
+  void **found = NULL;
 
   assert(p);
 
@@ -3828,35 +4193,53 @@ subRubyUnloadSublet(SubPanel *p)
       if(s->panels) subArrayRemove(s->panels, (void *)p);
     }
 
-  /* Remove hooks */
+  /* Collect hooks and grabs of sublet */
+  nfound = 0;
+  found  = (void **)subSharedMemoryAlloc(MAX(1, MAX(subtle->hooks->ndata,
+    subtle->grabs->ndata)), sizeof(void *));
+
   for(i = 0; i < subtle->hooks->ndata; i++)
     {
       SubHook *hook = HOOK(subtle->hooks->data[i]);
 
       if(RubyReceiver(p->sublet->instance, hook->proc))
+        found[nfound++] = (void *)hook;
+    }
+
+  /* Remove hooks in one pass */
+  if(0 < nfound)
+    {
+      subArrayRemoveAll(subtle->hooks, found, nfound);
+
+      for(i = 0; i < nfound; i++)
         {
-          subArrayRemove(subtle->hooks, (void *)hook);
-          subRubyRelease(hook->proc);
-          subHookKill(hook);
-          i--; ///< Prevent skipping of entries
+          subRubyRelease(HOOK(found[i])->proc);
+          subHookKill(HOOK(found[i]));
         }
+
+      subtle->flags |= SUB_SUBTLE_HOOKS;
     }
 
-  /* Remove grabs */
-  for(i = 0; i < subtle->grabs->ndata; i++)
+  for(i = 0, nfound = 0; i < subtle->grabs->ndata; i++)
     {
       SubGrab *grab = GRAB(subtle->grabs->data[i]);
 
       if(grab->flags & SUB_GRAB_PROC &&
           RubyReceiver(p->sublet->instance, grab->data.num))
-        {
-          subArrayRemove(subtle->grabs, (void *)grab);
-          subRubyRelease(grab->data.num);
-          subGrabKill(grab);
-          i--; ///< Prevent skipping of entries
-        }
+        found[nfound++] = (void *)grab;
     }
 
+  /* Remove grabs in one pass */
+  subArrayRemoveAll(subtle->grabs, found, nfound);
+
+  for(i = 0; i < nfound; i++)
+    {
+      subRubyRelease(GRAB(found[i])->data.num);
+      subGrabKill(GRAB(found[i]));
+    }
+
+  free(found);
+
   subArrayRemove(subtle->sublets, (void *)p);
   subPanelKill(p);
   subPanelPublish();
@@ -3951,6 +4334,7 @@ subRubyLoadSublets(void)
   * @param[in]  type   Script type
   * @param[in]  proc   Script receiver
   * @param[in]  data   Extra data
+  * @param[in]  stats  Call stats or \p NULL
   * @retval  1  Call was successful
   * @retval  0  Call failed
   **/
@@ -3958,9 +4342,12 @@ subRubyLoadSublets(void)
 int
 subRubyCall(int type,
   unsigned long proc,
-  void *data)
+  void *data,
+  SubStats *stats)
 {
   int state = 0;
+  long long start = 0;
+  size_t objects = 0;
   VALUE rargs[3] = { Qnil };
 
   /* Wrap up data */
@@ -3968,8 +4355,32 @@ subRubyCall(int type,
   rargs[1] = proc;
   rargs[2] = (VALUE)data;
 
-  /* Carefully call */
+  /* Sync in async mode since subtlext uses another connection,
+   * the sublet host must not touch the display at all */
+  if(subtle->flags & SUB_SUBTLE_ASYNC &&
+      !(subtle->flags & SUB_SUBTLE_HOSTED) &&
+      NextRequest(subtle->dpy) - 1 != LastKnownRequestProcessed(subtle->dpy))
+    XSync(subtle->dpy, False);
+
+  /* Carefully call and account time and allocations */
+  if(stats)
+    {
+      objects = RubyObjects();
+      start   = RubyTime();
+    }
+
   rb_protect(RubyWrapCall, (VALUE)&rargs, &state);
+
+  if(stats)
+    {
+      start = RubyTime() - start;
+
+      stats->calls++;
+      stats->total   += start;
+      stats->max      = MAX(stats->max, start);
+      stats->objects += RubyObjects() - objects;
+    }
+
   if(state) RubyBacktrace();
 
 #ifdef DEBUG
@@ -3980,6 +4391,31 @@ subRubyCall(int type,
   return !state; ///< Reverse odd logic
 } /* }}} */
 
+ /** subRubyPublish {{{
+  * @brief Publish call stats of sublets and hooks and event counters
+  **/
+
+void
+subRubyPublish(void)
+{
+  int i, nlist = 0;
+  char **list = RubyStats(&nlist);
+
+  /* EWMH: Stats, always set since clients wait for it */
+  subSharedPropertySetStrings(subtle->dpy, ROOT,
+    subEwmhGet(SUB_EWMH_SUBTLE_STATS), list, nlist);
+
+  /* Tidy up */
+  for(i = 0; i < nlist; i++)
+    free(list[i]);
+
+  subSubtleLogDebugSubtle("Publish: stats=%d\n", nlist);
+
+  subtle->flags |= SUB_SUBTLE_PUBLISH; ///< Sync once per loop
+
+  free(list);
+} /* }}} */
+
  /** subRubyRelease {{{
   * @brief Release value from shelter
   * @param[in]  value  The released value
@@ -3995,6 +4431,29 @@ subRubyRelease(unsigned long value)
   return state;
 } /* }}} */
 
+ /** subRubyFork {{{
+  * @brief Fork process and let ruby clean up in the child
+  * @return Returns the pid in the parent, \p 0 in the child or \p -1
+  **/
+
+int
+subRubyFork(void)
+{
+  int state = 0;
+  VALUE pid = Qnil;
+
+  /* Carefully fork */
+  pid = rb_protect(RubyWrapFork, Qnil, &state);
+  if(state)
+    {
+      RubyBacktrace();
+
+      return -1;
+    }
+
+  return NIL_P(pid) ? 0 : FIX2INT(pid);
+} /* }}} */
+
  /** subRubyFinish {{{
   * @brief Finish ruby stack
   **/
@@ -59,7 +59,7 @@ ScreenPublish(void)
   free(panels);
   free(viewports);
 
-  XSync(subtle->dpy, False); ///< Sync all changes
+  subtle->flags |= SUB_SUBTLE_PUBLISH; ///< Sync once per loop
 
   subSubtleLogDebugSubtle("Publish: screens=%d\n",
     subtle->screens->ndata);
@@ -68,12 +68,14 @@ ScreenPublish(void)
 /* ScreenClear {{{ */
 static void
 ScreenClear(SubScreen *s,
-  unsigned long col)
+  unsigned long col,
+  int x,
+  int width)
 {
   /* Clear pixmap */
   XSetForeground(subtle->dpy, subtle->gcs.draw, col);
   XFillRectangle(subtle->dpy, s->drawable, subtle->gcs.draw,
-    0, 0, s->base.width, subtle->ph);
+    x, 0, width, subtle->ph);
 
    /* Draw stipple on panels */
   if(s->flags & SUB_SCREEN_STIPPLE)
@@ -84,10 +86,277 @@ ScreenClear(SubScreen *s,
       XChangeGC(subtle->dpy, subtle->gcs.stipple, GCStipple, &gvals);
 
       XFillRectangle(subtle->dpy, s->drawable, subtle->gcs.stipple,
-        0, 0, s->base.width, subtle->ph);
+        x, 0, width, subtle->ph);
     }
 } /* }}} */
 
+/* ScreenExtent {{{ */
+static void
+ScreenExtent(SubPanel *p,
+  int x,
+  int width,
+  XRectangle *r)
+{
+  int sep = subtle->styles.separator.separator ?
+    subtle->styles.separator.separator->width : 0;
+
+  /* Include separators */
+  r->x      = x - (p->flags & SUB_PANEL_SEPARATOR1 ? sep : 0);
+  r->width  = width + (p->flags & SUB_PANEL_SEPARATOR1 ? sep : 0) +
+    (p->flags & SUB_PANEL_SEPARATOR2 ? sep : 0);
+  r->y      = p->flags & SUB_PANEL_BOTTOM ? 1 : 0; ///< Abuse y for panel
+  r->height = subtle->ph;
+} /* }}} */
+
+/* ScreenUpdate {{{ */
+static void
+ScreenUpdate(SubScreen *s)
+{
+  SubPanel *p = NULL;
+  int j, npanel = 0, center = False, offset = 0;
+  int x[4] = { 0 }, nspacer[4] = { 0 }; ///< Waste ints but it's easier for the algo
+  int sw[4] = { 0 }, fix[4] = { 0 }, width[4] = { 0 }, spacer[4] = { 0 };
+
+  /* Pass 1: Collect width for spacer sizes */
+  for(j = 0; s->panels && j < s->panels->ndata; j++)
+    {
+      p = PANEL(s->panels->data[j]);
+
+      subPanelUpdate(p);
+
+      /* Check flags */
+      if(p->flags & SUB_PANEL_HIDDEN)  continue;
+      if(0 == npanel && p->flags & SUB_PANEL_BOTTOM)
+        {
+          npanel = 1;
+          center = False;
+        }
+      if(p->flags & SUB_PANEL_CENTER) center = !center;
+
+      /* Offset selects panel variables for either center or not */
+      offset = center ? npanel + 2 : npanel;
+
+      if(p->flags & SUB_PANEL_SPACER1) spacer[offset]++;
+      if(p->flags & SUB_PANEL_SPACER2) spacer[offset]++;
+      if(p->flags & SUB_PANEL_SEPARATOR1 &&
+          subtle->styles.separator.separator)
+        width[offset] += subtle->styles.separator.separator->width;
+      if(p->flags & SUB_PANEL_SEPARATOR2 &&
+          subtle->styles.separator.separator)
+        width[offset] += subtle->styles.separator.separator->width;
+
+      width[offset] += p->width;
+    }
+
+  /* Calculate spacer and fix sizes */
+  for(j = 0; j < 4; j++)
+    {
+      if(0 < spacer[j])
+        {
+          sw[j]  = (s->base.width - width[j]) / spacer[j];
+          fix[j] = s->base.width - (width[j] + spacer[j] * sw[j]);
+        }
+    }
+
+  /* Pass 2: Move and resize windows */
+  for(j = 0, npanel = 0, center = False;
+      s->panels && j < s->panels->ndata; j++)
+    {
+      p = PANEL(s->panels->data[j]);
+
+      /* Check flags */
+      if(p->flags & SUB_PANEL_HIDDEN) continue;
+      if(0 == npanel && p->flags & SUB_PANEL_BOTTOM)
+        {
+          /* Reset for new panel */
+          npanel     = 1;
+          nspacer[0] = 0;
+          nspacer[2] = 0;
+          x[0]       = 0;
+          x[2]       = 0;
+          center     = False;
+        }
+      if(p->flags & SUB_PANEL_CENTER) center = !center;
+
+      /* Offset selects panel variables for either center or not */
+      offset = center ? npanel + 2 : npanel;
+
+      /* Set start position of centered panel items */
+      if(center && 0 == x[offset])
+        x[offset] = (s->base.width - width[offset]) / 2;
+
+      /* Add separator before panel item */
+      if(p->flags & SUB_PANEL_SEPARATOR1 &&
+          subtle->styles.separator.separator)
+        x[offset] += subtle->styles.separator.separator->width;
+
+      /* Add spacer before item */
+      if(p->flags & SUB_PANEL_SPACER1)
+        {
+          x[offset] += sw[offset];
+
+          /* Increase last spacer size by rounding fix */
+          if(++nspacer[offset] == spacer[offset])
+            x[offset] += fix[offset];
+        }
+
+      /* Set panel position */
+      if(p->flags & SUB_PANEL_TRAY)
+        XMoveWindow(subtle->dpy, subtle->windows.tray, x[offset], 0);
+      p->x = x[offset];
+
+      /* Add separator after panel item */
+      if(p->flags & SUB_PANEL_SEPARATOR2 &&
+          subtle->styles.separator.separator)
+        x[offset] += subtle->styles.separator.separator->width;
+
+      /* Add spacer after item */
+      if(p->flags & SUB_PANEL_SPACER2)
+        {
+          x[offset] += sw[offset];
+
+          /* Increase last spacer size by rounding fix */
+          if(++nspacer[offset] == spacer[offset])
+            x[offset] += fix[offset];
+        }
+
+      x[offset] += p->width;
+    }
+
+  s->flags &= ~(SUB_SCREEN_UPDATE|SUB_SCREEN_LAYOUT);
+} /* }}} */
+
+/* ScreenRender {{{ */
+static void
+ScreenRender(SubScreen *s)
+{
+  int j;
+  Window panel = s->panel1;
+
+  ScreenClear(s, subtle->styles.subtle.top, 0, s->base.width);
+
+  /* Render panel items */
+  for(j = 0; s->panels && j < s->panels->ndata; j++)
+    {
+      SubPanel *p = PANEL(s->panels->data[j]);
+
+      if(p->flags & SUB_PANEL_HIDDEN) continue;
+      if(panel != s->panel2 && p->flags & SUB_PANEL_BOTTOM)
+        {
+          XCopyArea(subtle->dpy, s->drawable, panel, subtle->gcs.draw,
+            0, 0, s->base.width, subtle->ph, 0, 0);
+
+          ScreenClear(s, subtle->styles.subtle.bottom, 0, s->base.width);
+          panel = s->panel2;
+        }
+
+      subPanelRender(p, s->drawable);
+
+      /* Store rendered geometry */
+      p->flags  &= ~SUB_PANEL_DIRTY;
+      p->ox      = p->x;
+      p->owidth  = p->width;
+    }
+
+  XCopyArea(subtle->dpy, s->drawable, panel, subtle->gcs.draw,
+    0, 0, s->base.width, subtle->ph, 0, 0);
+
+  s->flags &= ~(SUB_SCREEN_RENDER|SUB_SCREEN_DAMAGE);
+} /* }}} */
+
+/* ScreenRepair {{{ */
+static void
+ScreenRepair(SubScreen *s)
+{
+  int i, j, k, n = 0, expand = True;
+  XRectangle *rects = NULL, r;
+
+  if(!s->panels || 0 == s->panels->ndata) return;
+
+  /* Old and new extent per item at most */
+  rects = (XRectangle *)subSharedMemoryAlloc(2 * s->panels->ndata,
+    sizeof(XRectangle));
+
+  /* Pass 1: Collect damage of changed and moved items */
+  for(i = 0; i < s->panels->ndata; i++)
+    {
+      SubPanel *p = PANEL(s->panels->data[i]);
+
+      if(p->flags & SUB_PANEL_HIDDEN) continue;
+
+      if(p->x != p->ox || p->width != p->owidth)
+        {
+          if(0 < p->owidth) ScreenExtent(p, p->ox, p->owidth, &rects[n++]);
+
+          p->flags |= SUB_PANEL_DIRTY;
+        }
+
+      if(p->flags & SUB_PANEL_DIRTY) ScreenExtent(p, p->x, p->width, &rects[n++]);
+    }
+
+  /* Pass 2: Repaint untouched items that overlap damage, too */
+  while(expand)
+    {
+      expand = False;
+
+      for(i = 0; i < s->panels->ndata; i++)
+        {
+          SubPanel *p = PANEL(s->panels->data[i]);
+
+          if(p->flags & (SUB_PANEL_HIDDEN|SUB_PANEL_DIRTY)) continue;
+
+          ScreenExtent(p, p->x, p->width, &r);
+
+          for(j = 0; j < n; j++)
+            {
+              if(r.y == rects[j].y && r.x < rects[j].x + rects[j].width &&
+                  rects[j].x < r.x + r.width)
+                {
+                  p->flags   |= SUB_PANEL_DIRTY;
+                  rects[n++]  = r;
+                  expand      = True;
+
+                  break;
+                }
+            }
+        }
+    }
+
+  /* Pass 3: Clear, render and copy damage per panel */
+  for(k = 0; k < 2; k++)
+    {
+      for(j = 0; j < n; j++)
+        if(k == rects[j].y)
+          ScreenClear(s, k ? subtle->styles.subtle.bottom :
+            subtle->styles.subtle.top, rects[j].x, rects[j].width);
+
+      for(i = 0; i < s->panels->ndata; i++)
+        {
+          SubPanel *p = PANEL(s->panels->data[i]);
+
+          if(k == !!(p->flags & SUB_PANEL_BOTTOM) &&
+              p->flags & SUB_PANEL_DIRTY)
+            {
+              subPanelRender(p, s->drawable);
+
+              p->flags  &= ~SUB_PANEL_DIRTY;
+              p->ox      = p->x;
+              p->owidth  = p->width;
+            }
+        }
+
+      for(j = 0; j < n; j++)
+        if(k == rects[j].y)
+          XCopyArea(subtle->dpy, s->drawable, k ? s->panel2 : s->panel1,
+            subtle->gcs.draw, rects[j].x, 0, rects[j].width, subtle->ph,
+            rects[j].x, 0);
+    }
+
+  free(rects);
+
+  s->flags &= ~SUB_SCREEN_DAMAGE;
+} /* }}} */
+
 /* Public */
 
  /** subScreenInit {{{
@@ -118,7 +387,26 @@ subScreenInit(void)
                   /* Create new screen if crtc is enabled */
                   if(None != crtc->mode && (s = subScreenNew(crtc->x,
                       crtc->y, crtc->width, crtc->height)))
-                    subArrayPush(subtle->screens, (void *)s);
+                    {
+                      int j;
+
+                      /* Get refresh rate of crtc mode */
+                      for(j = 0; j < res->nmode; j++)
+                        {
+                          XRRModeInfo *mode = &res->modes[j];
+
+                          if(mode->id == crtc->mode && mode->hTotal &&
+                              mode->vTotal)
+                            {
+                              s->refresh = (int)((mode->dotClock +
+                                mode->hTotal * mode->vTotal / 2) /
+                                (mode->hTotal * mode->vTotal));
+                              break;
+                            }
+                        }
+
+                      subArrayPush(subtle->screens, (void *)s);
+                    }
 
                   XRRFreeCrtcInfo(crtc);
                 }
@@ -196,6 +484,7 @@ subScreenNew(int x,
   s->geom.height = height;
   s->base        = s->geom; ///< Backup size
   s->viewid      = subtle->screens->ndata; ///< Init
+  s->refresh     = 60;
 
   /* Create panel windows */
   sattrs.event_mask        = ButtonPressMask|EnterWindowMask|
@@ -297,14 +586,27 @@ subScreenCurrent(int *sid)
 void
 subScreenConfigure(void)
 {
-  int i;
+  int i, nmapped = 0, nunmapped = 0;
   SubScreen *s = NULL;
   SubView *v = NULL;
 
   /* Reset visible tags, views and available clients */
-  subtle->visible_tags  = 0;
-  subtle->visible_views = 0;
-  subtle->client_tags   = 0;
+  subSharedBitsClear(&subtle->visible_tags);
+  subSharedBitsClear(&subtle->visible_views);
+  subSharedBitsClear(&subtle->client_tags);
+
+  subtle->flags |= SUB_SUBTLE_INDEX; ///< Visible clients may change
+
+  /* Check views of each screen */
+  for(i = 0; i < subtle->screens->ndata; i++)
+    {
+      s = SCREEN(subtle->screens->data[i]);
+      v = VIEW(subtle->views->data[s->viewid]);
+
+      /* Set visible tags and views to ease lookups */
+      subSharedBitsOr(&subtle->visible_tags, &v->tags);
+      subSharedBitsSet(&subtle->visible_views, s->viewid + 1);
+    }
 
   /* Either check each client or just get visible clients */
   if(0 < subtle->clients->ndata)
@@ -321,7 +623,7 @@ subScreenConfigure(void)
           if(c->flags & SUB_CLIENT_DEAD) continue;
 
           /* Set available client tags to ease lookups */
-          subtle->client_tags |= c->tags;
+          subSharedBitsOr(&subtle->client_tags, &c->tags);
 
           /* Check view of each screen */
           for(j = 0; j < subtle->screens->ndata; j++)
@@ -329,10 +631,6 @@ subScreenConfigure(void)
               s = SCREEN(subtle->screens->data[j]);
               v = VIEW(subtle->views->data[s->viewid]);
 
-              /* Set visible tags and views to ease lookups */
-              subtle->visible_tags  |= v->tags;
-              subtle->visible_views |= (1L << (s->viewid + 1));
-
               /* Find visible clients */
               if(VISIBLETAGS(c, v->tags))
                 {
@@ -358,8 +656,14 @@ subScreenConfigure(void)
             {
               /* Update client */
               subClientArrange(c, gravityid, screenid);
-              XMapWindow(subtle->dpy, c->win);
-              subEwmhSetWMState(c->win, NormalState);
+
+              /* Map only when it was hidden before */
+              if(NormalState != c->mapstate)
+                {
+                  XMapWindow(subtle->dpy, c->win);
+                  subEwmhSetWMState(c->win, NormalState);
+                  nmapped++;
+                }
 
               /* Warp after gravity and screen have been set if not disabled */
               if(c->flags & SUB_CLIENT_MODE_URGENT &&
@@ -368,45 +672,44 @@ subScreenConfigure(void)
                 subClientWarp(c);
 
               /* EWMH: Desktop, screen */
-              subEwmhSetCardinals(c->win, SUB_EWMH_NET_WM_DESKTOP,
-                (long *)&viewid, 1);
-              subEwmhSetCardinals(c->win, SUB_EWMH_SUBTLE_CLIENT_SCREEN,
-                (long *)&screenid, 1);
+              if(NormalState != c->mapstate || c->mapview != viewid)
+                {
+                  subEwmhSetCardinals(c->win, SUB_EWMH_NET_WM_DESKTOP,
+                    (long *)&viewid, 1);
+                }
+              if(NormalState != c->mapstate || c->mapscreen != screenid)
+                {
+                  subEwmhSetCardinals(c->win, SUB_EWMH_SUBTLE_CLIENT_SCREEN,
+                    (long *)&screenid, 1);
+                }
+
+              c->mapstate  = NormalState;
+              c->mapview   = viewid;
+              c->mapscreen = screenid;
             }
-          else ///< Unmap other windows
+          else if(WithdrawnState != c->mapstate) ///< Unmap other windows
             {
-              c->flags |= SUB_CLIENT_UNMAP; ///< Ignore next unmap
+              c->flags    |= SUB_CLIENT_UNMAP; ///< Ignore next unmap
+              c->mapstate  = WithdrawnState;
+
               subEwmhSetWMState(c->win, WithdrawnState);
               XUnmapWindow(subtle->dpy, c->win);
+              nunmapped++;
             }
         }
     }
-  else
-    {
-      /* Check views of each screen */
-      for(i = 0; i < subtle->screens->ndata; i++)
-        {
-          s = SCREEN(subtle->screens->data[i]);
-          v = VIEW(subtle->views->data[s->viewid]);
-
-          /* Set visible tags and views to ease lookups */
-          subtle->visible_tags  |= v->tags;
-          subtle->visible_views |= (1L << (s->viewid + 1));
-        }
-    }
 
   /* EWMH: Visible tags, views */
-  subEwmhSetCardinals(ROOT, SUB_EWMH_SUBTLE_VISIBLE_TAGS,
-    (long *)&subtle->visible_tags, 1);
-  subEwmhSetCardinals(ROOT, SUB_EWMH_SUBTLE_VISIBLE_VIEWS,
-    (long *)&subtle->visible_views, 1);
+  subEwmhSetTags(ROOT, SUB_EWMH_SUBTLE_VISIBLE_TAGS, &subtle->visible_tags);
+  subEwmhSetTags(ROOT, SUB_EWMH_SUBTLE_VISIBLE_VIEWS, &subtle->visible_views);
 
-  XSync(subtle->dpy, False); ///< Sync before going on
+  SYNC(); ///< Sync before going on
 
   /* Hook: Configure */
   subHookCall(SUB_HOOK_TILE, NULL);
 
-  subSubtleLogDebugSubtle("Configure\n");
+  subSubtleLogDebugSubtle("Configure: mapped=%d, unmapped=%d\n",
+    nmapped, nunmapped);
 } /* }}} */
 
  /** subScreenUpdate {{{
@@ -420,165 +723,137 @@ subScreenUpdate(void)
 
   /* Update screens */
   for(i = 0; i < subtle->screens->ndata; i++)
-    {
-      SubScreen *s = SCREEN(subtle->screens->data[i]);
-      SubPanel *p = NULL;
-      int j, npanel = 0, center = False, offset = 0;
-      int x[4] = { 0 }, nspacer[4] = { 0 }; ///< Waste ints but it's easier for the algo
-      int sw[4] = { 0 }, fix[4] = { 0 }, width[4] = { 0 }, spacer[4] = { 0 };
-
-      /* Pass 1: Collect width for spacer sizes */
-      for(j = 0; s->panels && j < s->panels->ndata; j++)
-        {
-          p = PANEL(s->panels->data[j]);
+    ScreenUpdate(SCREEN(subtle->screens->data[i]));
 
-          subPanelUpdate(p);
+  subSubtleLogDebugSubtle("Update\n");
+} /* }}} */
 
-          /* Check flags */
-          if(p->flags & SUB_PANEL_HIDDEN)  continue;
-          if(0 == npanel && p->flags & SUB_PANEL_BOTTOM)
-            {
-              npanel = 1;
-              center = False;
-            }
-          if(p->flags & SUB_PANEL_CENTER) center = !center;
+ /** subScreenRender {{{
+  * @brief Render screens
+  **/
 
-          /* Offset selects panel variables for either center or not */
-          offset = center ? npanel + 2 : npanel;
+void
+subScreenRender(void)
+{
+  int i;
 
-          if(p->flags & SUB_PANEL_SPACER1) spacer[offset]++;
-          if(p->flags & SUB_PANEL_SPACER2) spacer[offset]++;
-          if(p->flags & SUB_PANEL_SEPARATOR1 &&
-              subtle->styles.separator.separator)
-            width[offset] += subtle->styles.separator.separator->width;
-          if(p->flags & SUB_PANEL_SEPARATOR2 &&
-              subtle->styles.separator.separator)
-            width[offset] += subtle->styles.separator.separator->width;
+  /* Render all screens */
+  for(i = 0; i < subtle->screens->ndata; i++)
+    ScreenRender(SCREEN(subtle->screens->data[i]));
 
-          width[offset] += p->width;
-        }
+  SYNC(); ///< Sync before going on
 
-      /* Calculate spacer and fix sizes */
-      for(j = 0; j < 4; j++)
-        {
-          if(0 < spacer[j])
-            {
-              sw[j]  = (s->base.width - width[j]) / spacer[j];
-              fix[j] = s->base.width - (width[j] + spacer[j] * sw[j]);
-            }
-        }
+  subSubtleLogDebugSubtle("Render\n");
+} /* }}} */
 
-      /* Pass 2: Move and resize windows */
-      for(j = 0, npanel = 0, center = False;
-          s->panels && j < s->panels->ndata; j++)
-        {
-          p = PANEL(s->panels->data[j]);
+ /** subScreenDirty {{{
+  * @brief Mark screens for deferred update and/or render
+  * @param[in]  s      A #SubScreen or \p NULL for all screens
+  * @param[in]  flags  Dirty flags
+  **/
 
-          /* Check flags */
-          if(p->flags & SUB_PANEL_HIDDEN) continue;
-          if(0 == npanel && p->flags & SUB_PANEL_BOTTOM)
-            {
-              /* Reset for new panel */
-              npanel     = 1;
-              nspacer[0] = 0;
-              nspacer[2] = 0;
-              x[0]       = 0;
-              x[2]       = 0;
-              center     = False;
-            }
-          if(p->flags & SUB_PANEL_CENTER) center = !center;
+void
+subScreenDirty(SubScreen *s,
+  int flags)
+{
+  flags &= (SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
 
-          /* Offset selects panel variables for either center or not */
-          offset = center ? npanel + 2 : npanel;
+  /* Mark one or all screens */
+  if(s) s->flags |= flags;
+  else
+    {
+      int i;
 
-          /* Set start position of centered panel items */
-          if(center && 0 == x[offset])
-            x[offset] = (s->base.width - width[offset]) / 2;
+      for(i = 0; i < subtle->screens->ndata; i++)
+        SCREEN(subtle->screens->data[i])->flags |= flags;
+    }
 
-          /* Add separator before panel item */
-          if(p->flags & SUB_PANEL_SEPARATOR1 &&
-              subtle->styles.separator.separator)
-            x[offset] += subtle->styles.separator.separator->width;
+  if(flags) subtle->flags |= SUB_SUBTLE_DIRTY;
+} /* }}} */
 
-          /* Add spacer before item */
-          if(p->flags & SUB_PANEL_SPACER1)
-            {
-              x[offset] += sw[offset];
+ /** subScreenDamage {{{
+  * @brief Mark panel items for deferred incremental repaint
+  * @param[in]  type    Panel item type
+  * @param[in]  sublet  A #SubSublet to limit sublet items or \p NULL
+  **/
 
-              /* Increase last spacer size by rounding fix */
-              if(++nspacer[offset] == spacer[offset])
-                x[offset] += fix[offset];
-            }
+void
+subScreenDamage(int type,
+  SubSublet *sublet)
+{
+  int i, j;
 
-          /* Set panel position */
-          if(p->flags & SUB_PANEL_TRAY)
-            XMoveWindow(subtle->dpy, subtle->windows.tray, x[offset], 0);
-          p->x = x[offset];
+  for(i = 0; i < subtle->screens->ndata; i++)
+    {
+      SubScreen *s = SCREEN(subtle->screens->data[i]);
 
-          /* Add separator after panel item */
-          if(p->flags & SUB_PANEL_SEPARATOR2 &&
-              subtle->styles.separator.separator)
-            x[offset] += subtle->styles.separator.separator->width;
+      /* Mark matching items, copied sublets share the sublet */
+      for(j = 0; s->panels && j < s->panels->ndata; j++)
+        {
+          SubPanel *p = PANEL(s->panels->data[j]);
 
-          /* Add spacer after item */
-          if(p->flags & SUB_PANEL_SPACER2)
+          if(p->flags & type && (!sublet ||
+              (p->flags & SUB_PANEL_SUBLET && p->sublet == sublet)))
             {
-              x[offset] += sw[offset];
+              int width = p->width;
 
-              /* Increase last spacer size by rounding fix */
-              if(++nspacer[offset] == spacer[offset])
-                x[offset] += fix[offset];
-            }
+              subPanelUpdate(p);
+
+              /* Relayout only when item size changed */
+              if(width != p->width) s->flags |= SUB_SCREEN_LAYOUT;
 
-          x[offset] += p->width;
+              p->flags       |= SUB_PANEL_DIRTY;
+              s->flags       |= SUB_SCREEN_DAMAGE;
+              subtle->flags  |= SUB_SUBTLE_DIRTY;
+            }
         }
     }
-
-  subSubtleLogDebugSubtle("Update\n");
 } /* }}} */
 
- /** subScreenRender {{{
-  * @brief Render screens
+ /** subScreenFlush {{{
+  * @brief Update and render all dirty screens at once
   **/
 
 void
-subScreenRender(void)
+subScreenFlush(void)
 {
-  int i, j;
+  int i, nrender = 0;
 
-  /* Render all screens */
+  if(!(subtle->flags & SUB_SUBTLE_DIRTY)) return;
+
+  subtle->flags &= ~SUB_SUBTLE_DIRTY;
+
+  /* Pass 1: Update layout */
   for(i = 0; i < subtle->screens->ndata; i++)
     {
       SubScreen *s = SCREEN(subtle->screens->data[i]);
-      Window panel = s->panel1;
 
-      ScreenClear(s, subtle->styles.subtle.top);
+      if(s->flags & SUB_SCREEN_UPDATE)
+        s->flags |= SUB_SCREEN_RENDER; ///< Layout change requires render
 
-      /* Render panel items */
-      for(j = 0; s->panels && j < s->panels->ndata; j++)
-        {
-          SubPanel *p = PANEL(s->panels->data[j]);
-
-          if(p->flags & SUB_PANEL_HIDDEN) continue;
-          if(panel != s->panel2 && p->flags & SUB_PANEL_BOTTOM)
-            {
-              XCopyArea(subtle->dpy, s->drawable, panel, subtle->gcs.draw,
-                0, 0, s->base.width, subtle->ph, 0, 0);
+      if(s->flags & (SUB_SCREEN_UPDATE|SUB_SCREEN_LAYOUT)) ScreenUpdate(s);
+    }
 
-              ScreenClear(s, subtle->styles.subtle.bottom);
-              panel = s->panel2;
-            }
+  /* Pass 2: Render panels */
+  for(i = 0; i < subtle->screens->ndata; i++)
+    {
+      SubScreen *s = SCREEN(subtle->screens->data[i]);
 
-          subPanelRender(p, s->drawable);
+      if(s->flags & SUB_SCREEN_RENDER)
+        {
+          ScreenRender(s);
+          nrender++;
+        }
+      else if(s->flags & SUB_SCREEN_DAMAGE)
+        {
+          ScreenRepair(s);
+          nrender++;
         }
-
-      XCopyArea(subtle->dpy, s->drawable, panel, subtle->gcs.draw,
-        0, 0, s->base.width, subtle->ph, 0, 0);
     }
 
-  XSync(subtle->dpy, False); ///< Sync before going on
+  if(0 < nrender) SYNC(); ///< Sync once per flush
 
-  subSubtleLogDebugSubtle("Render\n");
+  subSubtleLogDebugSubtle("Flush: screens=%d\n", nrender);
 } /* }}} */
 
  /** subScreenResize {{{
@@ -633,8 +908,34 @@ subScreenResize(void)
       if(s->drawable) XFreePixmap(subtle->dpy, s->drawable);
       s->drawable = XCreatePixmap(subtle->dpy, ROOT, s->base.width, subtle->ph,
         XDefaultDepth(subtle->dpy, DefaultScreen(subtle->dpy)));
+
+#ifdef HAVE_X11_EXTENSIONS_XRENDER_H
+      /* Create/update picture for compositing */
+      if(s->picture) XRenderFreePicture(subtle->dpy, s->picture);
+      s->picture = None;
+
+      if(subtle->flags & SUB_SUBTLE_COMPOSITE)
+        {
+          s->picture = XRenderCreatePicture(subtle->dpy, s->drawable,
+            XRenderFindVisualFormat(subtle->dpy,
+            DefaultVisual(subtle->dpy, DefaultScreen(subtle->dpy))), 0, NULL);
+        }
+#endif /* HAVE_X11_EXTENSIONS_XRENDER_H */
     }
 
+  /* Windows covering screens must follow the new geometry */
+  for(i = 0; i < subtle->clients->ndata; i++)
+    {
+      SubClient *c = CLIENT(subtle->clients->data[i]);
+
+      if(c->flags & (SUB_CLIENT_MODE_FULL|SUB_CLIENT_TYPE_DESKTOP|
+          SUB_CLIENT_TYPE_DOCK))
+        c->flags |= SUB_CLIENT_ARRANGE;
+    }
+
+  /* Panel height might have changed */
+  subPanelPurge();
+
   ScreenPublish();
 
   subSubtleLogDebugSubtle("Resize\n");
@@ -669,6 +970,13 @@ subScreenKill(SubScreen *s)
 
   if(s->panels) subArrayKill(s->panels, True);
 
+  /* Free client index */
+  if(s->index)
+    {
+      if(s->index->stack) free(s->index->stack);
+      free(s->index);
+    }
+
   /* Destroy panel windows */
   if(s->panel1)
     {
@@ -682,6 +990,9 @@ subScreenKill(SubScreen *s)
     }
 
   /* Destroy drawable */
+#ifdef HAVE_X11_EXTENSIONS_XRENDER_H
+  if(s->picture) XRenderFreePicture(subtle->dpy, s->picture);
+#endif /* HAVE_X11_EXTENSIONS_XRENDER_H */
   if(s->drawable) XFreePixmap(subtle->dpy, s->drawable);
 
   free(s);
@@ -716,7 +1027,7 @@ subScreenPublish(void)
 
   free(views);
 
-  XSync(subtle->dpy, False); ///< Sync all changes
+  SYNC(); ///< Sync all changes
 
   subSubtleLogDebugSubtle("Publish: screens=%d\n",
     subtle->screens->ndata);
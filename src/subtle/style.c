@@ -107,6 +107,29 @@ StyleFont(SubStyle *s,
     }
 } /* }}} */
 
+/* StyleColors {{{ */
+static void
+StyleColors(SubStyle *s,
+  long **pixels,
+  int *npixels)
+{
+  int i;
+
+  if(!s) return;
+
+  /* Collect text colors */
+  *pixels = (long *)subSharedMemoryRealloc(*pixels,
+    (*npixels + 3) * sizeof(long));
+
+  (*pixels)[(*npixels)++] = s->fg;
+  (*pixels)[(*npixels)++] = s->bg;
+  (*pixels)[(*npixels)++] = s->icon;
+
+  /* Check nested styles */
+  for(i = 0; s->styles && i < s->styles->ndata; i++)
+    StyleColors(STYLE(s->styles->data[i]), pixels, npixels);
+} /* }}} */
+
 /* Public */
 
  /** subStyleNew {{{
@@ -287,6 +310,9 @@ subStyleKill(SubStyle *s)
 void
 subStyleUpdate(void)
 {
+  int npixels = 0;
+  long *pixels = NULL;
+
   /* Inherit styles */
   StyleInherit(&subtle->styles.views,     &subtle->styles.all);
   StyleInherit(&subtle->styles.title,     &subtle->styles.all);
@@ -302,7 +328,20 @@ subStyleUpdate(void)
   StyleFont(subtle->styles.viewsep,      "view separator");
   StyleFont(subtle->styles.subletsep,    "sublet separator");
 
-  subSubtleLogDebugSubtle("Update\n");
+  /* Resolve text colors once for drawing */
+  StyleColors(&subtle->styles.title,     &pixels, &npixels);
+  StyleColors(&subtle->styles.views,     &pixels, &npixels);
+  StyleColors(&subtle->styles.sublets,   &pixels, &npixels);
+  StyleColors(&subtle->styles.separator, &pixels, &npixels);
+
+  subSharedColorPin(subtle->dpy, pixels, npixels);
+
+  if(pixels) free(pixels);
+
+  /* Styles changed, drop cached panel pieces */
+  subPanelPurge();
+
+  subSubtleLogDebugSubtle("Update: colors=%d\n", npixels);
 } /* }}} */
 
 // vim:ts=2:bs=2:sw=2:et:fdm=marker
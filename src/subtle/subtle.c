@@ -149,18 +149,18 @@ subSubtleFind(Window win,
 } /* }}} */
 
  /** subSubtleTime {{{
-  * @brief Get the current time in seconds
-  * @return Returns time in seconds
+  * @brief Get the current time in milliseconds
+  * @return Returns time in milliseconds
   **/
 
-time_t
+long long
 subSubtleTime(void)
 {
   struct timeval tv;
 
   gettimeofday(&tv, 0);
 
-  return tv.tv_sec;
+  return (long long)tv.tv_sec * 1000 + tv.tv_usec / 1000;
 } /* }}} */
 
  /** subSubtleLog {{{
@@ -234,8 +234,12 @@ subSubtleFinish(void)
 
           /* Clear hooks first to stop calling */
           subArrayClear(subtle->hooks, True);
+          subtle->flags |= SUB_SUBTLE_HOOKS;
         }
 
+      /* Free cached panel pieces */
+      subPanelPurge();
+
       /* Kill arrays */
       if(subtle->clients)   subArrayKill(subtle->clients,   True);
       if(subtle->grabs)     subArrayKill(subtle->grabs,     True);
@@ -256,6 +260,8 @@ subSubtleFinish(void)
       subStyleReset(&subtle->styles.clients,   0);
       subStyleReset(&subtle->styles.subtle,    0);
 
+      subHostFinish();
+      subIpcFinish();
       subEventFinish();
       subRubyFinish();
       subEwmhFinish();
@@ -290,7 +296,8 @@ main(int argc,
 
   /* Create subtle */
   subtle = (SubSubtle *)(subSharedMemoryAlloc(1, sizeof(SubSubtle)));
-  subtle->flags    |= (SUB_SUBTLE_XRANDR|SUB_SUBTLE_XINERAMA);
+  subtle->flags    |= (SUB_SUBTLE_XRANDR|SUB_SUBTLE_XINERAMA|
+    SUB_SUBTLE_XRENDER);
   subtle->loglevel  = DEFAULT_LOGLEVEL;
 
   /* Parse arguments */
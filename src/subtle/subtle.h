@@ -37,11 +37,15 @@
 #ifdef HAVE_X11_EXTENSIONS_XRANDR_H
 #include <X11/extensions/Xrandr.h>
 #endif /* HAVE_X11_EXTENSIONS_XRANDR_H */
+
+#ifdef HAVE_X11_EXTENSIONS_XRENDER_H
+#include <X11/extensions/Xrender.h>
+#endif /* HAVE_X11_EXTENSIONS_XRENDER_H */
 /* }}} */
 
 /* Macros {{{ */
 #define FLAGS        unsigned int                                 ///< Flags
-#define TAGS         unsigned int                                 ///< Tags
+#define TAGS         SubBits                                      ///< Tags
 
 #define CLIENTID     1L                                           ///< Client data id
 #define TRAYID       2L                                           ///< Tray data id
@@ -51,7 +55,12 @@
 #define MINH         1L                                           ///< Client min height
 #define WAITTIME     10                                           ///< Max waiting time
 #define HISTORYSIZE  5                                            ///< Size of the focus history
-#define DEFAULTTAG   (1L << 1)                                    ///< Default tag
+#define DEFAULTTAG   1                                            ///< Default tag bit
+#define INDEXSIZE    8                                            ///< Client index cells per screen axis
+#define INDEXCELLS   (INDEXSIZE * INDEXSIZE)                      ///< Client index cells per screen
+#define HOSTTIMEOUT  10000                                        ///< Max sublet run time in host in ms
+#define HOSTRESPAWN  5000                                         ///< Min host lifetime before restart in ms
+#define TEXTICONS    32                                           ///< Size of the icon geometry cache
 
 #define GRAVITYSTRLIMIT 1                                         ///< Gravity string limit to ignore \0
 
@@ -98,12 +107,14 @@
 #define VISIBLE(C) VISIBLETAGS(C,subtle->visible_tags)            ///< Whether client is visible
 
 #define VISIBLETAGS(C,Tags) \
-  (C && (Tags & c->tags || \
+  (C && (subSharedBitsAny(&(Tags), &(C)->tags) || \
   C->flags & (SUB_CLIENT_TYPE_DESKTOP|SUB_CLIENT_MODE_STICK)))    ///< Whether client is visible on tags
 
 #define ROOT DefaultRootWindow(subtle->dpy)                       ///< Root window
 #define SCRN DefaultScreen(subtle->dpy)                           ///< Default screen
 
+#define SYNC() subDisplaySync(__FILE__, __LINE__)                 ///< Sync or flush display
+
 /* Logging macros */
 #define subSubtleLogError(...) \
   subSubtleLog(SUB_LOG_ERROR, __FILE__, __LINE__, __VA_ARGS__);
@@ -200,6 +211,7 @@
 #define SUB_CALL_OVER                 (1L << 16)                  ///< Call mouse over hook
 #define SUB_CALL_OUT                  (1L << 17)                  ///< Call mouse out hook
 #define SUB_CALL_UNLOAD               (1L << 18)                  ///< Call unload hook
+#define SUB_CALL_HOOK                 (1L << 19)                  ///< Call registered hook
 
 /* Hook flags */
 #define SUB_HOOK_START                (1L << 10)                  ///< Start hook
@@ -304,6 +316,7 @@
 #define SUB_PANEL_DOWN                (1L << 25)                  ///< Panel mouse down
 #define SUB_PANEL_OVER                (1L << 26)                  ///< Panel mouse over
 #define SUB_PANEL_OUT                 (1L << 27)                  ///< Panel mouse out
+#define SUB_PANEL_DIRTY               (1L << 28)                  ///< Panel needs repaint
 
 /* Sublet flags */
 #define SUB_SUBLET_INTERVAL           (1L << 10)                  ///< Sublet has interval
@@ -314,11 +327,26 @@
 #define SUB_SUBLET_DATA               (1L << 14)                  ///< Sublet data function
 #define SUB_SUBLET_WATCH              (1L << 15)                  ///< Sublet watch function
 #define SUB_SUBLET_UNLOAD             (1L << 16)                  ///< Sublet unload function
+#define SUB_SUBLET_STALL              (1L << 17)                  ///< Sublet stalled the host
+
+/* Host messages */
+#define SUB_HOST_RUN                  0                           ///< Host starts sublet run
+#define SUB_HOST_DONE                 1                           ///< Host finished sublet run
+#define SUB_HOST_DATA                 2                           ///< Host sets sublet data
+#define SUB_HOST_STYLE                3                           ///< Host sets sublet style
+#define SUB_HOST_SHOW                 4                           ///< Host shows sublet
+#define SUB_HOST_HIDE                 5                           ///< Host hides sublet
+#define SUB_HOST_INTERVAL             6                           ///< Host sets sublet interval
+#define SUB_HOST_EXIT                 7                           ///< Host has nothing left to do
 
 /* Screen flags */
 #define SUB_SCREEN_PANEL1             (1L << 10)                  ///< Screen sanel1 enabled
 #define SUB_SCREEN_PANEL2             (1L << 11)                  ///< Screen sanel2 enabled
 #define SUB_SCREEN_STIPPLE            (1L << 12)                  ///< Screen stipple enabled
+#define SUB_SCREEN_UPDATE             (1L << 13)                  ///< Screen needs update
+#define SUB_SCREEN_RENDER             (1L << 14)                  ///< Screen needs render
+#define SUB_SCREEN_DAMAGE             (1L << 15)                  ///< Screen needs repaint of items
+#define SUB_SCREEN_LAYOUT             (1L << 16)                  ///< Screen needs relayout of items
 
 /* Style flags */
 #define SUB_STYLE_FONT                (1L << 10)                  ///< Style has custom font
@@ -341,6 +369,18 @@
 #define SUB_SUBTLE_FOCUS_CLICK        (1L << 13)                  ///< Click to focus
 #define SUB_SUBTLE_SKIP_WARP          (1L << 14)                  ///< Skip pointer warp
 #define SUB_SUBTLE_SKIP_URGENT_WARP   (1L << 15)                  ///< Skip urgent warp
+#define SUB_SUBTLE_DIRTY              (1L << 16)                  ///< Screens need flush
+#define SUB_SUBTLE_ASYNC              (1L << 17)                  ///< Flush instead of sync
+#define SUB_SUBTLE_SCAN               (1L << 18)                  ///< Scanning windows
+#define SUB_SUBTLE_XRENDER            (1L << 19)                  ///< Using Xrender
+#define SUB_SUBTLE_COMPOSITE          (1L << 20)                  ///< Composite panels
+#define SUB_SUBTLE_PUBLISH            (1L << 21)                  ///< Published changes pending
+#define SUB_SUBTLE_OPAQUE             (1L << 22)                  ///< Opaque move/resize
+#define SUB_SUBTLE_INDEX              (1L << 23)                  ///< Client index needs rebuild
+#define SUB_SUBTLE_HOST               (1L << 24)                  ///< Run sublets in host process
+#define SUB_SUBTLE_HOSTED             (1L << 25)                  ///< Running as sublet host
+#define SUB_SUBTLE_HOOKS              (1L << 26)                  ///< Hook table needs rebuild
+#define SUB_SUBTLE_RESPAWN            (1L << 27)                  ///< Sublet host needs restart
 
 /* Tag flags */
 #define SUB_TAG_GRAVITY               (1L << 10)                  ///< Gravity property
@@ -432,10 +472,16 @@
 /* Typedefs {{{ */
 typedef struct subarray_t /* {{{ */
 {
-  int   ndata;                                                    ///< Array data count
+  int   ndata, size;                                              ///< Array data count, capacity
   void **data;                                                    ///< Array data
 } SubArray; /* }}} */
 
+typedef struct substats_t /* {{{ */
+{
+  unsigned long calls, objects;                                   ///< Stats call and allocated object count
+  long long     total, max;                                       ///< Stats total and max time in us
+} SubStats; /* }}} */
+
 typedef struct subkeychain_t /* {{{ */
 {
   int              len;                                           ///< Keychain length
@@ -455,119 +501,13 @@ typedef struct subclient_t /* {{{ */
   float      minr, maxr;                                          ///< Client ratios
   int        minw, minh, maxw, maxh, incw, inch, basew, baseh;    ///< Client sizes
 
-  int        dir, screenid, gravityid;                            ///< Client restacking dir, current screen id, current gravity id
+  int        screenid, gravityid;                                 ///< Client current screen id, current gravity id
+  int        mapstate, mapview, mapscreen;                        ///< Client configured state, view id and screen id
   int        *gravities;                                          ///< Client gravities for views
-} SubClient; /* }}} */
 
-typedef enum subewmh_t /* {{{ */
-{
-  /* ICCCM */
-  SUB_EWMH_WM_NAME,                                               ///< Name of window
-  SUB_EWMH_WM_CLASS,                                              ///< Class of window
-  SUB_EWMH_WM_STATE,                                              ///< Window state
-  SUB_EWMH_WM_PROTOCOLS,                                          ///< Supported protocols
-  SUB_EWMH_WM_TAKE_FOCUS,                                         ///< Send focus messages
-  SUB_EWMH_WM_DELETE_WINDOW,                                      ///< Send close messages
-  SUB_EWMH_WM_NORMAL_HINTS,                                       ///< Window normal hints
-  SUB_EWMH_WM_SIZE_HINTS,                                         ///< Window size hints
-  SUB_EWMH_WM_HINTS,                                              ///< Window hints
-  SUB_EWMH_WM_WINDOW_ROLE,                                        ///< Window role
-  SUB_EWMH_WM_CLIENT_LEADER,                                      ///< Client leader
-
-  /* EWMH */
-  SUB_EWMH_NET_SUPPORTED,                                         ///< Supported states
-  SUB_EWMH_NET_CLIENT_LIST,                                       ///< List of clients
-  SUB_EWMH_NET_CLIENT_LIST_STACKING,                              ///< List of clients
-  SUB_EWMH_NET_NUMBER_OF_DESKTOPS,                                ///< Total number of views
-  SUB_EWMH_NET_DESKTOP_NAMES,                                     ///< Names of the views
-  SUB_EWMH_NET_DESKTOP_GEOMETRY,                                  ///< Desktop geometry
-  SUB_EWMH_NET_DESKTOP_VIEWPORT,                                  ///< Viewport of the view
-  SUB_EWMH_NET_CURRENT_DESKTOP,                                   ///< Number of current view
-  SUB_EWMH_NET_ACTIVE_WINDOW,                                     ///< Focus window
-  SUB_EWMH_NET_WORKAREA,                                          ///< Workarea of the views
-  SUB_EWMH_NET_SUPPORTING_WM_CHECK,                               ///< Check for compliant window manager
-  SUB_EWMH_NET_WM_FULL_PLACEMENT,                                 ///< WM does all placement
-  SUB_EWMH_NET_FRAME_EXTENTS,                                     ///< Extents of the client frame
-
-  /* Client */
-  SUB_EWMH_NET_CLOSE_WINDOW,                                      ///< Close window
-  SUB_EWMH_NET_RESTACK_WINDOW,                                    ///< Change window stacking
-  SUB_EWMH_NET_MOVERESIZE_WINDOW,                                 ///< Resize window
-  SUB_EWMH_NET_WM_NAME,                                           ///< Name of client
-  SUB_EWMH_NET_WM_PID,                                            ///< PID of client
-  SUB_EWMH_NET_WM_DESKTOP,                                        ///< Desktop client is on
-  SUB_EWMH_NET_WM_STRUT,                                          ///< Strut
-
-  /* Types */
-  SUB_EWMH_NET_WM_WINDOW_TYPE,                                    ///< Window type
-  SUB_EWMH_NET_WM_WINDOW_TYPE_DOCK,                               ///< Dock window
-  SUB_EWMH_NET_WM_WINDOW_TYPE_DESKTOP,                            ///< Desktop window
-  SUB_EWMH_NET_WM_WINDOW_TYPE_TOOLBAR,                            ///< Toolbar window
-  SUB_EWMH_NET_WM_WINDOW_TYPE_SPLASH,                             ///< Splash window
-  SUB_EWMH_NET_WM_WINDOW_TYPE_DIALOG,                             ///< Dialog window
-
-  /* States */
-  SUB_EWMH_NET_WM_STATE,                                          ///< Window state
-  SUB_EWMH_NET_WM_STATE_FULLSCREEN,                               ///< Fullscreen window
-  SUB_EWMH_NET_WM_STATE_ABOVE,                                    ///< Floating window
-  SUB_EWMH_NET_WM_STATE_STICKY,                                   ///< Sticky window
-  SUB_EWMH_NET_WM_STATE_ATTENTION,                                ///< Urgent window
-
-  /* Tray */
-  SUB_EWMH_NET_SYSTEM_TRAY_OPCODE,                                ///< Tray messages
-  SUB_EWMH_NET_SYSTEM_TRAY_MESSAGE_DATA,                          ///< Tray message data
-  SUB_EWMH_NET_SYSTEM_TRAY_SELECTION,                             ///< Tray selection
-
-  /* Misc */
-  SUB_EWMH_UTF8,                                                  ///< String encoding
-  SUB_EWMH_MANAGER,                                               ///< Selection manager
-  SUB_EWMH_MOTIF_WM_HINTS,                                        ///< Motif decoration hints
-
-  /* XEmbed */
-  SUB_EWMH_XEMBED,                                                ///< XEmbed
-  SUB_EWMH_XEMBED_INFO,                                           ///< XEmbed info
-
-  /* subtle */
-  SUB_EWMH_SUBTLE_CLIENT_TAGS,                                    ///< Subtle client tags
-  SUB_EWMH_SUBTLE_CLIENT_RETAG,                                   ///< Subtle client retag
-  SUB_EWMH_SUBTLE_CLIENT_GRAVITY,                                 ///< Subtle client gravity
-  SUB_EWMH_SUBTLE_CLIENT_SCREEN,                                  ///< Subtle client screen
-  SUB_EWMH_SUBTLE_CLIENT_FLAGS,                                   ///< Subtle client flags
-  SUB_EWMH_SUBTLE_GRAVITY_NEW,                                    ///< Subtle gravity new
-  SUB_EWMH_SUBTLE_GRAVITY_FLAGS,                                  ///< Subtle gravity flags
-  SUB_EWMH_SUBTLE_GRAVITY_LIST,                                   ///< Subtle gravity list
-  SUB_EWMH_SUBTLE_GRAVITY_KILL,                                   ///< Subtle gravtiy kill
-  SUB_EWMH_SUBTLE_TAG_NEW,                                        ///< Subtle tag new
-  SUB_EWMH_SUBTLE_TAG_LIST,                                       ///< Subtle tag list
-  SUB_EWMH_SUBTLE_TAG_KILL,                                       ///< Subtle tag kill
-  SUB_EWMH_SUBTLE_TRAY_LIST,                                      ///< Subtle tray list
-  SUB_EWMH_SUBTLE_VIEW_NEW,                                       ///< Subtle view new
-  SUB_EWMH_SUBTLE_VIEW_TAGS,                                      ///< Subtle view tags
-  SUB_EWMH_SUBTLE_VIEW_STYLE,                                     ///< Subtle view style
-  SUB_EWMH_SUBTLE_VIEW_ICONS,                                     ///< Subtle view icons
-  SUB_EWMH_SUBTLE_VIEW_KILL,                                      ///< Subtle view kill
-  SUB_EWMH_SUBTLE_SUBLET_UPDATE,                                  ///< Subtle sublet update
-  SUB_EWMH_SUBTLE_SUBLET_DATA,                                    ///< Subtle sublet data
-  SUB_EWMH_SUBTLE_SUBLET_STYLE,                                   ///< Subtle sublet style
-  SUB_EWMH_SUBTLE_SUBLET_FLAGS,                                   ///< Subtle sublet flags
-  SUB_EWMH_SUBTLE_SUBLET_LIST,                                    ///< Subtle sublet list
-  SUB_EWMH_SUBTLE_SUBLET_KILL,                                    ///< Subtle sublet kill
-  SUB_EWMH_SUBTLE_SCREEN_PANELS,                                  ///< Subtle screen panels
-  SUB_EWMH_SUBTLE_SCREEN_VIEWS,                                   ///< Subtle screen views
-  SUB_EWMH_SUBTLE_SCREEN_JUMP,                                    ///< Subtle screen jump
-  SUB_EWMH_SUBTLE_VISIBLE_TAGS,                                   ///< Subtle visible tags
-  SUB_EWMH_SUBTLE_VISIBLE_VIEWS,                                  ///< Subtle visible views
-  SUB_EWMH_SUBTLE_RENDER,                                         ///< Subtle render
-  SUB_EWMH_SUBTLE_RELOAD,                                         ///< Subtle reload
-  SUB_EWMH_SUBTLE_RESTART,                                        ///< Subtle restart
-  SUB_EWMH_SUBTLE_QUIT,                                           ///< Subtle quit
-  SUB_EWMH_SUBTLE_COLORS,                                         ///< Subtle colors
-  SUB_EWMH_SUBTLE_FONT,                                           ///< Subtle font
-  SUB_EWMH_SUBTLE_DATA,                                           ///< Subtle data
-  SUB_EWMH_SUBTLE_VERSION,                                        ///< Subtle version
-
-  SUB_EWMH_TOTAL
-} SubEwmh; /* }}} */
+  int        tileid;                                              ///< Client tile list (index + 1)
+  struct subclient_t *tileprev, *tilenext;                        ///< Client tile list links
+} SubClient; /* }}} */
 
 typedef struct subgrab_t /* {{{ */
 {
@@ -590,19 +530,41 @@ typedef struct subgravity_t /* {{{ */
 typedef struct subhook_t /* {{{ */
 {
   FLAGS         flags;                                            ///< Hook flags
-  unsigned long proc;                                             ///< Hook proc
+  int           arity;                                            ///< Hook call arity
+  unsigned long proc, recv, meth;                                 ///< Hook proc, receiver and method id
+  SubStats      stats;                                            ///< Hook call stats
 } SubHook; /* }}} */
 
+typedef struct subhostmessage_t /* {{{ */
+{
+  int           type, id, len;                                    ///< Message type, sublet id, data length
+} SubHostMessage; /* }}} */
+
+typedef struct subipcdata_t /* {{{ */
+{
+  char          *data;                                            ///< Message extra data
+  int           len;                                              ///< Message extra data length
+} SubIpcData; /* }}} */
+
 typedef struct subicon_t /* {{{ */
 {
   int     width, height, bitmap;                                  ///< Icon height, bitmap
   Pixmap  pixmap;                                                 ///< Icon pixmap
 } SubIcon; /* }}} */
 
+typedef struct subindex_t /* {{{ */
+{
+  int        cells[INDEXCELLS + 1];                               ///< Index cell offsets
+  XRectangle bounds[INDEXCELLS];                                  ///< Index cell center bounds
+
+  int        *stack, nstack;                                      ///< Index client stack positions
+} SubIndex; /* }}} */
+
 typedef struct subpanel_t /* {{{ */
 {
   FLAGS                   flags;                                  ///< Panel flags
   int                     x, width;                               ///< Panel x, width
+  int                     ox, owidth;                             ///< Panel rendered x, width
   struct subscreen_t      *screen;                                ///< Panel screen
 
   union {
@@ -616,12 +578,16 @@ typedef struct subscreen_t /* {{{ */
 {
   FLAGS             flags;                                        ///< Screen flags
 
-  int               viewid;                                       ///< Screen current view id
+  int               viewid, refresh;                              ///< Screen current view id, refresh rate
   XRectangle        geom, base;                                   ///< Screen geom, base
   Pixmap            stipple;                                      ///< Screen stipple
   Drawable          drawable;                                     ///< Screen drawable
+#ifdef HAVE_X11_EXTENSIONS_XRENDER_H
+  Picture           picture;                                      ///< Screen drawable picture
+#endif /* HAVE_X11_EXTENSIONS_XRENDER_H */
   Window            panel1, panel2;                               ///< Screen windows
   struct subarray_t *panels;                                      ///< Screen panels
+  struct subindex_t *index;                                       ///< Screen client index
 
   /* FIXME: Cache ruby object during config */
   unsigned long     top, bottom;                                  ///< Screen panel values
@@ -635,10 +601,11 @@ typedef struct subseparator_t /* {{{ */
 
 typedef struct subsublet_t { /* {{{ */
   FLAGS             flags;                                        ///< Sublet flags
-  int               watch, width, styleid;                        ///< Sublet watch id, width and style id
+  int               watch, width, styleid, timer;                 ///< Sublet watch id, width, style id and timer slot
   char              *name;                                        ///< Sublet name
   unsigned long     instance;                                     ///< Sublet ruby instance, fg, bg and icon color
-  time_t            time, interval;                               ///< Sublet update/interval time
+  long long         time, interval;                               ///< Sublet update/interval time in ms
+  SubStats          stats;                                        ///< Sublet call stats
 
   struct subtext_t  *text;                                        ///< Sublet text
 } SubSublet; /* }}} */
@@ -665,9 +632,9 @@ typedef struct subsubtle_t /* {{{ */
   FLAGS                flags;                                     ///< Subtle flags
 
   int                  loglevel, width, height;                   ///< Subtle loglevel and screen size
-  int                  ph, step, snap;                            ///< Subtle properties
-  int                  visible_tags, visible_views;               ///< Subtle visible tags and views
-  int                  client_tags, urgent_tags;                  ///< Subtle clients and urgent tags
+  int                  ph, step, snap, fps;                       ///< Subtle properties
+  TAGS                 visible_tags, visible_views;               ///< Subtle visible tags and views
+  TAGS                 client_tags, urgent_tags;                  ///< Subtle clients and urgent tags
   unsigned long        gravity;                                   ///< Subtle default gravity
 
   Display              *dpy;                                      ///< Subtle Xorg display
@@ -684,6 +651,8 @@ typedef struct subsubtle_t /* {{{ */
   struct subarray_t    *trays;                                    ///< Subtle trays
   struct subarray_t    *views;                                    ///< Subtle views
 
+  int                  host;                                      ///< Subtle sublet host descriptor
+  int                  ipc;                                       ///< Subtle socket descriptor
 #ifdef HAVE_SYS_INOTIFY_H
   int                  notify;                                    ///< Subtle inotify descriptor
 #endif /* HAVE_SYS_INOTIFY_H */
@@ -736,6 +705,7 @@ typedef struct subtag_t /* {{{ */
 typedef struct subtextitem_t /* {{{ */
 {
   int             flags, width, height;                           ///< Text flags, width, height
+  int             left, right;                                    ///< Text bearings
   long            color;                                          ///< Text color
 
   union subdata_t data;                                           ///< Text data
@@ -745,6 +715,8 @@ typedef struct subtext_t /* {{{ */
 {
   struct subtextitem_t **items;                                   ///< Item text items
   int                  flags, nitems, width;                      ///< Item flags, count, width
+  unsigned long        hash;                                      ///< Item hash of last text
+  struct subfont_t     *font;                                     ///< Item font of last text
 } SubText; /* }}} */
 
 typedef struct subtray_t /* {{{ */
@@ -773,8 +745,12 @@ extern SubSubtle *subtle;
 /* array.c {{{ */
 SubArray *subArrayNew(void);                                      ///< Create array
 void subArrayPush(SubArray *a, void *elem);                       ///< Push element to array
+void subArrayPushAll(SubArray *a, void **elems, int n);           ///< Push elements to array
 void subArrayInsert(SubArray *a, int pos, void *elem);            ///< Insert element at pos
 void subArrayRemove(SubArray *a, void *elem);                     ///< Remove element from array
+void *subArrayRemoveAt(SubArray *a, int idx);                     ///< Remove element at pos
+void *subArraySwapRemove(SubArray *a, int idx);                   ///< Remove element unordered
+void subArrayRemoveAll(SubArray *a, void **elems, int n);         ///< Remove elements from array
 void *subArrayGet(SubArray *a, int idx);                          ///< Get element
 int subArrayIndex(SubArray *a, void *elem);                       ///< Find array id of element
 void subArraySort(SubArray *a,                                    ///< Sort array with given compare function
@@ -784,12 +760,16 @@ void subArrayKill(SubArray *a, int clean);                        ///< Kill arra
 /* }}} */
 
 /* client.c {{{ */
-SubClient *subClientNew(Window win);                              ///< Create client
+void subClientPrefetch(Window *wins, int nwins);                  ///< Prefetch client properties
+SubClient *subClientNew(Window win, XWindowAttributes *wattrs);   ///< Create client
 void subClientConfigure(SubClient *c);                            ///< Send configure request
 void subClientDimension(int id);                                  ///< Dimension clients
 void subClientFocus(SubClient *c, int warp);                      ///< Focus client
 SubClient *subClientNext(int screenid, int jump);                 ///< Focus next client
 void subClientWarp(SubClient *c);                                 ///< Warp pointer to client
+void subClientIndex(void);                                        ///< Rebuild client index
+SubClient *subClientNeighbour(SubClient *c, int direction,
+  int history);                                                   ///< Find client in direction
 void subClientDrag(SubClient *c, int mode, int direction);        ///< Move/drag client
 void subClientUpdate(int vid);                                    ///< Update clients
 void subClientTag(SubClient *c, int tag, int *flags);             ///< Tag client
@@ -818,13 +798,19 @@ void subDisplayInit(const char *display);                         ///< Create di
 void subDisplayConfigure(void);                                   ///< Configure display
 void subDisplayScan(void);                                        ///< Scan root window
 void subDisplayPublish(void);                                     ///< Publish colors
+void subDisplaySync(const char *file, int line);                  ///< Sync or flush display
 void subDisplayFinish(void);                                      ///< Kill display
 /* }}} */
 
 /* event.c {{{ */
-void subEventWatchAdd(int fd);                                    ///< Add watch fd
+void subEventWatchAdd(int fd, SubPanel *p, int edge);             ///< Add watch fd
 void subEventWatchDel(int fd);                                    ///< Del watch fd
+void subEventTimerAdd(SubPanel *p);                               ///< Add/update sublet timer
+void subEventTimerDel(SubPanel *p);                               ///< Del sublet timer
+void subEventMessage(Window win, Atom type, int format,
+  SubMessageData *data, SubIpcData *extra);                       ///< Handle socket message
 void subEventLoop(void);                                          ///< Event loop
+void subEventStats(SubStats *stats);                             ///< Get loop counters
 void subEventFinish(void);                                        ///< Finish events
 /* }}} */
 
@@ -838,9 +824,13 @@ void subEwmhSetWindows(Window win, SubEwmh e,
   Window *values, int size);                                      ///< Set window properties
 void subEwmhSetCardinals(Window win, SubEwmh e,
   long *values, int size);                                        ///< Set cardinal properties
+void subEwmhSetTags(Window win, SubEwmh e, TAGS *tags);          ///< Set tag bits
 void subEwmhSetString(Window win, SubEwmh e,
   char *value);                                                   ///< Set string property
+void subEwmhSetStrings(Window win, SubEwmh e,
+  char **list, int nlist);                                        ///< Set string list property
 void subEwmhSetWMState(Window win, long state);                   ///< Set window WM state
+void subEwmhForget(Window win);                                   ///< Drop shadow properties
 void subEwmhTranslateWMState(Atom atom, int *flags);              ///< Translate WM states
 void subEwmhTranslateClientMode(int client_flags, int *flags);    ///< Translate client modes
 int subEwmhMessage(Window win, SubEwmh e, long mask,
@@ -875,16 +865,31 @@ void subHookCall(int type, void *data);                           ///< Call hook
 void subHookKill(SubHook *h);                                     ///< Kill hook
 /* }}} */
 
+/* host.c {{{ */
+void subHostInit(void);                                           ///< Start sublet host
+void subHostReceive(void);                                        ///< Read host messages
+int subHostCheck(long long now);                                  ///< Check for stalled host
+void subHostSend(SubPanel *p, int type, const char *data,
+  int len);                                                       ///< Send host message
+void subHostFinish(void);                                         ///< Stop sublet host
+/* }}} */
+
+/* ipc.c {{{ */
+void subIpcInit(void);                                            ///< Create socket
+int subIpcReceive(int fd);                                        ///< Handle socket activity
+void subIpcFinish(void);                                          ///< Close socket
+/* }}} */
+
 /* panel.c {{{ */
 SubPanel *subPanelNew(int type);                                  ///< Create new panel
 void subPanelUpdate(SubPanel *p);                                 ///< Update panels
 void subPanelRender(SubPanel *p, Drawable drawable);              ///< Render panels
-int subPanelCompare(const void *a, const void *b);                ///< Compare two panels
 void subPanelAction(SubArray *panels, int type, int x, int y,
   int button, int bottom);                                        ///< Handle panel action
 void subPanelGeometry(SubPanel *p, SubStyle *s,
   XRectangle *geom);                                              ///< Get panel geometry
 void subPanelPublish(void);                                       ///< Publish sublets
+void subPanelPurge(void);                                         ///< Purge panel pieces
 void subPanelKill(SubPanel *p);                                   ///< Kill panel
 /* }}} */
 
@@ -896,8 +901,11 @@ void subRubyLoadSublet(const char *file);                         ///< Load subl
 void subRubyUnloadSublet(SubPanel *p);                            ///< Unload sublet
 void subRubyLoadSublets(void);                                    ///< Load sublets
 void subRubyLoadPanels(void);                                     ///< Load panels
-int subRubyCall(int type, unsigned long proc, void *data);        ///< Call Ruby script
+int subRubyCall(int type, unsigned long proc, void *data,
+  SubStats *stats);                                               ///< Call Ruby script
+void subRubyPublish(void);                                        ///< Publish call stats
 int subRubyRelease(unsigned long recv);                           ///< Release receiver
+int subRubyFork(void);                                            ///< Fork Ruby process
 void subRubyFinish(void);                                         ///< Kill Ruby stack
 /* }}} */
 
@@ -910,6 +918,9 @@ SubScreen * subScreenCurrent(int *sid);                           ///< Get curre
 void subScreenConfigure(void);                                    ///< Configure screens
 void subScreenUpdate(void);                                       ///< Update screens
 void subScreenRender(void);                                       ///< Render screens
+void subScreenDirty(SubScreen *s, int flags);                     ///< Mark screens dirty
+void subScreenDamage(int type, SubSublet *sublet);                ///< Mark panel items dirty
+void subScreenFlush(void);                                        ///< Flush dirty screens
 void subScreenResize(void);                                       ///< Update screen sizes
 void subScreenWarp(SubScreen *s);                                 ///< Warp pointer to screen
 void subScreenPublish(void);                                      ///< Publish screens
@@ -927,7 +938,7 @@ void subStyleUpdate(void);                                        ///< Update va
 
 /* subtle.c {{{ */
 XPointer * subSubtleFind(Window win, XContext id);                ///< Find window
-time_t subSubtleTime(void);                                       ///< Get current time
+long long subSubtleTime(void);                                    ///< Get current time in ms
 void subSubtleLog(int level, const char *file,
   int line, const char *format, ...);                             ///< Print messages
 void subSubtleFinish(void);                                       ///< Finish subtle
@@ -937,7 +948,7 @@ void subSubtleFinish(void);                                       ///< Finish su
 SubTag *subTagNew(char *name, int *duplicate);                    ///< Create tag
 void subTagMatcherAdd(SubTag *t, int type,
   char *pattern, int and);                                        ///< Add a matcher
-int subTagMatcherCheck(SubTag *t, SubClient *c);                  ///< Check for match
+TAGS subTagMatcherTags(SubClient *c);                             ///< Get matching tags
 void subTagPublish(void);                                         ///< Publish tags
 void subTagKill(SubTag *t);                                       ///< Delete tag
 /* }}} */
@@ -947,6 +958,7 @@ SubText *subTextNew(void);                                         ///< Create t
 int subTextParse(SubText *t, SubFont *f, char *text);             ///< Parse string
 void subTextRender(SubText *t, SubFont *f, GC gc, Window win,
   int x, int y, long fg, long icon, long bg);                     ///< Render text
+void subTextFlush(void);                                          ///< Flush icon cache
 void subTextKill(SubText *t);                                     ///< Delete text
 /* }}} */
 
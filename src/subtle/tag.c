@@ -12,7 +12,11 @@
 
 #include "subtle.h"
 
-#define MATCHER(m) ((TagMatcher *)m)
+#define MATCHER(m)   ((TagMatcher *)m)
+
+#define FIELDS       4                                            ///< Matched fields
+#define CACHEBUCKETS 64                                           ///< Result cache buckets
+#define CACHEMAX     256                                          ///< Result cache entries
 
 /* Typedef {{{ */
 typedef struct tagmatcher_t
@@ -20,11 +24,227 @@ typedef struct tagmatcher_t
   FLAGS               flags;
   struct tagmatcher_t *and;
   regex_t             *regex;
+  char                *pattern;
+  int                 terms[FIELDS];
 } TagMatcher;
+
+typedef struct tagterm_t
+{
+  int     field;                                                  ///< Term field
+  char    *pattern;                                               ///< Term pattern
+  regex_t *regex;                                                 ///< Term regex
+} TagTerm;
+
+typedef struct tagcache_t
+{
+  unsigned int      hash;                                         ///< Cache hash
+  int               from;                                         ///< Cache first field
+  char              *keys[FIELDS];                                ///< Cache field values
+  char              *hits;                                        ///< Cache term results
+  struct tagcache_t *next;                                        ///< Cache bucket link
+} TagCache;
 /* }}} */
 
+/* Globals */
+static const int fields[FIELDS] = {
+  SUB_TAG_MATCH_NAME, SUB_TAG_MATCH_INSTANCE,
+  SUB_TAG_MATCH_CLASS, SUB_TAG_MATCH_ROLE
+};
+static TagTerm *terms = NULL;
+static int nterms = 0, compiled = False;
+static char *hits = NULL;
+static TagCache *cache[CACHEBUCKETS] = { NULL };
+static int ncache = 0;
+static unsigned long cachehits = 0, cachemisses = 0;
+
 /* Private */
 
+/* TagFlush {{{ */
+static void
+TagFlush(int all)
+{
+  int i, j;
+
+  /* Clear cached results */
+  for(i = 0; i < CACHEBUCKETS; i++)
+    {
+      TagCache *entry = cache[i], *next = NULL;
+
+      while(entry)
+        {
+          next = entry->next;
+
+          for(j = 0; j < FIELDS; j++)
+            if(entry->keys[j]) free(entry->keys[j]);
+
+          free(entry->hits);
+          free(entry);
+
+          entry = next;
+        }
+
+      cache[i] = NULL;
+    }
+
+  ncache = 0;
+
+  /* Drop compiled terms */
+  if(all)
+    {
+      if(terms) free(terms);
+      if(hits)  free(hits);
+
+      terms    = NULL;
+      hits     = NULL;
+      nterms   = 0;
+      compiled = False;
+    }
+} /* }}} */
+
+/* TagCompile {{{ */
+static void
+TagCompile(void)
+{
+  int i, j, k, f;
+
+  TagFlush(True);
+
+  /* Collect distinct pattern and field pairs */
+  for(i = 0; i < subtle->tags->ndata; i++)
+    {
+      SubTag *t = TAG(subtle->tags->data[i]);
+
+      for(j = 0; t->matcher && j < t->matcher->ndata; j++)
+        {
+          TagMatcher *m = MATCHER(t->matcher->data[j]);
+
+          for(f = 0; f < FIELDS; f++)
+            {
+              m->terms[f] = -1;
+
+              if(!m->regex || !(m->flags & fields[f])) continue;
+
+              /* Share terms */
+              for(k = 0; k < nterms; k++)
+                if(terms[k].field == f &&
+                    0 == strcmp(terms[k].pattern, m->pattern))
+                  break;
+
+              if(k == nterms)
+                {
+                  terms = (TagTerm *)subSharedMemoryRealloc(terms,
+                    (nterms + 1) * sizeof(TagTerm));
+
+                  terms[k].field   = f;
+                  terms[k].pattern = m->pattern;
+                  terms[k].regex   = m->regex;
+                  nterms++;
+                }
+
+              m->terms[f] = k;
+            }
+        }
+    }
+
+  hits     = (char *)subSharedMemoryAlloc(MAX(1, nterms), sizeof(char));
+  compiled = True;
+
+  subSubtleLogDebugSubtle("Compile: terms=%d\n", nterms);
+} /* }}} */
+
+/* TagValue {{{ */
+static char *
+TagValue(SubClient *c,
+  int field)
+{
+  switch(field)
+    {
+      case 0: return c->name;
+      case 1: return c->instance;
+      case 2: return c->klass;
+      case 3: return c->role;
+    }
+
+  return NULL;
+} /* }}} */
+
+/* TagLookup {{{ */
+static void
+TagLookup(char **keys,
+  int from,
+  int to)
+{
+  int i;
+  unsigned int hash = 2166136261U ^ (unsigned int)from;
+  TagCache *entry = NULL;
+
+  /* FNV-1a over field values */
+  for(i = from; i < to; i++)
+    {
+      char *key = keys[i] ? keys[i] : "";
+
+      while('\0' != *key)
+        {
+          hash ^= (unsigned char)*key++;
+          hash *= 16777619U;
+        }
+
+      hash ^= keys[i] ? 0xff : 0xfe;
+      hash *= 16777619U;
+    }
+
+  /* Find cached results */
+  for(entry = cache[hash % CACHEBUCKETS]; entry; entry = entry->next)
+    {
+      if(entry->hash != hash || entry->from != from) continue;
+
+      for(i = from; i < to; i++)
+        if(!(keys[i] == entry->keys[i] || (keys[i] && entry->keys[i] &&
+            0 == strcmp(keys[i], entry->keys[i]))))
+          break;
+
+      if(i == to)
+        {
+          for(i = 0; i < nterms; i++)
+            if(from <= terms[i].field && terms[i].field < to)
+              hits[i] = entry->hits[i];
+
+          cachehits++;
+
+          return;
+        }
+    }
+
+  /* Run each distinct regex once */
+  for(i = 0; i < nterms; i++)
+    {
+      if(from <= terms[i].field && terms[i].field < to)
+        {
+          char *value = keys[terms[i].field];
+
+          hits[i] = (value && subSharedRegexMatch(terms[i].regex, value));
+        }
+    }
+
+  if(CACHEMAX <= ncache) TagFlush(False);
+
+  /* Store results */
+  entry = (TagCache *)subSharedMemoryAlloc(1, sizeof(TagCache));
+  entry->hash = hash;
+  entry->from = from;
+  entry->hits = (char *)subSharedMemoryAlloc(MAX(1, nterms), sizeof(char));
+  entry->next = cache[hash % CACHEBUCKETS];
+
+  for(i = from; i < to; i++)
+    if(keys[i]) entry->keys[i] = strdup(keys[i]);
+
+  memcpy(entry->hits, hits, nterms);
+
+  cache[hash % CACHEBUCKETS] = entry;
+  ncache++;
+  cachemisses++;
+} /* }}} */
+
 /* TagClear {{{ */
 static void
 TagClear(SubTag *t)
@@ -38,12 +258,14 @@ TagClear(SubTag *t)
     {
       TagMatcher *m = (TagMatcher *)t->matcher->data[i];
 
-      if(m->regex) subSharedRegexKill(m->regex);
+      if(m->regex)   subSharedRegexKill(m->regex);
+      if(m->pattern) free(m->pattern);
 
       free(m);
     }
 
   subArrayClear(t->matcher, False);
+  TagFlush(True);
 } /* }}} */
 
 /* TagFind {{{ */
@@ -66,28 +288,20 @@ TagFind(char *name)
   return NULL;
 } /* }}} */
 
-/* TagMatch {{{ */
+/* TagTermMatch {{{ */
 static int
-TagMatch(TagMatcher *m,
+TagTermMatch(TagMatcher *m,
   SubClient *c)
 {
-  /* Complex matching */
-  if((m->regex &&
-      /* Check WM_NAME */
-      ((m->flags & SUB_TAG_MATCH_NAME && c->name &&
-        subSharedRegexMatch(m->regex, c->name)) ||
-      /* Check instance part of WM_CLASS */
-      (m->flags & SUB_TAG_MATCH_INSTANCE && c->instance &&
-        subSharedRegexMatch(m->regex, c->instance)) ||
-      /* Check class part of WM_CLASS */
-      (m->flags & SUB_TAG_MATCH_CLASS && c->klass &&
-        subSharedRegexMatch(m->regex, c->klass)) ||
-      /* Check WM_ROLE */
-      (m->flags & SUB_TAG_MATCH_ROLE && c->role &&
-        subSharedRegexMatch(m->regex, c->role)))) ||
-      /* Check _NET_WM_WINDOW_TYPE */
-      (m->flags & SUB_TAG_MATCH_TYPE &&
-        c->flags & (m->flags & (SUB_CLIENT_TYPE_NORMAL|TYPES_ALL))))
+  int f;
+
+  /* Check regex terms */
+  for(f = 0; f < FIELDS; f++)
+    if(0 <= m->terms[f] && hits[m->terms[f]]) return True;
+
+  /* Check _NET_WM_WINDOW_TYPE */
+  if(m->flags & SUB_TAG_MATCH_TYPE &&
+      c->flags & (m->flags & (SUB_CLIENT_TYPE_NORMAL|TYPES_ALL)))
     return True;
 
   return False;
@@ -162,8 +376,9 @@ subTagMatcherAdd(SubTag *t,
     {
       /* Create new matcher */
       m = MATCHER(subSharedMemoryAlloc(1, sizeof(TagMatcher)));
-      m->flags = type;
-      m->regex = regex;
+      m->flags   = type;
+      m->regex   = regex;
+      m->pattern = regex ? strdup(pattern) : NULL;
 
       /* Create on demand to safe memory */
       if(NULL == t->matcher) t->matcher = subArrayNew();
@@ -176,48 +391,73 @@ subTagMatcherAdd(SubTag *t,
         }
 
       subArrayPush(t->matcher, (void *)m);
+
+      TagFlush(True);
     }
 } /* }}} */
 
- /** subTagMatcherCheck {{{
-  * @brief Check if client matches tag
-  * @param[in]  t  A #SubTag
+ /** subTagMatcherTags {{{
+  * @brief Get all tags matching client
   * @param[in]  c  A #SubClient
-  * @retval  True  Client matches
-  * @retval  False Client doesn't match
+  * @return Returns the matching #TAGS
   **/
 
-int
-subTagMatcherCheck(SubTag *t,
-  SubClient *c)
+TAGS
+subTagMatcherTags(SubClient *c)
 {
-  int i;
+  int i, j;
+  TAGS tags;
+  char *keys[FIELDS] = { NULL };
+
+  assert(c);
+
+  if(!compiled) TagCompile();
+
+  subSharedBitsClear(&tags);
+
+  for(i = 0; i < FIELDS; i++) keys[i] = TagValue(c, i);
 
-  assert(t && c);
+  /* Identity and name results are cached separately */
+  if(0 < nterms)
+    {
+      TagLookup(keys, 1, FIELDS);
+      TagLookup(keys, 0, 1);
+    }
 
-  /* Check if a matcher and client fit together */
-  for(i = 0; t->matcher && i < t->matcher->ndata; i++)
+  /* Evaluate chains on term results */
+  for(i = 0; i < subtle->tags->ndata; i++)
     {
-      TagMatcher *m = MATCHER(t->matcher->data[i]);
+      SubTag *t = TAG(subtle->tags->data[i]);
 
-      /* Exclude AND linked matcher */
-      if(!(m->flags & SUB_TAG_MATCH_AND))
+      for(j = 0; t->matcher && j < t->matcher->ndata; j++)
         {
-          int and = True;
-          TagMatcher *cur = m;
+          TagMatcher *m = MATCHER(t->matcher->data[j]);
 
-          /* Check current matcher and chain */
-          while(and && cur)
+          /* Exclude AND linked matcher */
+          if(!(m->flags & SUB_TAG_MATCH_AND))
             {
-              and = TagMatch(cur, c);
-              cur = cur->and;
+              int and = True;
+              TagMatcher *cur = m;
+
+              while(and && cur)
+                {
+                  and = TagTermMatch(cur, c);
+                  cur = cur->and;
+                }
+
+              if(and)
+                {
+                  subSharedBitsSet(&tags, i + 1);
+                  break;
+                }
             }
-
-          if(and) return True;
         }
     }
 
-  return False;
+  subSubtleLogDebugSubtle("Tags: hits=%lu, misses=%lu\n",
+    cachehits, cachemisses);
+
+  return tags;
 } /* }}} */
 
  /** subTagKill {{{
@@ -271,10 +511,9 @@ subTagPublish(void)
     names[i] = TAG(subtle->tags->data[i])->name;
 
   /* EWMH: Tag list */
-  subSharedPropertySetStrings(subtle->dpy, ROOT,
-    subEwmhGet(SUB_EWMH_SUBTLE_TAG_LIST), names, i);
+  subEwmhSetStrings(ROOT, SUB_EWMH_SUBTLE_TAG_LIST, names, i);
 
-  XSync(subtle->dpy, False); ///< Sync all changes
+  subtle->flags |= SUB_SUBTLE_PUBLISH; ///< Sync once per loop
 
   free(names);
 
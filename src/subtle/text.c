@@ -12,6 +12,117 @@
 
 #include "subtle.h"
 
+/* Typedefs {{{ */
+typedef struct texticon_t
+{
+  Pixmap pixmap;                                                  ///< Icon pixmap
+  int    width, height;                                           ///< Icon width, height
+} TextIcon;
+/* }}} */
+
+/* Globals */
+static TextIcon icons[TEXTICONS] = { { None } };
+static int nicons = 0;
+
+/* TextHash {{{ */
+static unsigned long
+TextHash(const char *text)
+{
+  unsigned long hash = 2166136261UL;
+
+  /* FNV-1a */
+  while(text && *text)
+    {
+      hash ^= (unsigned char)*text++;
+      hash *= 16777619UL;
+    }
+
+  return hash;
+} /* }}} */
+
+/* TextIconGeometry {{{ */
+static void
+TextIconGeometry(Pixmap pixmap,
+  int *width,
+  int *height)
+{
+  int i;
+  XRectangle geometry = { 0 };
+
+  /* Check cache first */
+  for(i = 0; i < TEXTICONS; i++)
+    {
+      if(pixmap == icons[i].pixmap)
+        {
+          *width  = icons[i].width;
+          *height = icons[i].height;
+
+          return;
+        }
+    }
+
+  subSharedPropertyGeometry(subtle->dpy, pixmap, &geometry);
+
+  /* Replace oldest entry */
+  icons[nicons].pixmap = pixmap;
+  icons[nicons].width  = geometry.width;
+  icons[nicons].height = geometry.height;
+
+  nicons = (nicons + 1) % TEXTICONS;
+
+  *width  = geometry.width;
+  *height = geometry.height;
+} /* }}} */
+
+/* TextIconEvict {{{ */
+static void
+TextIconEvict(SubText *t)
+{
+  int i, j;
+
+  /* Shown pixmaps may be freed and their ids reused with another size */
+  for(i = 0; i < t->nitems; i++)
+    {
+      SubTextItem *item = ITEM(t->items[i]);
+
+      if(item->flags & (SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP))
+        {
+          for(j = 0; j < TEXTICONS; j++)
+            if((Pixmap)item->data.num == icons[j].pixmap)
+              icons[j].pixmap = None;
+        }
+    }
+} /* }}} */
+
+/* TextItemChanged {{{ */
+static int
+TextItemChanged(SubTextItem *item,
+  int type,
+  char *tok,
+  long pixmap)
+{
+  /* Compare type and content */
+  if(type != (item->flags & (SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP)))
+    return True;
+
+  if(type) return (unsigned long)pixmap != item->data.num;
+
+  return !item->data.string || 0 != strcmp(item->data.string, tok);
+} /* }}} */
+
+/* TextItemAdd {{{ */
+static void
+TextItemAdd(SubText *t,
+  SubTextItem *item,
+  int i)
+{
+  /* Add spacing and check if icon is first */
+  if(item->flags & (SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP))
+    t->width += item->width + (0 == i ? 3 : 6);
+  else ///< Remove left bearing from first text item
+    t->width += item->width - (0 == i ? item->left : 0);
+} /* }}} */
+
  /** subTextNew {{{
   * @brief Create new text
   **/
@@ -35,29 +146,64 @@ subTextParse(SubText *t,
   SubFont *f,
   char *text)
 {
-  int i = 0, left = 0, right = 0;
+  int i = 0;
   char *tok = NULL;
   long color = -1, pixmap = 0;
+  unsigned long hash = 0;
   SubTextItem *item = NULL;
 
   assert(f && t);
 
+  /* Skip unchanged text */
+  if((hash = TextHash(text)) == t->hash && f == t->font)
+    return t->width;
+
+  t->hash  = hash;
+  t->font  = f;
   t->width = 0;
 
+  TextIconEvict(t);
+
   /* Split and iterate over tokens */
   while((tok = strsep(&text, SEPARATOR)))
     {
-      if('#' == *tok) color = strtol(tok + 1, NULL, 0); ///< Color
+      if('#' == *tok) ///< Color
+        {
+          color = strtol(tok + 1, NULL, 0);
+
+#ifdef HAVE_X11_XFT_XFT_H
+          /* Resolve ad-hoc colors once for drawing */
+          if(f->xft) subSharedColorResolve(subtle->dpy, color);
+#endif /* HAVE_X11_XFT_XFT_H */
+        }
       else if('\0' != *tok) ///< Text or icon
         {
+          int type = 0;
+
+          /* Check if token is an icon */
+          if(('!' == *tok || '&' == *tok) &&
+              (pixmap = strtol(tok + 1, NULL, 0)))
+            type = ('!' == *tok ? SUB_TEXT_BITMAP : SUB_TEXT_PIXMAP);
+
           /* Re-use items to save alloc cycles */
           if(i < t->nitems && (item = ITEM(t->items[i])))
             {
+              item->flags &= ~SUB_TEXT_EMPTY;
+
+              /* Keep unchanged items */
+              if(!TextItemChanged(item, type, tok, pixmap))
+                {
+                  item->color = color;
+                  TextItemAdd(t, item, i++);
+
+                  continue;
+                }
+
               if(!(item->flags & (SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP)) &&
                   item->data.string)
                 free(item->data.string);
 
-              item->flags &= ~(SUB_TEXT_EMPTY|SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP);
+              item->flags &= ~(SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP);
             }
           else if((item = ITEM(subSharedMemoryAlloc(1, sizeof(SubTextItem)))))
             {
@@ -68,37 +214,22 @@ subTextParse(SubText *t,
             }
 
           /* Get geometry of bitmap/pixmap */
-          if(('!' == *tok || '&' == *tok) &&
-              (pixmap = strtol(tok + 1, NULL, 0)))
+          if(type)
             {
-              XRectangle geometry = { 0 };
-
-              subSharedPropertyGeometry(subtle->dpy, pixmap, &geometry);
-
-              item->flags    |= ('!' == *tok ? SUB_TEXT_BITMAP :
-                SUB_TEXT_PIXMAP);
+              item->flags    |= type;
               item->data.num  = pixmap;
-              item->width     = geometry.width;
-              item->height    = geometry.height;
 
-              /* Add spacing and check if icon is first */
-              t->width += item->width + (0 == i ? 3 : 6);
-
-              item->color = color;
+              TextIconGeometry(pixmap, &item->width, &item->height);
             }
           else ///< Ordinary text
             {
               item->data.string = strdup(tok);
               item->width       = subSharedStringWidth(subtle->dpy, f, tok,
-                strlen(tok), &left, &right, False);
-
-              /* Remove left bearing from first text item */
-              t->width += item->width - (0 == i ? left : 0);
-
-              item->color = color;
+                strlen(tok), &item->left, &item->right, False);
             }
 
-          i++;
+          item->color = color;
+          TextItemAdd(t, item, i++);
         }
     }
 
@@ -111,11 +242,7 @@ subTextParse(SubText *t,
     {
       if(item->flags & (SUB_TEXT_BITMAP|SUB_TEXT_PIXMAP))
         t->width -= 2;
-      else
-        {
-          t->width    -= right;
-          item->width -= right;
-        }
+      else t->width -= item->right;
     }
 
   return t->width;
@@ -183,6 +310,17 @@ subTextRender(SubText *t,
     }
 } /* }}} */
 
+ /** subTextFlush {{{
+  * @brief Flush icon geometry cache
+  **/
+
+void
+subTextFlush(void)
+{
+  memset(icons, 0, sizeof(icons));
+  nicons = 0;
+} /* }}} */
+
  /** subTextKill {{{
   * @brief Delete text
   * @param[in]  t  A #SubText
@@ -195,6 +333,8 @@ subTextKill(SubText *t)
 
   assert(t);
 
+  TextIconEvict(t);
+
   for(i = 0; i < t->nitems; i++)
     {
       SubTextItem *item = (SubTextItem *)t->items[i];
@@ -238,13 +238,13 @@ subTrayClose(SubTray *t)
       /* Kill it manually */
       XKillClient(subtle->dpy, t->win);
 
-      subArrayRemove(subtle->trays, (void *)t);
+      subArraySwapRemove(subtle->trays, subArrayIndex(subtle->trays,
+        (void *)t)); ///< Tray order is arbitrary
       subTrayKill(t);
       subTrayPublish();
       subTrayUpdate();
 
-      subScreenUpdate();
-      subScreenRender();
+      subScreenDirty(NULL, SUB_SCREEN_UPDATE|SUB_SCREEN_RENDER);
 
       /* Update focus if necessary */
       if(focus)
@@ -270,6 +270,7 @@ subTrayKill(SubTray *t)
   /* Ignore further events and delete context */
   XSelectInput(subtle->dpy, t->win, NoEventMask);
   XDeleteContext(subtle->dpy, t->win, TRAYID);
+  subEwmhForget(t->win);
 
   /* Unembed tray icon following xembed specs */
   XUnmapWindow(subtle->dpy, t->win);
@@ -300,7 +301,7 @@ subTrayPublish(void)
   /* EWMH: Client list and client list stacking */
   subEwmhSetWindows(ROOT, SUB_EWMH_SUBTLE_TRAY_LIST, wins, subtle->trays->ndata);
 
-  XSync(subtle->dpy, False); ///< Sync all changes
+  subtle->flags |= SUB_SUBTLE_PUBLISH; ///< Sync once per loop
 
   free(wins);
 
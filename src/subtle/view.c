@@ -41,7 +41,7 @@ subViewNew(char *name,
 
       for(i = 0; i < subtle->tags->ndata; i++)
         if(subSharedRegexMatch(preg, TAG(subtle->tags->data[i])->name))
-          v->tags |= (1L << (i + 1));
+          subSharedBitsSet(&v->tags, i + 1);
 
       subSharedRegexKill(preg);
     }
@@ -76,7 +76,7 @@ subViewFocus(SubView *v,
   vid = subArrayIndex(subtle->views, (void *)v);
 
   /* Check if view is visible on any screen */
-  if(subtle->visible_views & (1L << (vid + 1)))
+  if(subSharedBitsTest(&subtle->visible_views, vid + 1))
     {
       /* This only makes sense with more than one screen
        * otherwise just ignore that */
@@ -108,7 +108,7 @@ subViewFocus(SubView *v,
 
   /* Finally configure and render */
   subScreenConfigure();
-  subScreenRender();
+  subScreenDirty(NULL, SUB_SCREEN_RENDER);
   subScreenPublish();
 
   /* Update focus */
@@ -145,6 +145,8 @@ subViewKill(SubView *v)
   subHookCall((SUB_HOOK_TYPE_VIEW|SUB_HOOK_ACTION_KILL),
     (void *)v);
 
+  subPanelPurge(); ///< Pieces are keyed by view
+
   if(v->icon) free(v->icon);
   free(v->name);
   free(v);
@@ -161,13 +163,19 @@ subViewKill(SubView *v)
 void
 subViewPublish(void)
 {
-  int i;
-  long vid = 0, *tags = NULL, *icons = NULL;
+  int i, j, stride = 1;
+  long vid = 0, *tags = NULL, *icons = NULL, words[BITSWORDS];
   char **names = NULL;
 
   if(0 < subtle->views->ndata)
     {
-      tags  = (long *)subSharedMemoryAlloc(subtle->views->ndata, sizeof(long));
+      /* Use the same number of words for every view */
+      for(i = 0; i < subtle->views->ndata; i++)
+        stride = MAX(stride, subSharedBitsPack(
+          &VIEW(subtle->views->data[i])->tags, words));
+
+      tags  = (long *)subSharedMemoryAlloc(subtle->views->ndata * stride,
+        sizeof(long));
       icons = (long *)subSharedMemoryAlloc(subtle->views->ndata, sizeof(long));
       names = (char **)subSharedMemoryAlloc(subtle->views->ndata, sizeof(char *));
 
@@ -175,14 +183,16 @@ subViewPublish(void)
         {
           SubView *v = VIEW(subtle->views->data[i]);
 
-          tags[i]  = v->tags;
+          subSharedBitsPack(&v->tags, words);
+          for(j = 0; j < stride; j++) tags[i * stride + j] = words[j];
+
           icons[i] = v->icon ? v->icon->pixmap : -1;
           names[i] = v->name;
         }
 
       /* EWMH: Tags */
       subEwmhSetCardinals(ROOT, SUB_EWMH_SUBTLE_VIEW_TAGS,
-        tags, subtle->views->ndata);
+        tags, subtle->views->ndata * stride);
 
       /* EWMH: Icons */
       subEwmhSetCardinals(ROOT, SUB_EWMH_SUBTLE_VIEW_ICONS,
@@ -190,13 +200,13 @@ subViewPublish(void)
 
       /* EWMH: Desktops */
       subEwmhSetCardinals(ROOT, SUB_EWMH_NET_NUMBER_OF_DESKTOPS, (long *)&i, 1);
-      subSharedPropertySetStrings(subtle->dpy, ROOT,
-        subEwmhGet(SUB_EWMH_NET_DESKTOP_NAMES), names, subtle->views->ndata);
+      subEwmhSetStrings(ROOT, SUB_EWMH_NET_DESKTOP_NAMES, names,
+        subtle->views->ndata);
 
       /* EWMH: Current desktop */
       subEwmhSetCardinals(ROOT, SUB_EWMH_NET_CURRENT_DESKTOP, &vid, 1);
 
-      XSync(subtle->dpy, False); ///< Sync all changes
+      subtle->flags |= SUB_SUBTLE_PUBLISH; ///< Sync once per loop
 
       free(tags);
       free(icons);
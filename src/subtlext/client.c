@@ -115,8 +115,8 @@ ClientFlagsToggle(VALUE self,
   rb_iv_set(self, "@flags", INT2FIX(iflags));
 
   /* Send message */
-  data.l[0] = XInternAtom(display, "_NET_WM_STATE_TOGGLE", False);
-  data.l[1] = XInternAtom(display, type, False);
+  data.l[0] = subSharedAtomIntern(display, "_NET_WM_STATE_TOGGLE");
+  data.l[1] = subSharedAtomIntern(display, type);
 
   subSharedMessage(display, NUM2LONG(win), "_NET_WM_STATE", data, 32, True);
 
@@ -322,7 +322,7 @@ subextClientSingCurrent(VALUE self)
   /* Get current client */
   if((focus = (unsigned long *)subSharedPropertyGet(display,
       DefaultRootWindow(display), XA_WINDOW,
-      XInternAtom(display, "_NET_ACTIVE_WINDOW", False), NULL)))
+      subSharedAtomGet(SUB_EWMH_NET_ACTIVE_WINDOW), NULL)))
     {
       /* Update client values */
       if(RTEST(client = subextClientInstantiate(*focus)))
@@ -353,7 +353,7 @@ subextClientSingVisible(VALUE self)
 {
   int i, nclients = 0;
   Window *clients = NULL;
-  unsigned long *visible = NULL;
+  SubBits visible;
   VALUE meth = Qnil, klass = Qnil, array = Qnil, client = Qnil;
 
   subextSubtlextConnect(NULL); ///< Implicit open connection
@@ -363,33 +363,28 @@ subextClientSingVisible(VALUE self)
   array   = rb_ary_new();
   klass   = rb_const_get(mod, rb_intern("Client"));
   clients = subextSubtlextWindowList("_NET_CLIENT_LIST", &nclients);
-  visible = (unsigned long *)subSharedPropertyGet(display,
-    DefaultRootWindow(display), XA_CARDINAL, XInternAtom(display,
-    "SUBTLE_VISIBLE_TAGS", False), NULL);
 
   /* Check results */
-  if(clients && visible)
+  if(clients && subextSubtlextTagsGet(DefaultRootWindow(display),
+      SUB_EWMH_SUBTLE_VISIBLE_TAGS, &visible))
     {
       for(i = 0; i < nclients; i++)
         {
-          unsigned long *tags = (unsigned long *)subSharedPropertyGet(display,
-            clients[i], XA_CARDINAL, XInternAtom(display,
-            "SUBTLE_CLIENT_TAGS", False), NULL);
+          SubBits tags;
 
           /* Create client on match */
-          if(tags && *tags && *visible & *tags &&
+          if(subextSubtlextTagsGet(clients[i],
+              SUB_EWMH_SUBTLE_CLIENT_TAGS, &tags) &&
+              subSharedBitsAny(&visible, &tags) &&
               RTEST(client = rb_funcall(klass, meth, 1, LONG2NUM(clients[i]))))
             {
               subextClientUpdate(client);
               rb_ary_push(array, client);
             }
-
-          if(tags) free(tags);
         }
     }
 
   if(clients) free(clients);
-  if(visible) free(visible);
 
   return array;
 } /* }}} */
@@ -561,7 +556,9 @@ subextClientUpdate(VALUE self)
   /* Check values */
   if(0 <= (win = NUM2LONG(rb_iv_get(self, "@win"))))
     {
-      int *tags = NULL, *flags = NULL;
+      int *flags = NULL;
+      long *tags = NULL;
+      unsigned long ntags = 0;
       char *wmname = NULL, *wminstance = NULL, *wmclass = NULL, *role = NULL;
 
       /* Fetch name, instance and class */
@@ -569,15 +566,15 @@ subextClientUpdate(VALUE self)
       subSharedPropertyName(display, win, &wmname, wmclass);
 
       /* Fetch tags, flags and role */
-      tags  = (int *)subSharedPropertyGet(display, win, XA_CARDINAL,
-        XInternAtom(display, "SUBTLE_CLIENT_TAGS", False), NULL);
+      tags  = (long *)subSharedPropertyGet(display, win, XA_CARDINAL,
+        subSharedAtomGet(SUB_EWMH_SUBTLE_CLIENT_TAGS), &ntags);
       flags = (int *)subSharedPropertyGet(display, win, XA_CARDINAL,
-        XInternAtom(display, "SUBTLE_CLIENT_FLAGS", False), NULL);
+        subSharedAtomGet(SUB_EWMH_SUBTLE_CLIENT_FLAGS), NULL);
       role  = subSharedPropertyGet(display, win, XA_STRING,
-        XInternAtom(display, "WM_WINDOW_ROLE", False), NULL);
+        subSharedAtomGet(SUB_EWMH_WM_WINDOW_ROLE), NULL);
 
       /* Set properties */
-      rb_iv_set(self, "@tags",     tags  ? INT2FIX(*tags)  : INT2FIX(0));
+      rb_iv_set(self, "@tags",     subextSubtlextTagsToValue(tags, (int)ntags));
       rb_iv_set(self, "@flags",    flags ? INT2FIX(*flags) : INT2FIX(0));
       rb_iv_set(self, "@name",     rb_str_new2(wmname));
       rb_iv_set(self, "@instance", rb_str_new2(wminstance));
@@ -619,7 +616,8 @@ subextClientViewList(VALUE self)
   int i, nnames = 0;
   char **names = NULL;
   VALUE win = Qnil, array = Qnil, method = Qnil, klass = Qnil;
-  unsigned long *view_tags = NULL, *client_tags = NULL, *flags = NULL;
+  unsigned long *flags = NULL;
+  SubBits *view_tags = NULL, client_tags;
 
   /* Check ruby object */
   rb_check_frozen(self);
@@ -632,22 +630,19 @@ subextClientViewList(VALUE self)
   klass   = rb_const_get(mod, rb_intern("View"));
   array   = rb_ary_new();
   names   = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-    XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
-  view_tags   = (unsigned long *)subSharedPropertyGet(display,
-    DefaultRootWindow(display), XA_CARDINAL, XInternAtom(display,
-    "SUBTLE_VIEW_TAGS", False), NULL);
-  client_tags = (unsigned long *)subSharedPropertyGet(display, NUM2LONG(win),
-    XA_CARDINAL, XInternAtom(display, "SUBTLE_CLIENT_TAGS", False), NULL);
+    subSharedAtomGet(SUB_EWMH_NET_DESKTOP_NAMES), &nnames);
+  view_tags   = subextSubtlextViewTags(nnames);
   flags       = (unsigned long *)subSharedPropertyGet(display, NUM2LONG(win),
-    XA_CARDINAL, XInternAtom(display, "SUBTLE_CLIENT_FLAGS", False), NULL);
+    XA_CARDINAL, subSharedAtomGet(SUB_EWMH_SUBTLE_CLIENT_FLAGS), NULL);
 
   /* Check results */
-  if(names && view_tags && client_tags)
+  if(names && view_tags && subextSubtlextTagsGet(NUM2LONG(win),
+      SUB_EWMH_SUBTLE_CLIENT_TAGS, &client_tags))
     {
       for(i = 0; i < nnames; i++)
         {
           /* Check if there are common tags or window is stick */
-          if((view_tags[i] & *client_tags) ||
+          if(subSharedBitsAny(&view_tags[i], &client_tags) ||
               (flags && *flags & SUB_EWMH_STICK))
             {
               /* Create new view */
@@ -662,7 +657,6 @@ subextClientViewList(VALUE self)
 
   if(names)       XFreeStringList(names);
   if(view_tags)   free(view_tags);
-  if(client_tags) free(client_tags);
   if(flags)       free(flags);
 
   return array;
@@ -1091,7 +1085,7 @@ subextClientGravityReader(VALUE self)
 
       /* Get gravity */
       if((id = (int *)subSharedPropertyGet(display, NUM2LONG(win), XA_CARDINAL,
-          XInternAtom(display, "SUBTLE_CLIENT_GRAVITY", False), NULL)))
+          subSharedAtomGet(SUB_EWMH_SUBTLE_CLIENT_GRAVITY), NULL)))
         {
           /* Create gravity */
           snprintf(buf, sizeof(buf), "%d", *id);
@@ -1287,7 +1281,7 @@ subextClientScreenReader(VALUE self)
 
   /* Get screen */
   if((id = (int *)subSharedPropertyGet(display, NUM2LONG(win), XA_CARDINAL,
-      XInternAtom(display, "SUBTLE_CLIENT_SCREEN", False), NULL)))
+      subSharedAtomGet(SUB_EWMH_SUBTLE_CLIENT_SCREEN), NULL)))
     {
       screen = subextScreenSingFind(self, INT2FIX(*id));
 
@@ -1297,6 +1291,83 @@ subextClientScreenReader(VALUE self)
   return screen;
 } /* }}} */
 
+/* subextClientNeighbour {{{ */
+/*
+ * call-seq: neighbour(direction) -> Subtlext::Client or nil
+ *
+ * Get nearest visible Client in <i>direction</i>, which can be either
+ * <i>:up</i>, <i>:right</i>, <i>:down</i> or <i>:left</i>.
+ *
+ *  client.neighbour(:left)
+ *  => #<Subtlext::Client:xxx>
+ *
+ *  client.neighbour(:up)
+ *  => nil
+ */
+
+VALUE
+subextClientNeighbour(VALUE self,
+  VALUE value)
+{
+  int idx = -1;
+  Atom prop = None;
+  Window *neighbour = NULL;
+  SubMessageData data = { { 0, 0, 0, 0, 0 } };
+  VALUE client = Qnil, win = Qnil;
+
+  /* Check ruby object */
+  rb_check_frozen(self);
+  GET_ATTR(self, "@win", win);
+
+  /* Check value type */
+  if(T_SYMBOL == rb_type(value))
+    {
+      if(CHAR2SYM("up")         == value) idx = 0;
+      else if(CHAR2SYM("right") == value) idx = 1;
+      else if(CHAR2SYM("down")  == value) idx = 2;
+      else if(CHAR2SYM("left")  == value) idx = 3;
+    }
+
+  if(-1 == idx)
+    rb_raise(rb_eArgError, "Unexpected value-type `%s'",
+      rb_obj_classname(value));
+
+  subextSubtlextConnect(NULL); ///< Implicit open connection
+
+  /* Ask subtle directly when we run inside of it */
+  if(rb_respond_to(mod, rb_intern("__neighbour")))
+    {
+      VALUE found = rb_funcall(mod, rb_intern("__neighbour"), 2,
+        win, INT2FIX(idx));
+
+      if(!NIL_P(found) && RTEST(client = subextClientInstantiate(
+          NUM2LONG(found))))
+        subextClientUpdate(client);
+
+      return client;
+    }
+
+  prop = subSharedAtomGet(SUB_EWMH_SUBTLE_CLIENT_NEIGHBOURS);
+
+  /* Request neighbour and wait for subtle to answer */
+  data.l[0] = NUM2LONG(win);
+  data.l[1] = idx;
+
+  if(subextSubtlextRequest(NUM2LONG(win), prop,
+      "SUBTLE_CLIENT_NEIGHBOURS", data) &&
+      (neighbour = (Window *)subSharedPropertyGet(display, NUM2LONG(win),
+      XA_WINDOW, prop, NULL)))
+    {
+      if(None != *neighbour &&
+          RTEST(client = subextClientInstantiate(*neighbour)))
+        subextClientUpdate(client);
+
+      free(neighbour);
+    }
+
+  return client;
+} /* }}} */
+
 /* subextClientToString {{{ */
 /*
  * call-seq: to_str -> String
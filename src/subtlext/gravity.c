@@ -34,8 +34,8 @@ GravityFindId(char *match,
 
   /* Find gravity id */
   if((gravities = subSharedPropertyGetStrings(display,
-      DefaultRootWindow(display), XInternAtom(display,
-      "SUBTLE_GRAVITY_LIST", False), &ngravities)))
+      DefaultRootWindow(display),
+      subSharedAtomGet(SUB_EWMH_SUBTLE_GRAVITY_LIST), &ngravities)))
     {
       int i;
       XRectangle geom = { 0 };
@@ -312,7 +312,7 @@ subextGravitySave(VALUE self)
       char **gravities = NULL;
 
       gravities = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-        XInternAtom(display, "SUBTLE_GRAVITY_LIST", False), &ngravities);
+        subSharedAtomGet(SUB_EWMH_SUBTLE_GRAVITY_LIST), &ngravities);
 
       id = ngravities; ///< New id should be last
 
@@ -366,8 +366,8 @@ subextGravityClients(VALUE self)
 
           /* Get window gravity */
           gravity = (unsigned long *)subSharedPropertyGet(display,
-            clients[i], XA_CARDINAL, XInternAtom(display,
-            "SUBTLE_CLIENT_GRAVITY", False), NULL);
+            clients[i], XA_CARDINAL,
+            subSharedAtomGet(SUB_EWMH_SUBTLE_CLIENT_GRAVITY), NULL);
 
           /* Check if there are common tags or window is stick */
           if(gravity && FIX2INT(id) == *gravity &&
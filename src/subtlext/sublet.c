@@ -210,14 +210,20 @@ subextSubletSend(VALUE self,
       char *list = NULL;
       SubMessageData data = { { 0, 0, 0, 0, 0 } };
 
+      data.l[0] = FIX2INT(id);
+
+      /* Pass data along via socket if possible */
+      if(subSharedIpcSend(display, DefaultRootWindow(display),
+          subSharedAtomGet(SUB_EWMH_SUBTLE_SUBLET_DATA), data, 32,
+          RSTRING_PTR(value), RSTRING_LEN(value)))
+        return self;
+
       /* Store data */
       list = strdup(RSTRING_PTR(value));
       subSharedPropertySetStrings(display, DefaultRootWindow(display),
-        XInternAtom(display, "SUBTLE_DATA", False), &list, 1);
+        subSharedAtomGet(SUB_EWMH_SUBTLE_DATA), &list, 1);
       free(list);
 
-      data.l[0] = FIX2INT(id);
-
       subSharedMessage(display, DefaultRootWindow(display),
         "SUBTLE_SUBLET_DATA", data, 32, True);
     }
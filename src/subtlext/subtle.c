@@ -9,8 +9,83 @@
   * See the file COPYING for details.
   **/
 
+#include <unistd.h>
 #include "subtlext.h"
 
+/* Typedef {{{ */
+typedef struct subtlestats_t
+{
+  char          type[8], *name;
+  unsigned long calls, objects;
+  long long     total, max;
+} SubtleStats;
+/* }}} */
+
+static int sortby = 0;
+
+/* SubtleStatsCompare {{{ */
+static int
+SubtleStatsCompare(const void *a,
+  const void *b)
+{
+  const SubtleStats *s1 = (const SubtleStats *)a;
+  const SubtleStats *s2 = (const SubtleStats *)b;
+
+  /* Sort names ascending and numbers descending */
+  switch(sortby)
+    {
+      case 1: return (s2->calls   > s1->calls)   - (s2->calls   < s1->calls);
+      case 2: return (s2->max     > s1->max)     - (s2->max     < s1->max);
+      case 3: return (s2->objects > s1->objects) - (s2->objects < s1->objects);
+      case 4: return strcmp(s1->name, s2->name);
+    }
+
+  return (s2->total > s1->total) - (s2->total < s1->total);
+} /* }}} */
+
+/* SubtleStatsParse {{{ */
+static VALUE
+SubtleStatsParse(char **list,
+  int nlist)
+{
+  int i, j, len = 0;
+  SubtleStats *stats = NULL;
+  VALUE ret = rb_ary_new2(nlist);
+
+  stats = (SubtleStats *)subSharedMemoryAlloc(nlist, sizeof(SubtleStats));
+
+  /* Name comes last and takes the rest of the entry */
+  for(i = 0, j = 0; i < nlist; i++)
+    {
+      len = 0;
+
+      if(5 == sscanf(list[i], "%7[^#]#%lu#%lld#%lld#%lu#%n",
+          stats[j].type, &stats[j].calls, &stats[j].total,
+          &stats[j].max, &stats[j].objects, &len) && 0 < len)
+        stats[j++].name = list[i] + len;
+    }
+
+  qsort(stats, j, sizeof(SubtleStats), SubtleStatsCompare);
+
+  for(i = 0; i < j; i++)
+    {
+      VALUE hash = rb_hash_new();
+
+      rb_hash_aset(hash, CHAR2SYM("type"),    CHAR2SYM(stats[i].type));
+      rb_hash_aset(hash, CHAR2SYM("name"),    rb_str_new2(stats[i].name));
+      rb_hash_aset(hash, CHAR2SYM("calls"),   ULONG2NUM(stats[i].calls));
+      rb_hash_aset(hash, CHAR2SYM("total"),   LL2NUM(stats[i].total));
+      rb_hash_aset(hash, CHAR2SYM("max"),     LL2NUM(stats[i].max));
+      rb_hash_aset(hash, CHAR2SYM("objects"), ULONG2NUM(stats[i].objects));
+
+      rb_ary_push(ret, hash);
+    }
+
+  free(stats);
+
+  return ret;
+} /* }}} */
+
 /* SubtleSend {{{ */
 static VALUE
 SubtleSend(char *message)
@@ -25,6 +100,16 @@ SubtleSend(char *message)
   return Qnil;
 } /* }}} */
 
+/* SubtleBatchFlush {{{ */
+static VALUE
+SubtleBatchFlush(VALUE value)
+{
+  if(!subSharedIpcBatch(display, False))
+    rb_raise(rb_eStandardError, "Failed sending batch");
+
+  return Qnil;
+} /* }}} */
+
 /* Singleton */
 
 /* subextSubtleSingDisplayReader {{{ */
@@ -90,13 +175,13 @@ subextSubtleSingAskRunning(VALUE self)
 
   /* Get supporting window */
   if((support = (Window *)subSharedPropertyGet(display,
-      DefaultRootWindow(display), XA_WINDOW, XInternAtom(display,
-      "_NET_SUPPORTING_WM_CHECK", False), NULL)))
+      DefaultRootWindow(display), XA_WINDOW,
+      subSharedAtomGet(SUB_EWMH_NET_SUPPORTING_WM_CHECK), NULL)))
     {
       /* Get version property */
-      if((version = subSharedPropertyGet(display, *support, XInternAtom(display,
-          "UTF8_STRING", False), XInternAtom(display, "SUBTLE_VERSION", False),
-          NULL)))
+      if((version = subSharedPropertyGet(display, *support,
+          subSharedAtomGet(SUB_EWMH_UTF8),
+          subSharedAtomGet(SUB_EWMH_SUBTLE_VERSION), NULL)))
         {
           running = Qtrue;
 
@@ -136,7 +221,7 @@ subextSubtleSingSelect(VALUE self)
 
   root   = DefaultRootWindow(display);
   cursor = XCreateFontCursor(display, XC_cross);
-  type   = XInternAtom(display, "WM_STATE", True);
+  type   = subSharedAtomGet(SUB_EWMH_WM_STATE);
 
   /* Grab pointer */
   if(XGrabPointer(display, root, False, ButtonPressMask|ButtonReleaseMask,
@@ -308,7 +393,7 @@ subextSubtleSingColors(VALUE self)
   /* Check result */
   if((colors = (unsigned long *)subSharedPropertyGet(display,
       DefaultRootWindow(display), XA_CARDINAL,
-      XInternAtom(display, "SUBTLE_COLORS", False), &ncolors)))
+      subSharedAtomGet(SUB_EWMH_SUBTLE_COLORS), &ncolors)))
     {
       for(i = 0; i < ncolors && i < LENGTH(names); i++)
         {
@@ -343,8 +428,8 @@ subextSubtleSingFont(VALUE self)
 
   /* Get results */
   if((prop = subSharedPropertyGet(display, DefaultRootWindow(display),
-      XInternAtom(display, "UTF8_STRING", False),
-      XInternAtom(display, "SUBTLE_FONT", False),
+      subSharedAtomGet(SUB_EWMH_UTF8),
+      subSharedAtomGet(SUB_EWMH_SUBTLE_FONT),
       NULL)))
     {
       font = rb_str_new2(prop);
@@ -355,6 +440,112 @@ subextSubtleSingFont(VALUE self)
   return font;
 } /* }}} */
 
+/* subextSubtleSingStats {{{ */
+/*
+ * call-seq: stats(sort) -> Array
+ *
+ * Get call stats of sublets and hooks, sorted by either :total (default),
+ * :calls, :max, :objects or :name. Times are in microseconds. Entries of
+ * type :event hold counters of the event loop in :calls.
+ *
+ *  Subtlext::Subtle.stats
+ *  => [ { :type => :sublet, :name => "clock", :calls => 12,
+ *         :total => 3021, :max => 415, :objects => 840 } ]
+ */
+
+VALUE
+subextSubtleSingStats(int argc,
+  VALUE *argv,
+  VALUE self)
+{
+  int i, nlist = 0;
+  char **list = NULL;
+  Atom prop = None;
+  Window root = None;
+  SubMessageData data = { { 0, 0, 0, 0, 0 } };
+  VALUE value = Qnil, ret = Qnil;
+
+  rb_scan_args(argc, argv, "01", &value);
+
+  /* Check sort key */
+  if(T_SYMBOL == rb_type(value))
+    {
+      const char *keys[] = { "total", "calls", "max", "objects", "name" };
+
+      for(sortby = -1, i = 0; -1 == sortby && i < LENGTH(keys); i++)
+        if(CHAR2SYM(keys[i]) == value) sortby = i;
+
+      if(-1 == sortby)
+        rb_raise(rb_eArgError, "Unknown sort key `%s'", SYM2CHAR(value));
+    }
+  else if(NIL_P(value)) sortby = 0;
+  else rb_raise(rb_eArgError, "Unexpected value-type `%s'",
+    rb_obj_classname(value));
+
+  /* Ask subtle directly when we run inside of it */
+  if(rb_respond_to(mod, rb_intern("__stats")))
+    {
+      VALUE entries = rb_funcall(mod, rb_intern("__stats"), 0, NULL);
+
+      nlist = RARRAY_LEN(entries);
+      list  = (char **)subSharedMemoryAlloc(nlist + 1, sizeof(char *));
+
+      for(i = 0; i < nlist; i++)
+        list[i] = RSTRING_PTR(rb_ary_entry(entries, i));
+
+      ret = SubtleStatsParse(list, nlist);
+
+      free(list);
+
+      return ret;
+    }
+
+  subextSubtlextConnect(NULL); ///< Implicit open connection
+
+  root = DefaultRootWindow(display);
+  prop = subSharedAtomGet(SUB_EWMH_SUBTLE_STATS);
+
+  /* Request stats and wait for subtle to publish them */
+  subextSubtlextRequest(root, prop, "SUBTLE_STATS", data);
+
+  /* Parse and sort stats */
+  if((list = subSharedPropertyGetStrings(display, root, prop, &nlist)))
+    {
+      ret = SubtleStatsParse(list, nlist);
+
+      XFreeStringList(list);
+    }
+  else ret = rb_ary_new();
+
+  return ret;
+} /* }}} */
+
+/* subextSubtleSingBatch {{{ */
+/*
+ * call-seq: batch { } -> Object
+ *
+ * Collect all messages sent to Subtle inside of the block and send
+ * them at once when the block ends. Messages that cannot use the socket
+ * of Subtle are sent immediately.
+ *
+ *  subtle.batch do
+ *    sublet.send_data("subtle")
+ *    subtle.render
+ *  end
+ *  => nil
+ */
+
+VALUE
+subextSubtleSingBatch(VALUE self)
+{
+  rb_need_block();
+
+  subextSubtlextConnect(NULL); ///< Implicit open connection
+  subSharedIpcBatch(display, True);
+
+  return rb_ensure(rb_yield, Qnil, SubtleBatchFlush, Qnil);
+} /* }}} */
+
 /* subextSubtleSingSpawn {{{ */
 /*
  * call-seq: spawn(cmd) -> Subtlext::Client
@@ -13,6 +13,8 @@
 #include <unistd.h>
 #include <locale.h>
 #include <ctype.h>
+#include <poll.h>
+#include <sys/time.h>
 #include "subtlext.h"
 
 #ifdef HAVE_X11_EXTENSIONS_XTEST_H
@@ -43,14 +45,44 @@ SubtlextStringify(char *string)
 static void
 SubtlextSweep(void)
 {
+  subSharedIpcClose();
+
   if(display)
     {
+      subSharedAtomKill();
       XCloseDisplay(display);
 
       display = NULL;
     }
 } /* }}} */
 
+/* SubtlextFork {{{ */
+static VALUE
+SubtlextFork(VALUE self)
+{
+  /* Drop connections of parent and reconnect on demand */
+  subSharedIpcClose();
+
+  if(display)
+    {
+      close(ConnectionNumber(display));
+
+      display = NULL;
+    }
+
+  return Qnil;
+} /* }}} */
+
+/* SubtlextLocal {{{ */
+static VALUE
+SubtlextLocal(VALUE self)
+{
+  /* Send messages of subtle itself via X only */
+  subSharedIpcDisable();
+
+  return Qnil;
+} /* }}} */
+
 /* SubtlextPidReader {{{ */
 /*
  * call-seq: pid => Fixnum
@@ -78,7 +110,7 @@ SubtlextPidReader(VALUE self)
 
       /* Get pid */
       if((id = (int *)subSharedPropertyGet(display, win, XA_CARDINAL,
-          XInternAtom(display, "_NET_WM_PID", False), NULL)))
+          subSharedAtomGet(SUB_EWMH_NET_WM_PID), NULL)))
         {
           pid = INT2FIX(*id);
 
@@ -212,11 +244,10 @@ SubtlextXError(Display *disp,
 /* Tags */
 
 /* SubtlextTagFind {{{ */
-static int
-SubtlextTagFind(VALUE value)
+static void
+SubtlextTagFind(VALUE value,
+  SubBits *tags)
 {
-  int tags = 0;
-
   /* Check object type */
   switch(rb_type(value))
     {
@@ -237,7 +268,7 @@ SubtlextTagFind(VALUE value)
             /* Find tag and get id */
             if(-1 != (id = subextSubtlextFindString("SUBTLE_TAG_LIST",
                 string, NULL, flags)))
-              tags |= (1L << (id + 1));
+              subSharedBitsSet(tags, id + 1);
           }
         break;
       case T_OBJECT:
@@ -247,7 +278,7 @@ SubtlextTagFind(VALUE value)
             VALUE id = Qnil;
 
             if(FIXNUM_P((id = rb_iv_get(value, "@id"))))
-              tags |= (1L << (FIX2INT(id) + 1));
+              subSharedBitsSet(tags, FIX2INT(id) + 1);
           }
         break;
       case T_ARRAY:
@@ -258,15 +289,13 @@ SubtlextTagFind(VALUE value)
             /* Collect tags and raise if a tag wasn't found. Empty
              * arrays reset tags and never enter this loop */
             for(i = 0; Qnil != (entry = rb_ary_entry(value, i)); ++i)
-              tags |= SubtlextTagFind(entry);
+              SubtlextTagFind(entry, tags);
           }
         break;
       default:
         rb_raise(rb_eArgError, "Unexpected value-type `%s'",
           rb_obj_classname(value));
     }
-
-  return tags;
 } /* }}} */
 
 /* SubtlextTag {{{ */
@@ -275,22 +304,37 @@ SubtlextTag(VALUE self,
   VALUE value,
   int action)
 {
+  int nwords = 0;
+  long words[BITSWORDS] = { 0 };
+  char *type = NULL;
+  SubBits tags;
   SubMessageData data = { { 0, 0, 0, 0, 0 } };
 
   /* Check ruby object */
   rb_check_frozen(self);
 
   /* Convert tags to bitmask */
-  data.l[1] |= SubtlextTagFind(value);
+  subSharedBitsClear(&tags);
+  SubtlextTagFind(value, &tags);
 
   /* Get and update tag mask */
   if(0 != action)
     {
-      int tags = FIX2INT(rb_iv_get(self, "@tags"));
+      SubBits current;
+
+      subextSubtlextValueToTags(rb_iv_get(self, "@tags"), &current);
 
       /* Update masks */
-     if(1 == action)       data.l[1] = tags |  data.l[1];
-     else if(-1 == action) data.l[1] = tags & ~data.l[1];
+      if(1 == action)
+        {
+          subSharedBitsOr(&current, &tags);
+          tags = current;
+        }
+      else if(-1 == action)
+        {
+          subSharedBitsAndNot(&current, &tags);
+          tags = current;
+        }
     }
 
   /* Send message based on object type */
@@ -300,8 +344,7 @@ SubtlextTag(VALUE self,
 
       GET_ATTR(self, "@win", win);
       data.l[0] = NUM2LONG(win);
-
-      subSharedMessage(display, ROOT, "SUBTLE_CLIENT_TAGS", data, 32, True);
+      type      = "SUBTLE_CLIENT_TAGS";
     }
   else
     {
@@ -309,10 +352,14 @@ SubtlextTag(VALUE self,
 
       GET_ATTR(self, "@id", id);
       data.l[0] = FIX2LONG(id);
-
-      subSharedMessage(display, ROOT, "SUBTLE_VIEW_TAGS", data, 32, True);
+      type      = "SUBTLE_VIEW_TAGS";
     }
 
+  /* Send all words at once */
+  nwords = subSharedBitsPack(&tags, words);
+
+  subSharedTagsSend(display, type, data, words, nwords);
+
   return Qnil;
 } /* }}} */
 
@@ -352,7 +399,8 @@ static VALUE
 SubtlextTagReader(VALUE self)
 {
   char **tags = NULL;
-  int i, ntags = 0, value_tags = 0;
+  int i, ntags = 0;
+  SubBits value_tags;
   VALUE method = Qnil, klass = Qnil, t = Qnil;
   VALUE array = rb_ary_new();
 
@@ -362,15 +410,15 @@ SubtlextTagReader(VALUE self)
   /* Fetch data */
   method     = rb_intern("new");
   klass      = rb_const_get(mod, rb_intern("Tag"));
-  value_tags = FIX2INT(rb_iv_get(self, "@tags"));
+  subextSubtlextValueToTags(rb_iv_get(self, "@tags"), &value_tags);
 
   /* Check results */
   if((tags = subSharedPropertyGetStrings(display, ROOT,
-      XInternAtom(display, "SUBTLE_TAG_LIST", False), &ntags)))
+      subSharedAtomGet(SUB_EWMH_SUBTLE_TAG_LIST), &ntags)))
     {
       for(i = 0; i < ntags; i++)
         {
-          if(value_tags & (1L << (i + 1)))
+          if(subSharedBitsTest(&value_tags, i + 1))
             {
               /* Create new tag */
               t = rb_funcall(klass, method, 1, rb_str_new2(tags[i]));
@@ -456,13 +504,14 @@ SubtlextTagAsk(VALUE self,
   /* Find tag */
   if(RTEST(tag = subextTagSingFirst(Qnil, sym)))
     {
-      VALUE id = Qnil, tags = Qnil;
+      VALUE id = Qnil;
+      SubBits tags;
 
       /* Get properties */
-      id   = rb_iv_get(tag,  "@id");
-      tags = rb_iv_get(self, "@tags");
+      id = rb_iv_get(tag,  "@id");
+      subextSubtlextValueToTags(rb_iv_get(self, "@tags"), &tags);
 
-      if(FIX2INT(tags) & (1L << (FIX2INT(id) + 1))) ret = Qtrue;
+      if(subSharedBitsTest(&tags, FIX2INT(id) + 1)) ret = Qtrue;
     }
 
   return ret;
@@ -760,7 +809,7 @@ SubtlextAskFocus(VALUE self)
 
   /* Fetch data */
   if((focus = (unsigned long *)subSharedPropertyGet(display, ROOT,
-      XA_WINDOW, XInternAtom(display, "_NET_ACTIVE_WINDOW", False), NULL)))
+      XA_WINDOW, subSharedAtomGet(SUB_EWMH_NET_ACTIVE_WINDOW), NULL)))
     {
       if(*focus == NUM2LONG(win)) ret = Qtrue;
 
@@ -833,8 +882,9 @@ SubtlextPropReader(VALUE self,
         }
 
       /* Get actual property */
-      if((result = subSharedPropertyGet(display, win, XInternAtom(display,
-          "UTF8_STRING", False), XInternAtom(display, propname, False), NULL)))
+      if((result = subSharedPropertyGet(display, win,
+          subSharedAtomGet(SUB_EWMH_UTF8),
+          subSharedAtomIntern(display, propname), NULL)))
         {
           ret = rb_str_new2(result);
 
@@ -913,12 +963,12 @@ SubtlextPropWriter(VALUE self,
     {
       case T_SYMBOL: str = rb_sym_to_s(value);
       case T_STRING:
-        XChangeProperty(display, win, XInternAtom(display, propname, False),
-          XInternAtom(display, "UTF8_STRING", False), 8, PropModeReplace,
+        XChangeProperty(display, win, subSharedAtomIntern(display, propname),
+          subSharedAtomGet(SUB_EWMH_UTF8), 8, PropModeReplace,
           (unsigned char *)RSTRING_PTR(str), RSTRING_LEN(str));
         break;
       case T_NIL:
-        XDeleteProperty(display, win, XInternAtom(display, propname, False));
+        XDeleteProperty(display, win, subSharedAtomIntern(display, propname));
         break;
       default:
         rb_raise(rb_eArgError, "Unexpected value value-type `%s'",
@@ -1174,7 +1224,7 @@ SubtlextWindowMatch(Window win,
       char *role = NULL;
 
       if((role = subSharedPropertyGet(display, win, XA_STRING,
-          XInternAtom(display, "WM_WINDOW_ROLE", False), NULL)))
+          subSharedAtomGet(SUB_EWMH_WM_WINDOW_ROLE), NULL)))
         {
           ret = (flags & SUB_MATCH_EXACT ? 0 == strcmp(source, role) :
             subSharedRegexMatch(preg, role));
@@ -1191,11 +1241,9 @@ SubtlextWindowMatch(Window win,
 
       /* Fetch gravities */
       gravities = subSharedPropertyGetStrings(display,
-        ROOT, XInternAtom(display, "SUBTLE_GRAVITY_LIST",
-        False), &ngravities);
+        ROOT, subSharedAtomGet(SUB_EWMH_SUBTLE_GRAVITY_LIST), &ngravities);
       gravity = (int *)subSharedPropertyGet(display, win,
-        XA_CARDINAL, XInternAtom(display, "SUBTLE_CLIENT_GRAVITY",
-        False), NULL);
+        XA_CARDINAL, subSharedAtomGet(SUB_EWMH_SUBTLE_CLIENT_GRAVITY), NULL);
 
       /* Finally compare gravities */
       if(gravities && gravity && 0 <= *gravity && *gravity < ngravities)
@@ -1216,7 +1264,7 @@ SubtlextWindowMatch(Window win,
 
       /* Fetch pid from window */
       if((pid = (int *)subSharedPropertyGet(display, win, XA_CARDINAL,
-          XInternAtom(display, "_NET_WM_PID", False), NULL)))
+          subSharedAtomGet(SUB_EWMH_NET_WM_PID), NULL)))
         {
           char pidbuf[10] = { 0 };
 
@@ -1261,6 +1309,9 @@ subextSubtlextConnect(char *display_string)
 
       XSetErrorHandler(SubtlextXError);
 
+      /* Intern atoms in one request */
+      subSharedAtomInit(display, DefaultScreen(display));
+
       if(!setlocale(LC_CTYPE, "")) XSupportsLocale();
 
       /* Register sweeper */
@@ -1268,7 +1319,188 @@ subextSubtlextConnect(char *display_string)
     }
 } /* }}} */
 
-  /** subextSubtlextBacktrace {{{
+ /** subextSubtlextRequest {{{
+  * @brief Send message and wait for subtle to set the requested property
+  * @param[in]  win   Property window
+  * @param[in]  prop  Property
+  * @param[in]  type  Message type
+  * @param[in]  data  Message data
+  * @retval  True   Property was set
+  * @retval  False  Timeout
+  **/
+
+int
+subextSubtlextRequest(Window win,
+  Atom prop,
+  char *type,
+  SubMessageData data)
+{
+  int ret = False, timeout = 1000;
+  struct pollfd pfd;
+  struct timeval start, now;
+  XWindowAttributes attrs;
+  XEvent ev;
+
+  /* Select property changes and keep previous mask */
+  XGetWindowAttributes(display, win, &attrs);
+  XSelectInput(display, win, attrs.your_event_mask|PropertyChangeMask);
+  XDeleteProperty(display, win, prop);
+
+  subSharedMessage(display, DefaultRootWindow(display), type, data, 32, True);
+  XSync(display, False);
+
+  pfd.fd     = ConnectionNumber(display);
+  pfd.events = POLLIN;
+
+  gettimeofday(&start, NULL);
+
+  /* Wait for notify instead of polling the property */
+  while(!ret)
+    {
+      while(!ret && XCheckWindowEvent(display, win, PropertyChangeMask, &ev))
+        if(prop == ev.xproperty.atom &&
+            PropertyNewValue == ev.xproperty.state)
+          ret = True;
+
+      if(ret) break;
+
+      gettimeofday(&now, NULL);
+      timeout = 1000 - ((now.tv_sec - start.tv_sec) * 1000 +
+        (now.tv_usec - start.tv_usec) / 1000);
+
+      if(0 >= timeout || 0 >= poll(&pfd, 1, timeout)) break;
+    }
+
+  XSelectInput(display, win, attrs.your_event_mask);
+
+  return ret;
+} /* }}} */
+
+  /** subextSubtlextTagsToValue {{{
+  * @brief Convert tag cardinals to integer
+  * @param[in]  cardinals  Cardinal list
+  * @param[in]  n          Number of cardinals
+  * @return Returns an integer of any width
+  **/
+
+VALUE
+subextSubtlextTagsToValue(long *cardinals,
+  int n)
+{
+  int i;
+  SubBits tags;
+  VALUE value = INT2FIX(0);
+
+  subSharedBitsUnpack(&tags, cardinals, n);
+
+  /* Find highest used word */
+  for(i = BITSWORDS - 1; 0 < i && 0 == tags.words[i]; i--);
+
+  /* Integers grow as needed */
+  for(; 0 <= i; i--)
+    {
+      value = rb_funcall(value, rb_intern("<<"), 1, INT2FIX(32));
+      value = rb_funcall(value, rb_intern("|"), 1, UINT2NUM(tags.words[i]));
+    }
+
+  return value;
+} /* }}} */
+
+ /** subextSubtlextTagsGet {{{
+  * @brief Get tag bits property of window
+  * @param[in]   win   Window
+  * @param[in]   e     A #SubEwmh
+  * @param[out]  tags  A #SubBits
+  * @retval  True   Property found
+  * @retval  False  Property not found
+  **/
+
+int
+subextSubtlextTagsGet(Window win,
+  SubEwmh e,
+  SubBits *tags)
+{
+  long *cardinals = NULL;
+  unsigned long size = 0;
+
+  subSharedBitsClear(tags);
+
+  /* Tags are stored in one cardinal per word */
+  if((cardinals = (long *)subSharedPropertyGet(display, win, XA_CARDINAL,
+      subSharedAtomGet(e), &size)))
+    {
+      subSharedBitsUnpack(tags, cardinals, (int)size);
+
+      free(cardinals);
+
+      return True;
+    }
+
+  return False;
+} /* }}} */
+
+ /** subextSubtlextViewTags {{{
+  * @brief Get tag bits of all views
+  * @param[in]  nviews  Number of views
+  * @return Returns a list of #SubBits or \p NULL
+  **/
+
+SubBits *
+subextSubtlextViewTags(int nviews)
+{
+  long *cardinals = NULL;
+  unsigned long size = 0;
+  SubBits *tags = NULL;
+
+  /* Views share the same number of words */
+  if(0 < nviews && (cardinals = (long *)subSharedPropertyGet(display,
+      DefaultRootWindow(display), XA_CARDINAL,
+      subSharedAtomGet(SUB_EWMH_SUBTLE_VIEW_TAGS), &size)))
+    {
+      int i, stride = (int)size / nviews;
+
+      if(1 > stride) stride = 1;
+
+      tags = (SubBits *)subSharedMemoryAlloc(nviews, sizeof(SubBits));
+
+      for(i = 0; i < nviews && (i + 1) * stride <= (int)size; i++)
+        subSharedBitsUnpack(&tags[i], cardinals + i * stride, stride);
+
+      free(cardinals);
+    }
+
+  return tags;
+} /* }}} */
+
+ /** subextSubtlextValueToTags {{{
+  * @brief Convert integer to tag bits
+  * @param[in]   value  Integer value
+  * @param[out]  tags   A #SubBits
+  **/
+
+void
+subextSubtlextValueToTags(VALUE value,
+  SubBits *tags)
+{
+  int i;
+
+  subSharedBitsClear(tags);
+
+  /* Higher bits than capacity are dropped */
+  if(FIXNUM_P(value) || T_BIGNUM == rb_type(value))
+    {
+      VALUE mask = UINT2NUM(0xffffffff);
+
+      for(i = 0; i < BITSWORDS && INT2FIX(0) != value; i++)
+        {
+          tags->words[i] = NUM2UINT(rb_funcall(value, rb_intern("&"),
+            1, mask));
+          value = rb_funcall(value, rb_intern(">>"), 1, INT2FIX(32));
+        }
+    }
+} /* }}} */
+
+ /** subextSubtlextBacktrace {{{
    * @brief Print ruby backtrace
    **/
 
@@ -1465,7 +1697,7 @@ subextSubtlextWindowList(char *prop_name,
 
   /* Get property list */
   if((wins = (Window *)subSharedPropertyGet(display, ROOT,
-      XA_WINDOW, XInternAtom(display, prop_name, False), &len)))
+      XA_WINDOW, subSharedAtomIntern(display, prop_name), &len)))
     {
       if(size) *size = len;
     }
@@ -1499,7 +1731,7 @@ subextSubtlextFindString(char *prop_name,
   /* Fetch data */
   preg    = subSharedRegexNew(source);
   strings = subSharedPropertyGetStrings(display, ROOT,
-    XInternAtom(display, prop_name, False), &size);
+    subSharedAtomIntern(display, prop_name), &size);
 
   /* Check results */
   if(preg && strings)
@@ -1557,7 +1789,7 @@ subextSubtlextFindObjects(char *prop_name,
 
   /* Check results */
   if((strings = subSharedPropertyGetStrings(display, ROOT,
-      XInternAtom(display, prop_name, False), &nstrings)))
+      subSharedAtomIntern(display, prop_name), &nstrings)))
     {
       int selid = -1;
       VALUE meth_new = Qnil, meth_update = Qnil, klass = Qnil, obj = Qnil;
@@ -1712,7 +1944,7 @@ subextSubtlextFindObjectsGeometry(char *prop_name,
 
   /* Get string list */
   if((strings = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-      XInternAtom(display, prop_name, False), &nstrings)))
+      subSharedAtomIntern(display, prop_name), &nstrings)))
     {
       int i, selid = -1;
       XRectangle geometry = { 0 };
@@ -1794,6 +2026,12 @@ Init_subtlext(void)
 
   mod = rb_define_module("Subtlext");
 
+  /* Called by subtle in its forked sublet host */
+  rb_define_singleton_method(mod, "__fork", SubtlextFork, 0);
+
+  /* Called by subtle when loaded into its own interpreter */
+  rb_define_singleton_method(mod, "__local", SubtlextLocal, 0);
+
   /* Subtlext version */
   rb_define_const(mod, "VERSION", rb_str_new2(PKG_VERSION));
 
@@ -1879,6 +2117,7 @@ Init_subtlext(void)
   rb_define_method(client, "geometry",          subextClientGeometryReader,        0);
   rb_define_method(client, "geometry=",         subextClientGeometryWriter,       -1);
   rb_define_method(client, "screen",            subextClientScreenReader,          0);
+  rb_define_method(client, "neighbour",         subextClientNeighbour,             1);
   rb_define_method(client, "pid",               SubtlextPidReader,                0);
   rb_define_method(client, "alive?",            subextClientAskAlive,              0);
   rb_define_method(client, "kill",              subextClientKill,                  0);
@@ -2119,6 +2358,8 @@ Init_subtlext(void)
   rb_define_singleton_method(subtle, "quit",          subextSubtleSingQuit,          0);
   rb_define_singleton_method(subtle, "colors",        subextSubtleSingColors,        0);
   rb_define_singleton_method(subtle, "font",          subextSubtleSingFont,          0);
+  rb_define_singleton_method(subtle, "stats",         subextSubtleSingStats,        -1);
+  rb_define_singleton_method(subtle, "batch",         subextSubtleSingBatch,         0);
   rb_define_singleton_method(subtle, "spawn",         subextSubtleSingSpawn,         1);
 
   /* Aliases */
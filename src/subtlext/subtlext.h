@@ -88,6 +88,7 @@ VALUE subextClientGeometryReader(VALUE self);                        ///< Get cl
 VALUE subextClientGeometryWriter(int argc, VALUE *argv,
   VALUE self);                                                    ///< Set client geometry
 VALUE subextClientScreenReader(VALUE self);                          ///< Get client screen
+VALUE subextClientNeighbour(VALUE self, VALUE value);                ///< Get client in direction
 VALUE subextClientResizeWriter(VALUE self, VALUE value);             ///< Set Client resize
 VALUE subextClientToString(VALUE self);                              ///< Client to string
 VALUE subextClientKill(VALUE self);                                  ///< Kill client
@@ -201,12 +202,21 @@ VALUE subextSubtleSingRestart(VALUE self);                           ///< Restar
 VALUE subextSubtleSingQuit(VALUE self);                              ///< Quit subtle
 VALUE subextSubtleSingColors(VALUE self);                            ///< Get colors
 VALUE subextSubtleSingFont(VALUE self);                              ///< Get font
+VALUE subextSubtleSingStats(int argc, VALUE *argv, VALUE self);      ///< Get call stats
+VALUE subextSubtleSingBatch(VALUE self);                             ///< Batch messages
 VALUE subextSubtleSingSpawn(VALUE self, VALUE cmd);                  ///< Spawn command
 /* }}} */
 
 /* subtlext.c {{{ */
 void subextSubtlextConnect(char *display_string);                    ///< Connect to display
+int subextSubtlextRequest(Window win, Atom prop, char *type,
+  SubMessageData data);                                              ///< Request property
 void subextSubtlextBacktrace(void);                                  ///< Print ruby backtrace
+VALUE subextSubtlextTagsToValue(long *cardinals, int n);            ///< Convert tags to integer
+void subextSubtlextValueToTags(VALUE value, SubBits *tags);         ///< Convert integer to tags
+int subextSubtlextTagsGet(Window win, SubEwmh e,
+  SubBits *tags);                                                 ///< Get tags of window
+SubBits *subextSubtlextViewTags(int nviews);                        ///< Get tags of views
 VALUE subextSubtlextConcat(VALUE str1, VALUE str2);                  ///< Concat strings
 VALUE subextSubtlextParse(VALUE value, char *buf,
   int len, int *flags);                                           ///< Parse arguments
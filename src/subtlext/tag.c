@@ -122,7 +122,7 @@ subextTagSingVisible(VALUE self)
 {
   int i, ntags = 0;
   char **tags = NULL;
-  unsigned long *visible = NULL;
+  SubBits visible;
   VALUE meth = Qnil, klass = Qnil, array = Qnil, t = Qnil;
 
   subextSubtlextConnect(NULL); ///< Implicit open connection
@@ -132,18 +132,16 @@ subextTagSingVisible(VALUE self)
   klass   = rb_const_get(mod, rb_intern("Tag"));
   array   = rb_ary_new();
   tags    = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-    XInternAtom(display, "SUBTLE_TAG_LIST", False), &ntags);
-  visible = (unsigned long *)subSharedPropertyGet(display,
-    DefaultRootWindow(display), XA_CARDINAL, XInternAtom(display,
-    "SUBTLE_VISIBLE_TAGS", False), NULL);
+    subSharedAtomGet(SUB_EWMH_SUBTLE_TAG_LIST), &ntags);
 
   /* Populate array */
-  if(tags && visible)
+  if(tags && subextSubtlextTagsGet(DefaultRootWindow(display),
+      SUB_EWMH_SUBTLE_VISIBLE_TAGS, &visible))
     {
       for(i = 0; i < ntags; i++)
         {
           /* Create tag on match */
-          if(*visible & (1L << (i + 1)) &&
+          if(subSharedBitsTest(&visible, i + 1) &&
               !NIL_P(t = rb_funcall(klass, meth, 1, rb_str_new2(tags[i]))))
             {
               rb_iv_set(t, "@id", INT2FIX(i));
@@ -153,8 +151,7 @@ subextTagSingVisible(VALUE self)
 
     }
 
-  if(tags)    XFreeStringList(tags);
-  if(visible) free(visible);
+  if(tags) XFreeStringList(tags);
 
   return array;
 } /* }}} */
@@ -189,7 +186,7 @@ subextTagSingList(VALUE self)
 
   /* Check results */
   if((tags = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-      XInternAtom(display, "SUBTLE_TAG_LIST", False), &ntags)))
+      subSharedAtomGet(SUB_EWMH_SUBTLE_TAG_LIST), &ntags)))
     {
       for(i = 0; i < ntags; i++)
         {
@@ -295,7 +292,7 @@ subextTagSave(VALUE self)
 
       /* Get names of tags */
       if((tags = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-          XInternAtom(display, "SUBTLE_TAG_LIST", False), &ntags)))
+          subSharedAtomGet(SUB_EWMH_SUBTLE_TAG_LIST), &ntags)))
         {
 
           id = ntags; ///< New id should be last
@@ -328,7 +325,7 @@ subextTagClients(VALUE self)
 {
   int i, nclients = 0;
   Window *clients = NULL;
-  unsigned long *tags = NULL;
+  SubBits tags;
   VALUE id = Qnil, array = Qnil, klass = Qnil, meth = Qnil, c = Qnil;
 
   /* Check ruby object */
@@ -346,12 +343,11 @@ subextTagClients(VALUE self)
     {
       for(i = 0; i < nclients; i++)
         {
-          if((tags = (unsigned long *)subSharedPropertyGet(display,
-              clients[i], XA_CARDINAL, XInternAtom(display,
-              "SUBTLE_CLIENT_TAGS", False), NULL)))
+          if(subextSubtlextTagsGet(clients[i],
+              SUB_EWMH_SUBTLE_CLIENT_TAGS, &tags))
             {
               /* Check if tag id matches */
-              if(*tags & (1L << (FIX2INT(id) + 1)))
+              if(subSharedBitsTest(&tags, FIX2INT(id) + 1))
                 {
                   /* Create new client */
                   if(!NIL_P(c = rb_funcall(klass, meth, 1,
@@ -389,7 +385,7 @@ subextTagViews(VALUE self)
 {
   int i, nnames = 0;
   char **names = NULL;
-  unsigned long *tags = NULL;
+  SubBits *tags = NULL;
   VALUE id = Qnil, array = Qnil, klass = Qnil, meth = Qnil, v = Qnil;
 
   /* Check ruby object */
@@ -403,10 +399,8 @@ subextTagViews(VALUE self)
   meth   = rb_intern("new");
   array  = rb_ary_new();
   names  = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-    XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
-  tags   = (unsigned long *)subSharedPropertyGet(display,
-    DefaultRootWindow(display), XA_CARDINAL,
-    XInternAtom(display, "SUBTLE_VIEW_TAGS", False), NULL);
+    subSharedAtomGet(SUB_EWMH_NET_DESKTOP_NAMES), &nnames);
+  tags   = subextSubtlextViewTags(nnames);
 
   /* Check results */
   if(names && tags)
@@ -414,7 +408,7 @@ subextTagViews(VALUE self)
       for(i = 0; i < nnames; i++)
         {
           /* Check if tag id matches */
-          if(tags[i] & (1L << (FIX2INT(id) + 1)))
+          if(subSharedBitsTest(&tags[i], FIX2INT(id) + 1))
             {
               /* Create new view */
               if(!NIL_P(v = rb_funcall(klass, meth, 1, rb_str_new2(names[i]))))
@@ -28,7 +28,7 @@ ViewSelect(VALUE self,
 
   /* Fetch data */
   if((names = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-    XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames)))
+    subSharedAtomGet(SUB_EWMH_NET_DESKTOP_NAMES), &nnames)))
     {
       int vid = FIX2INT(id);
 
@@ -170,10 +170,10 @@ subextViewSingCurrent(VALUE self)
 
   /* Fetch data */
   names    = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-    XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
+    subSharedAtomGet(SUB_EWMH_NET_DESKTOP_NAMES), &nnames);
   cur_view = (unsigned long *)subSharedPropertyGet(display,
     DefaultRootWindow(display), XA_CARDINAL,
-    XInternAtom(display, "_NET_CURRENT_DESKTOP", False), NULL);
+    subSharedAtomGet(SUB_EWMH_NET_CURRENT_DESKTOP), NULL);
 
   /* Check results */
   if(names && cur_view)
@@ -205,9 +205,9 @@ subextViewSingCurrent(VALUE self)
 VALUE
 subextViewSingVisible(VALUE self)
 {
-  int i, nnames = 0, *tags = NULL;
+  int i, nnames = 0;
   char **names = NULL;
-  unsigned long *visible = NULL;
+  SubBits visible, *tags = NULL;
   VALUE meth = Qnil, klass = Qnil, array = Qnil, v = Qnil;
 
   subextSubtlextConnect(NULL); ///< Implicit open connection
@@ -217,33 +217,32 @@ subextViewSingVisible(VALUE self)
   klass = rb_const_get(mod, rb_intern("View"));
   array = rb_ary_new();
   names = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-    XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
-  visible = (unsigned long *)subSharedPropertyGet(display,
-    DefaultRootWindow(display), XA_CARDINAL, XInternAtom(display,
-    "SUBTLE_VISIBLE_VIEWS", False), NULL);
-  tags  = (int *)subSharedPropertyGet(display, ROOT, XA_CARDINAL,
-      XInternAtom(display, "SUBTLE_VIEW_TAGS", False), NULL);
+    subSharedAtomGet(SUB_EWMH_NET_DESKTOP_NAMES), &nnames);
 
   /* Check results */
-  if(names && visible && tags)
+  if(names && subextSubtlextTagsGet(DefaultRootWindow(display),
+      SUB_EWMH_SUBTLE_VISIBLE_VIEWS, &visible) &&
+      (tags = subextSubtlextViewTags(nnames)))
     {
       for(i = 0; i < nnames; i++)
         {
           /* Create view on match */
-          if(*visible & (1L << (i + 1)) &&
+          if(subSharedBitsTest(&visible, i + 1) &&
               !NIL_P(v = rb_funcall(klass, meth, 1, rb_str_new2(names[i]))))
             {
+              long words[BITSWORDS];
+
               rb_iv_set(v, "@id",   INT2FIX(i));
-              rb_iv_set(v, "@tags", INT2FIX(tags[i]));
+              rb_iv_set(v, "@tags", subextSubtlextTagsToValue(words,
+                subSharedBitsPack(&tags[i], words)));
 
               rb_ary_push(array, v);
             }
         }
     }
 
-  if(names)   XFreeStringList(names);
-  if(visible) free(visible);
-  if(tags)    free(tags);
+  if(names) XFreeStringList(names);
+  if(tags)  free(tags);
 
   return array;
 } /* }}} */
@@ -266,8 +265,8 @@ VALUE
 subextViewSingList(VALUE self)
 {
   int i, nnames = 0;
-  long *tags = NULL;
   char **names = NULL;
+  SubBits *tags = NULL;
   VALUE meth = Qnil, klass = Qnil, array = Qnil, v = Qnil;
 
   subextSubtlextConnect(NULL); ///< Implicit open connection
@@ -277,19 +276,20 @@ subextViewSingList(VALUE self)
   meth  = rb_intern("new");
   array = rb_ary_new();
   names = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-      XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames);
-  tags  = (long *)subSharedPropertyGet(display, ROOT, XA_CARDINAL,
-      XInternAtom(display, "SUBTLE_VIEW_TAGS", False), NULL);
+      subSharedAtomGet(SUB_EWMH_NET_DESKTOP_NAMES), &nnames);
 
   /* Check results */
-  if(names && tags)
+  if(names && (tags = subextSubtlextViewTags(nnames)))
     {
       for(i = 0; i < nnames; i++)
         {
           if(!NIL_P(v = rb_funcall(klass, meth, 1, rb_str_new2(names[i]))))
             {
+              long words[BITSWORDS];
+
               rb_iv_set(v, "@id",   INT2FIX(i));
-              rb_iv_set(v, "@tags", LONG2NUM(tags[i]));
+              rb_iv_set(v, "@tags", subextSubtlextTagsToValue(words,
+                subSharedBitsPack(&tags[i], words)));
 
               rb_ary_push(array, v);
             }
@@ -364,7 +364,9 @@ subextViewInit(VALUE self,
 VALUE
 subextViewUpdate(VALUE self)
 {
-  long *tags = NULL, ntags = 0;
+  int nnames = 0;
+  char **names = NULL;
+  SubBits *tags = NULL;
   VALUE id = Qnil;
 
   /* Check ruby object */
@@ -374,14 +376,23 @@ subextViewUpdate(VALUE self)
   subextSubtlextConnect(NULL); ///< Implicit open connection
 
   /* Fetch tags */
-  if((tags = (long *)subSharedPropertyGet(display, ROOT, XA_CARDINAL,
-      XInternAtom(display, "SUBTLE_VIEW_TAGS", False), (unsigned long *)&ntags)))
+  if((names = subSharedPropertyGetStrings(display, ROOT,
+      subSharedAtomGet(SUB_EWMH_NET_DESKTOP_NAMES), &nnames)))
     {
-      int idx = FIX2INT(id);
+      if((tags = subextSubtlextViewTags(nnames)))
+        {
+          int idx = FIX2INT(id);
+          long words[BITSWORDS] = { 0 }, nwords = 1;
 
-      rb_iv_set(self, "@tags", LONG2NUM(idx < ntags ? tags[idx] : 0));
+          if(0 <= idx && idx < nnames)
+            nwords = subSharedBitsPack(&tags[idx], words);
 
-      free(tags);
+          rb_iv_set(self, "@tags", subextSubtlextTagsToValue(words, nwords));
+
+          free(tags);
+        }
+
+      XFreeStringList(names);
     }
 
   return self;
@@ -431,7 +442,7 @@ subextViewSave(VALUE self)
 
       /* Get names of views */
       if((names = subSharedPropertyGetStrings(display, DefaultRootWindow(display),
-          XInternAtom(display, "_NET_DESKTOP_NAMES", False), &nnames)))
+          subSharedAtomGet(SUB_EWMH_NET_DESKTOP_NAMES), &nnames)))
         {
           id = nnames; ///< New id should be last
 
@@ -461,10 +472,11 @@ subextViewSave(VALUE self)
 VALUE
 subextViewClients(VALUE self)
 {
-  int i, nclients = 0;
+  int i, nclients = 0, nnames = 0;
+  char **names = NULL;
   Window *clients = NULL;
   VALUE id = Qnil, klass = Qnil, meth = Qnil, array = Qnil, client = Qnil;
-  unsigned long *view_tags = NULL;
+  SubBits *view_tags = NULL;
 
   /* Check ruby object */
   rb_check_frozen(self);
@@ -477,27 +489,30 @@ subextViewClients(VALUE self)
   meth      = rb_intern("new");
   array     = rb_ary_new();
   clients   = subextSubtlextWindowList("_NET_CLIENT_LIST", &nclients);
-  view_tags = (unsigned long *)subSharedPropertyGet(display,
-    DefaultRootWindow(display), XA_CARDINAL,
-    XInternAtom(display, "SUBTLE_VIEW_TAGS", False), NULL);
+  names     = subSharedPropertyGetStrings(display,
+    DefaultRootWindow(display),
+    subSharedAtomGet(SUB_EWMH_NET_DESKTOP_NAMES), &nnames);
 
   /* Check results */
-  if(clients && view_tags)
+  if(clients && names && FIX2INT(id) < nnames &&
+      (view_tags = subextSubtlextViewTags(nnames)))
     {
       for(i = 0; i < nclients; i++)
         {
-          unsigned long *client_tags = NULL, *flags = NULL;
+          int has_tags = False;
+          unsigned long *flags = NULL;
+          SubBits client_tags;
 
           /* Fetch window data */
-          client_tags = (unsigned long *)subSharedPropertyGet(display,
-            clients[i], XA_CARDINAL,
-            XInternAtom(display, "SUBTLE_CLIENT_TAGS", False), NULL);
-          flags       = (unsigned long *)subSharedPropertyGet(display,
+          has_tags = subextSubtlextTagsGet(clients[i],
+            SUB_EWMH_SUBTLE_CLIENT_TAGS, &client_tags);
+          flags    = (unsigned long *)subSharedPropertyGet(display,
             clients[i], XA_CARDINAL,
-            XInternAtom(display, "SUBTLE_CLIENT_FLAGS", False), NULL);
+            subSharedAtomGet(SUB_EWMH_SUBTLE_CLIENT_FLAGS), NULL);
 
           /* Check if there are common tags or window is stick */
-          if((client_tags && view_tags[FIX2INT(id)] & *client_tags) ||
+          if((has_tags && subSharedBitsAny(&view_tags[FIX2INT(id)],
+              &client_tags)) ||
               (flags && *flags & SUB_EWMH_STICK))
             {
               if(RTEST(client = rb_funcall(klass, meth,
@@ -509,12 +524,12 @@ subextViewClients(VALUE self)
                 }
             }
 
-          if(client_tags) free(client_tags);
-          if(flags)       free(flags);
+          if(flags) free(flags);
         }
     }
 
   if(clients)   free(clients);
+  if(names)     XFreeStringList(names);
   if(view_tags) free(view_tags);
 
   return array;
@@ -610,7 +625,7 @@ subextViewAskCurrent(VALUE self)
   /* Check results */
   if((cur_view = (unsigned long *)subSharedPropertyGet(display,
       DefaultRootWindow(display), XA_CARDINAL,
-      XInternAtom(display, "_NET_CURRENT_DESKTOP", False), NULL)))
+      subSharedAtomGet(SUB_EWMH_NET_CURRENT_DESKTOP), NULL)))
     {
       if(FIX2INT(id) == *cur_view) ret = Qtrue;
 
@@ -646,7 +661,7 @@ subextViewIcon(VALUE self)
   /* Check results */
   if((icons = (unsigned long *)subSharedPropertyGet(display,
       DefaultRootWindow(display), XA_CARDINAL,
-      XInternAtom(display, "SUBTLE_VIEW_ICONS", False), &nicons)))
+      subSharedAtomGet(SUB_EWMH_SUBTLE_VIEW_ICONS), &nicons)))
     {
       int iid = FIX2INT(id);
 
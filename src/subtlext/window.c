@@ -226,7 +226,7 @@ WindowGrab(SubtlextWindow *w)
   /* Restore logical focus */
   if((focus = (unsigned long *)subSharedPropertyGet(display,
       DefaultRootWindow(display), XA_WINDOW,
-      XInternAtom(display, "_NET_ACTIVE_WINDOW", False), NULL)))
+      subSharedAtomGet(SUB_EWMH_NET_ACTIVE_WINDOW), NULL)))
     {
       XSetInputFocus(display, *focus, RevertToPointerRoot, CurrentTime);
 
@@ -0,0 +1,164 @@
+ /**
+  * @package test
+  *
+  * @file Benchmark array functions
+  * @copyright (c) 2005-2012 Christoph Kappel <unexist@subforge.org>
+  * @version $Id$
+  *
+  * This program can be distributed under the terms of the GNU GPLv2.
+  * See the file COPYING for details.
+  **/
+
+#include <sys/time.h>
+#include "subtle.h"
+
+#define ELEMENTS 5000                                             ///< Elements per run
+#define ROUNDS   20                                               ///< Runs per benchmark
+
+SubSubtle *subtle = NULL;
+
+/* Stubs {{{ */
+void subClientKill(SubClient *c)   { (void)c; }
+void subGrabKill(SubGrab *g)       { (void)g; }
+void subGravityKill(SubGravity *g) { (void)g; }
+void subHookKill(SubHook *h)       { (void)h; }
+void subPanelKill(SubPanel *p)     { (void)p; }
+void subScreenKill(SubScreen *s)   { (void)s; }
+void subStyleKill(SubStyle *s)     { (void)s; }
+void subTagKill(SubTag *t)         { (void)t; }
+void subTrayKill(SubTray *t)       { (void)t; }
+void subViewKill(SubView *v)       { (void)v; }
+/* }}} */
+
+/* BenchTime {{{ */
+static long long
+BenchTime(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, 0);
+
+  return tv.tv_sec * 1000000LL + tv.tv_usec;
+} /* }}} */
+
+/* BenchReport {{{ */
+static void
+BenchReport(const char *name,
+  long long start)
+{
+  long long total = BenchTime() - start;
+
+  printf("%-12s %8lld us total, %6.3f us/op\n", name, total,
+    (double)total / (ROUNDS * ELEMENTS));
+} /* }}} */
+
+/* BenchCheck {{{ */
+static void
+BenchCheck(const char *name,
+  int ok)
+{
+  /* Independent of NDEBUG, a broken array makes the numbers worthless */
+  if(!ok)
+    {
+      fprintf(stderr, "%s: check failed\n", name);
+
+      exit(1);
+    }
+} /* }}} */
+
+/* main {{{ */
+int
+main(void)
+{
+  int i, r, ok = True;
+  long long start = 0;
+  void **elems = NULL, *elem = NULL;
+  SubArray *a = subArrayNew();
+
+  elems = (void **)subSharedMemoryAlloc(ELEMENTS + ELEMENTS / 2,
+    sizeof(void *)); ///< Room for a removal list
+  for(i = 0; i < ELEMENTS; i++)
+    elems[i] = subSharedMemoryAlloc(1, sizeof(int));
+
+  /* Push and remove from the front */
+  start = BenchTime();
+  for(r = 0; r < ROUNDS; r++)
+    {
+      for(i = 0; i < ELEMENTS; i++) subArrayPush(a, elems[i]);
+
+      ok &= (ELEMENTS == a->ndata &&
+        elems[ELEMENTS - 1] == a->data[ELEMENTS - 1]);
+
+      for(i = 0; i < ELEMENTS; i++) subArrayRemove(a, elems[i]);
+
+      ok &= (0 == a->ndata);
+    }
+  BenchReport("push/remove", start);
+  BenchCheck("push/remove", ok);
+
+  /* Insert at front and remove from the back */
+  start = BenchTime();
+  for(r = 0; r < ROUNDS; r++)
+    {
+      for(i = 0; i < ELEMENTS; i++) subArrayInsert(a, 0, elems[i]);
+
+      ok &= (ELEMENTS == a->ndata && elems[0] == a->data[ELEMENTS - 1]);
+
+      for(i = 0; i < ELEMENTS; i++)
+        {
+          elem = subArrayRemoveAt(a, a->ndata - 1);
+          ok  &= (elems[i] == elem);
+        }
+
+      ok &= (0 == a->ndata);
+    }
+  BenchReport("insert/pop", start);
+  BenchCheck("insert/pop", ok);
+
+  /* Unordered removal from the middle */
+  start = BenchTime();
+  for(r = 0; r < ROUNDS; r++)
+    {
+      for(i = 0; i < ELEMENTS; i++) subArrayPush(a, elems[i]);
+
+      for(i = 0; i < ELEMENTS; i++)
+        {
+          elem = subArraySwapRemove(a, a->ndata / 2);
+          ok  &= (NULL != elem);
+        }
+
+      ok &= (0 == a->ndata);
+    }
+  BenchReport("swapremove", start);
+  BenchCheck("swapremove", ok);
+
+  /* Bulk push and ordered bulk removal */
+  start = BenchTime();
+  for(r = 0; r < ROUNDS; r++)
+    {
+      subArrayPushAll(a, elems, ELEMENTS);
+
+      ok &= (ELEMENTS == a->ndata);
+
+      /* Remove every second element and check order of survivors */
+      for(i = 0; i < ELEMENTS / 2; i++) elems[ELEMENTS + i] = elems[i * 2];
+      subArrayRemoveAll(a, elems + ELEMENTS, ELEMENTS / 2);
+
+      for(i = 0; i < a->ndata; i++) ok &= (elems[i * 2 + 1] == a->data[i]);
+
+      subArrayRemoveAll(a, elems, ELEMENTS);
+
+      ok &= (0 == a->ndata);
+    }
+  BenchReport("bulk", start);
+  BenchCheck("bulk", ok);
+
+  subArrayKill(a, False);
+
+  for(i = 0; i < ELEMENTS; i++) free(elems[i]);
+  free(elems);
+
+  return 0;
+} /* }}} */
+
+// vim:ts=2:bs=2:sw=2:et:fdm=marker
@@ -123,6 +123,34 @@ context 'Client' do
       before == after and topic.has_tag?(CLIENT_TAG)
   end # }}}
 
+  asserts 'Add/remove wide tags' do # {{{
+    # Create enough tags to need more than one word
+    names = (Subtlext::Tag.all.size..41).map { |i| "wide#{i}" }
+    names.each { |name| Subtlext::Tag.new(name).save }
+
+    sleep 1
+
+    tag = Subtlext::Tag.first(names.last)
+    topic.tag tag
+
+    sleep 0.5
+
+    added = (40 <= tag.id && topic.has_tag?(tag) &&
+      topic.has_tag?(CLIENT_TAG))
+    topic.untag tag
+
+    sleep 0.5
+
+    removed = (!topic.has_tag?(tag) && topic.has_tag?(CLIENT_TAG))
+
+    # Tidy up
+    names.each { |name| Subtlext::Tag.first(name).kill }
+
+    sleep 1
+
+    added and removed
+  end # }}}
+
   asserts 'Set/get gravity' do # {{{
     topic.gravity = 12
 
@@ -162,6 +190,35 @@ context 'Client' do
     topic.screen.is_a?(Subtlext::Screen)
   end # }}}
 
+  asserts 'Get neighbour' do # {{{
+    # Single client has no neighbours
+    single = [ :up, :right, :down, :left ].all? do |dir|
+      topic.neighbour(dir).nil?
+    end
+
+    # Place second client right of the first one
+    Subtlext::Subtle.spawn("#{find_executable0('xterm')} -display :10")
+
+    sleep 1
+
+    other = Subtlext::Client.all.find { |c| c != topic }
+    other.toggle_stick
+    topic.gravity = :left
+    other.gravity = :right
+
+    sleep 0.5
+
+    right = other == topic.neighbour(:right)
+    left  = topic == other.neighbour(:left)
+    up    = topic.neighbour(:up).nil?
+
+    other.kill
+
+    sleep 1
+
+    single and right and left and up
+  end # }}}
+
   asserts 'Store values' do # {{{
     topic[:test] = 'test'
 
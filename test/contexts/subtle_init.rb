@@ -25,6 +25,27 @@ context 'Subtle - Init' do
     '-*-*-*-*-*-*-14-*-*-*-*-*-*-*' == Subtlext::Subtle.font
   end # }}}
 
+  asserts 'Check stats' do # {{{
+    stats = Subtlext::Subtle.stats(:calls)
+
+    # Sublets are configured on load, so the dummy has been called
+    dummy = stats.find { |s| :sublet == s[:type] and 'dummy' == s[:name] }
+
+    # Event loop counters are always published
+    events = stats.select { |s| :event == s[:type] }.map { |s| s[:name] }
+
+    stats.is_a?(Array) and stats.all? { |s| s.has_key?(:total) } and
+      !dummy.nil? and 0 < dummy[:calls] and
+      %w[watch_add watch_del wakeup ready].all? { |n| events.include?(n) }
+  end # }}}
+
+  asserts 'Check batch' do # {{{
+    Subtlext::Subtle.batch do
+      Subtlext::Subtle.render
+      Subtlext::Subtle.render
+    end.nil?
+  end # }}}
+
   asserts 'Check spawn' do # {{{
     if (xterm = find_executable0('xterm')).nil?
       raise 'xterm not found in path'